@@ -27,6 +27,7 @@ HATN_API_NAMESPACE_BEGIN
 
 constexpr const size_t DefaultSessionCallbacksCapacity=4;
 constexpr const size_t DefaultMaxPoolPriorityConnections=4;
+constexpr const size_t DefaultMaxMultiplexedRequests=64;
 
 HATN_API_NAMESPACE_END
 
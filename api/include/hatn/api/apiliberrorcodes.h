@@ -48,6 +48,7 @@
     Do(ApiLibError,TCP_SERVER_CONFIG_FAILED,_TR("failed to load configuration of TCP server","api")) \
     Do(ApiLibError,TCP_SERVER_INVALID_IP_ADDRESS,_TR("invalid IP address of TCP server","api")) \
     Do(ApiLibError,TCP_SERVER_INVALID_IP_PORT,_TR("invalid port of TCP server","api")) \
+    Do(ApiLibError,TCP_SERVER_INVALID_THREAD,_TR("invalid threads of TCP server","api")) \
     Do(ApiLibError,PROTOCOL_CONFIGURATION_FAILED,_TR("failed to load configuration of server protocol","api")) \
     Do(ApiLibError,UNKNOWN_SERVICE_DISPATCHER,_TR("unknown service dispatcher","api")) \
     Do(ApiLibError,UNKNOWN_AUTH_DISPATCHER,_TR("unknown authentification dispatcher","api")) \
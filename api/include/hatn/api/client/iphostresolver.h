@@ -71,6 +71,16 @@ class IpHostResolverTraits
             }
         }
 
+        void setCache(std::shared_ptr<HATN_NETWORK_NAMESPACE::ResolverCache> cache) noexcept
+        {
+            m_resolver.setCache(std::move(cache));
+        }
+
+        std::shared_ptr<HATN_NETWORK_NAMESPACE::ResolverCache> cache() const noexcept
+        {
+            return m_resolver.cache();
+        }
+
     private:
 
         HATN_NETWORK_NAMESPACE::asio::CaResolver m_resolver;
@@ -41,6 +41,8 @@ namespace client {
 
 HDU_UNIT(raw_transport_config,
     HDU_FIELD(max_pool_priority_connections,TYPE_UINT32,2,false,DefaultMaxPoolPriorityConnections)
+    HDU_FIELD(multiplexing,TYPE_BOOL,3,false,false)
+    HDU_FIELD(max_multiplexed_requests,TYPE_UINT32,4,false,DefaultMaxMultiplexedRequests)
 )
 
 template <typename RouterT, typename Traits>
@@ -21,6 +21,8 @@
 
 #include <hatn/common/locker.h>
 
+#include <hatn/crypt/tlssessioncache.h>
+
 #include <hatn/api/api.h>
 #include <hatn/api/client/tcpclientconfig.h>
 
@@ -134,6 +136,24 @@ class TlsClientConfig : public TcpClientConfig
             return m_serverName;
         }
 
+        /**
+         * @brief Set cache of TLS sessions to resume when reconnecting.
+         * @param cache Session cache, can be shared by configs of a few clients.
+         *
+         * Cache must be set to TLS context of client, server name is used as the key of endpoint in the cache.
+         */
+        void setSessionCache(std::shared_ptr<crypt::TlsSessionCache> cache)
+        {
+            common::MutexScopedLock l(m_mutex);
+            m_sessionCache=std::move(cache);
+        }
+
+        std::shared_ptr<crypt::TlsSessionCache> sessionCache() const
+        {
+            common::MutexScopedLock l(m_mutex);
+            return m_sessionCache;
+        }
+
     private:
 
         static void concat(std::string& bundle, const std::string& cert)
@@ -158,6 +178,8 @@ class TlsClientConfig : public TcpClientConfig
         std::string m_serverName;
 
         bool m_insecure=false;
+
+        std::shared_ptr<crypt::TlsSessionCache> m_sessionCache;
 };
 
 } // namespace client
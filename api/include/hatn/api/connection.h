@@ -22,9 +22,11 @@
 #include <hatn/common/sharedptr.h>
 #include <hatn/common/spanbuffer.h>
 #include <hatn/common/taskcontext.h>
+#include <hatn/common/threadwithqueue.h>
 #include <hatn/common/streamchaingather.h>
 
 #include <hatn/api/api.h>
+#include <hatn/api/framedreader.h>
 
 HATN_API_NAMESPACE_BEGIN
 
@@ -103,6 +105,27 @@ class Connection : public common::TaskSubcontext
             m_stream.readAll(data,size,std::move(cb));
         }
 
+        /**
+         * @brief Receive next message frame using read-ahead buffer of the connection.
+         * @param ctx Task context.
+         * @param maxFrameSize Max size of frame message.
+         * @param callback Callback with signature void (common::SharedPtr<ContextT> ctx, const Error& ec, common::ByteArrayShared frame, uint32_t frameSize).
+         *
+         * If frame size exceeds maxFrameSize then only frame header is consumed and callback is invoked with null frame.
+         * Callback is never invoked synchronously, if the frame is already in the buffer then the callback is posted
+         * to the current thread, so buffered frames do not nest handlers of the caller.
+         * Must not be mixed with recv() on the same connection.
+         */
+        template <typename ContextT, typename CallbackT>
+        void recvFrame(
+            common::SharedPtr<ContextT> ctx,
+            uint32_t maxFrameSize,
+            CallbackT callback
+        )
+        {
+            doRecvFrame(std::move(ctx),maxFrameSize,std::move(callback),false);
+        }
+
         template <typename ContextT, typename CallbackT>
         void read(
             common::SharedPtr<ContextT> ctx,
@@ -143,7 +166,103 @@ class Connection : public common::TaskSubcontext
 
     private:
 
+        template <typename ContextT, typename CallbackT>
+        void doRecvFrame(
+            common::SharedPtr<ContextT> ctx,
+            uint32_t maxFrameSize,
+            CallbackT callback,
+            bool inReadCallback
+        )
+        {
+            auto frameReady=[inReadCallback](common::SharedPtr<ContextT> ctx, CallbackT callback, common::ByteArrayShared frame, uint32_t frameSize)
+            {
+                if (inReadCallback)
+                {
+                    callback(std::move(ctx),Error{},std::move(frame),frameSize);
+                    return;
+                }
+                postFrame(std::move(ctx),std::move(callback),std::move(frame),frameSize);
+            };
+
+            uint32_t frameSize=0;
+            if (m_reader.frameSize(frameSize))
+            {
+                if (frameSize>maxFrameSize)
+                {
+                    m_reader.skipHeader();
+                    frameReady(std::move(ctx),std::move(callback),common::ByteArrayShared{},frameSize);
+                    return;
+                }
+
+                if (m_reader.hasFrame(frameSize))
+                {
+                    auto frame=m_reader.takeFrame(frameSize);
+                    frameReady(std::move(ctx),std::move(callback),std::move(frame),frameSize);
+                    return;
+                }
+
+                if (!m_reader.fitsBuffer(frameSize))
+                {
+                    // receive the rest of big frame directly to the frame buffer
+                    auto frame=m_reader.takeOversizedFrame(frameSize);
+                    auto* data=frame.first->data()+frame.second;
+                    auto size=frameSize-frame.second;
+                    auto cb=[ctx{std::move(ctx)},callback{std::move(callback)},frame{std::move(frame.first)},frameSize](const Error& ec, size_t)
+                    {
+                        callback(ctx,ec,frame,frameSize);
+                    };
+                    m_stream.readAll(data,size,std::move(cb));
+                    return;
+                }
+            }
+
+            // read next chunk of data
+            auto buf=m_reader.prepareRead();
+            auto cb=[this,ctx{std::move(ctx)},maxFrameSize,callback{std::move(callback)}](const Error& ec, size_t readBytes)
+            {
+                if (ec)
+                {
+                    callback(ctx,ec,common::ByteArrayShared{},0);
+                    return;
+                }
+                m_reader.commitRead(readBytes);
+                doRecvFrame(ctx,maxFrameSize,callback,true);
+            };
+            m_stream.read(buf.first,buf.second,std::move(cb));
+        }
+
+        template <typename ContextT, typename CallbackT>
+        static void postFrame(
+            common::SharedPtr<ContextT> ctx,
+            CallbackT callback,
+            common::ByteArrayShared frame,
+            uint32_t frameSize
+        )
+        {
+            auto handler=[callback{std::move(callback)},frame{std::move(frame)},frameSize](common::SharedPtr<ContextT> ctx) mutable
+            {
+                callback(std::move(ctx),Error{},std::move(frame),frameSize);
+            };
+
+            auto thread=common::TaskWithContextThread::current();
+            if (thread!=nullptr)
+            {
+                common::postAsyncTask(thread,std::move(ctx),std::move(handler));
+                return;
+            }
+
+            auto plainThread=common::Thread::currentThreadOrMain();
+            Assert(plainThread!=nullptr,"Current thread or main must be initialized");
+            plainThread->execAsync(
+                [ctx{std::move(ctx)},handler{std::move(handler)}]() mutable
+                {
+                    handler(std::move(ctx));
+                }
+            );
+        }
+
         common::StreamChainGather<Streams...> m_stream;
+        FramedReader m_reader;
 };
 
 HATN_API_NAMESPACE_END
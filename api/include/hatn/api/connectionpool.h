@@ -20,6 +20,8 @@
 #define HATNAPISCONNECTIONPOOL_H
 
 #include <functional>
+#include <map>
+#include <deque>
 
 #include <hatn/common/sharedptr.h>
 #include <hatn/common/pmr/allocatorfactory.h>
@@ -36,6 +38,7 @@
 #include <hatn/api/priority.h>
 #include <hatn/api/apiconstants.h>
 #include <hatn/api/protocol.h>
+#include <hatn/api/responseunit.h>
 
 HATN_API_NAMESPACE_BEGIN
 
@@ -47,6 +50,12 @@ class ConnectionPool
     using RouterConnectionCtx=typename RouterT::ConnectionContext;
     using Connection=typename RouterT::Connection;
 
+    struct MultiplexedRequest
+    {
+        du::WireBufSolidShared* responseBuf=nullptr;
+        std::function<void (const Error& ec)> callback;
+    };
+
     struct ConnectionContext
     {
         enum class State : uint8_t
@@ -70,6 +79,13 @@ class ConnectionPool
         Priority priority=Priority::Normal;
 
         size_t sendTriesCount=0;
+
+        // state of multiplexing mode
+        protocol::Header rxHeader;
+        du::WireBufSolidShared rxData;
+        bool writing=false;
+        std::deque<std::function<void ()>> txQueue;
+        std::map<std::string,MultiplexedRequest> pending;
     };
 
     using Connections=common::pmr::map<common::TaskContextId,common::SharedPtr<ConnectionContext>,std::less<>>;
@@ -90,7 +106,9 @@ class ConnectionPool
                 m_defaultConnection(common::allocateShared(factory->objectAllocator<ConnectionContext>())),
                 m_thread(thread),
                 m_autoReconnect(true),
-                m_totalConnectionCount(0)
+                m_totalConnectionCount(0),
+                m_multiplexing(false),
+                m_maxMultiplexedRequests(DefaultMaxMultiplexedRequests)
         {
             handlePriorities(
                 [this](Priority priority)
@@ -156,8 +174,48 @@ class ConnectionPool
             return m_autoReconnect;
         }
 
+        /**
+         * @brief Enable multiplexing mode of default connection.
+         * @param enable Enable/disable flag.
+         *
+         * In multiplexing mode requests are written to the connection back to back without waiting for responses
+         * to previous requests. Responses are read by a single reading loop and matched to requests by request ID,
+         * so the server must support requests pipelining.
+         */
+        void setMultiplexingMode(bool enable) noexcept
+        {
+            m_multiplexing=enable;
+        }
+
+        bool isMultiplexingMode() const noexcept
+        {
+            return m_multiplexing;
+        }
+
+        /**
+         * @brief Set max number of requests waiting for responses on connection in multiplexing mode.
+         * @param count Max number of requests.
+         *
+         * Requests above the limit are kept in the queues of the client.
+         */
+        void setMaxMultiplexedRequests(size_t count) noexcept
+        {
+            m_maxMultiplexedRequests=count;
+        }
+
+        size_t maxMultiplexedRequests() const noexcept
+        {
+            return m_maxMultiplexedRequests;
+        }
+
         bool canSend(Priority priority) const
         {
+            // multiplexed requests are always sent via default connection
+            if (m_multiplexing)
+            {
+                return m_defaultConnection->pending.size()<m_maxMultiplexedRequests;
+            }
+
             if (m_singleConnection)
             {
                 return m_defaultConnection->state!=ConnectionContext::State::Busy;
@@ -242,6 +300,68 @@ class ConnectionPool
             //! try to send via default connection if new connection can not be established
         }
 
+        /**
+         * @brief Send request in multiplexing mode.
+         * @param ctx Task context of request.
+         * @param requestId ID of request used to match the response.
+         * @param buffers Serialized request.
+         * @param responseBuf Buffer to put response to, must be valid until callback is invoked.
+         * @param cb Callback invoked when response is received or request failed.
+         */
+        template <typename ContextT>
+        void sendMultiplexed(
+                common::SharedPtr<ContextT> ctx,
+                lib::string_view requestId,
+                common::SpanBuffers buffers,
+                du::WireBufSolidShared& responseBuf,
+                std::function<void (const Error& ec)> cb
+            )
+        {
+            // check if pool is closed
+            if (m_closed)
+            {
+                cb(commonError(CommonError::ABORTED));
+                return;
+            }
+
+            auto messageSize=common::SpanBufferTraits::size(buffers);
+            if (messageSize>m_maxMessageSize)
+            {
+                cb(apiLibError(ApiLibError::TOO_BIG_TX_MESSAGE));
+                return;
+            }
+
+            // register request waiting for response
+            auto connectionCtx=m_defaultConnection;
+            connectionCtx->pending[std::string{requestId}]=MultiplexedRequest{&responseBuf,std::move(cb)};
+
+            // enqueue request for writing
+            connectionCtx->txQueue.push_back(
+                [this,ctx,connectionCtx,buffers{std::move(buffers)},messageSize]()
+                {
+                    writeMultiplexed(ctx,connectionCtx,buffers,messageSize);
+                }
+            );
+
+            // connect if needed or write next request
+            if (connectionCtx->state==ConnectionContext::State::Disconnected)
+            {
+                connectMultiplexed(std::move(ctx));
+            }
+            else if (connectionCtx->state==ConnectionContext::State::Error)
+            {
+                auto closeCb=[ctx,this](const Error&)
+                {
+                    connectMultiplexed(std::move(ctx));
+                };
+                closeDefaultConnection(ctx,closeCb);
+            }
+            else
+            {
+                writeNextMultiplexed(connectionCtx);
+            }
+        }
+
         template <typename ContextT>
         void recv(
                 common::SharedPtr<ContextT> ctx,
@@ -365,6 +485,8 @@ class ConnectionPool
 
             if (m_defaultConnection)
             {
+                failMultiplexed(m_defaultConnection,commonError(CommonError::ABORTED));
+
                 auto cb=[ctx,callback{std::move(callback)},this](const Error&)
                 {
                     closeNextPriority(std::move(ctx),std::move(callback));
@@ -635,6 +757,210 @@ class ConnectionPool
             connectionCtx->connection().send(std::move(ctx),connectionCtx->header.data(),connectionCtx->header.size(),std::move(sendHeaderCb));
         }
 
+        template <typename ContextT>
+        void connectMultiplexed(common::SharedPtr<ContextT> ctx)
+        {
+            connect(std::move(ctx),
+                [this](const Error& ec)
+                {
+                    auto connectionCtx=m_defaultConnection;
+                    if (ec)
+                    {
+                        failMultiplexed(connectionCtx,ec);
+                        return;
+                    }
+
+                    readMultiplexed(connectionCtx);
+                    writeNextMultiplexed(connectionCtx);
+                }
+            );
+        }
+
+        void writeNextMultiplexed(const ConnectionCtxShared& connectionCtx)
+        {
+            if (connectionCtx->writing
+                || connectionCtx->txQueue.empty()
+                || connectionCtx->state!=ConnectionContext::State::Ready
+                )
+            {
+                return;
+            }
+
+            connectionCtx->writing=true;
+            auto write=std::move(connectionCtx->txQueue.front());
+            connectionCtx->txQueue.pop_front();
+            write();
+        }
+
+        template <typename ContextT>
+        void writeMultiplexed(
+                common::SharedPtr<ContextT> ctx,
+                ConnectionCtxShared connectionCtx,
+                common::SpanBuffers buffers,
+                size_t messageSize
+            )
+        {
+            // callbacks of replaced connection are ignored
+            auto* routerCtx=connectionCtx->ctx.get();
+
+            connectionCtx->header.setMessageSize(static_cast<uint32_t>(messageSize));
+
+            auto sendMessageCb=[this,connectionCtx,routerCtx](auto, const Error& ec, size_t, common::SpanBuffers)
+            {
+                if (connectionCtx->ctx.get()!=routerCtx)
+                {
+                    return;
+                }
+                connectionCtx->ctx->resetParentCtx();
+                connectionCtx->writing=false;
+
+                if (ec)
+                {
+                    multiplexedConnectionFailed(connectionCtx,ec);
+                    return;
+                }
+                writeNextMultiplexed(connectionCtx);
+            };
+            auto sendHeaderCb=[this,connectionCtx,routerCtx,buffers{std::move(buffers)},sendMessageCb{std::move(sendMessageCb)}](
+                                        auto ctx, const Error& ec, size_t
+                                    )
+            {
+                if (connectionCtx->ctx.get()!=routerCtx)
+                {
+                    return;
+                }
+                connectionCtx->ctx->resetParentCtx();
+
+                if (ec)
+                {
+                    connectionCtx->writing=false;
+                    multiplexedConnectionFailed(connectionCtx,ec);
+                    return;
+                }
+
+                // send message
+                connectionCtx->ctx->resetParentCtx(ctx);
+                connectionCtx->connection().send(std::move(ctx),buffers,sendMessageCb);
+            };
+
+            // send header
+            connectionCtx->ctx->resetParentCtx(ctx);
+            connectionCtx->connection().send(std::move(ctx),connectionCtx->header.data(),connectionCtx->header.size(),std::move(sendHeaderCb));
+        }
+
+        void readMultiplexed(ConnectionCtxShared connectionCtx)
+        {
+            // callbacks of replaced connection are ignored
+            auto* routerCtx=connectionCtx->ctx.get();
+
+            auto recvMessageCb=[this,connectionCtx,routerCtx](auto, const Error& ec)
+            {
+                if (connectionCtx->ctx.get()!=routerCtx)
+                {
+                    return;
+                }
+
+                if (ec)
+                {
+                    multiplexedConnectionFailed(connectionCtx,ec);
+                    return;
+                }
+
+                dispatchMultiplexed(connectionCtx);
+                readMultiplexed(connectionCtx);
+            };
+            auto recvHeaderCb=[this,connectionCtx,routerCtx,recvMessageCb{std::move(recvMessageCb)}](auto ctx, const Error& ec)
+            {
+                if (connectionCtx->ctx.get()!=routerCtx)
+                {
+                    return;
+                }
+
+                if (ec)
+                {
+                    multiplexedConnectionFailed(connectionCtx,ec);
+                    return;
+                }
+
+                auto messageSize=connectionCtx->rxHeader.messageSize();
+                if (messageSize==0)
+                {
+                    readMultiplexed(connectionCtx);
+                    return;
+                }
+
+                if (messageSize>m_maxMessageSize)
+                {
+                    multiplexedConnectionFailed(connectionCtx,apiLibError(ApiLibError::TOO_BIG_RX_MESSAGE));
+                    return;
+                }
+
+                auto& buf=connectionCtx->rxData;
+                buf.mainContainer()->resize(messageSize);
+                buf.setSize(messageSize);
+                connectionCtx->connection().recv(
+                    std::move(ctx),
+                    buf.mainContainer()->data(),
+                    buf.mainContainer()->size(),
+                    recvMessageCb
+                );
+            };
+
+            // connection's own context is the task context of reading loop
+            auto ctx=connectionCtx->ctx;
+            connectionCtx->connection().recv(
+                std::move(ctx),
+                connectionCtx->rxHeader.data(),
+                connectionCtx->rxHeader.size(),
+                std::move(recvHeaderCb)
+            );
+        }
+
+        void dispatchMultiplexed(const ConnectionCtxShared& connectionCtx)
+        {
+            // parse only ID of response, the rest of response is parsed by transport
+            protocol::response_id::type respId;
+            Error ec;
+            if (!du::io::deserialize(respId,connectionCtx->rxData,ec))
+            {
+                // drop response that can not be matched
+                return;
+            }
+
+            auto it=connectionCtx->pending.find(std::string{respId.fieldValue(protocol::response_id::id)});
+            if (it==connectionCtx->pending.end())
+            {
+                // request was already failed
+                return;
+            }
+            auto req=std::move(it->second);
+            connectionCtx->pending.erase(it);
+
+            std::swap(*req.responseBuf,connectionCtx->rxData);
+            req.callback(Error{});
+        }
+
+        void multiplexedConnectionFailed(const ConnectionCtxShared& connectionCtx, const Error& ec)
+        {
+            if (connectionCtx->state==ConnectionContext::State::Ready)
+            {
+                connectionCtx->state=ConnectionContext::State::Error;
+            }
+            failMultiplexed(connectionCtx,ec);
+        }
+
+        void failMultiplexed(const ConnectionCtxShared& connectionCtx, const Error& ec)
+        {
+            connectionCtx->writing=false;
+            connectionCtx->txQueue.clear();
+            auto pending=std::move(connectionCtx->pending);
+            connectionCtx->pending.clear();
+            for (auto&& it: pending)
+            {
+                it.second.callback(ec);
+            }
+        }
+
         template <typename ContextT>
         void newPoolConnection(common::SharedPtr<ContextT> ctx, Priority priority, std::function<void (const Error& ec, ConnectionCtxShared)> cb)
         {
@@ -661,6 +987,9 @@ class ConnectionPool
 
         std::string m_name;
         size_t m_totalConnectionCount;
+
+        bool m_multiplexing;
+        size_t m_maxMultiplexedRequests;
 };
 
 HATN_API_NAMESPACE_END
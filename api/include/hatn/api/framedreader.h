@@ -0,0 +1,222 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/*
+
+*/
+/** @file api/framedreader.h
+  *
+  * Contains read-ahead buffer for parsing message frames received from connection.
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNAPIFRAMEDREADER_H
+#define HATNAPIFRAMEDREADER_H
+
+#include <algorithm>
+#include <cstring>
+
+#include <hatn/common/bytearray.h>
+#include <hatn/common/sharedptr.h>
+#include <hatn/common/pmr/allocatorfactory.h>
+
+#include <hatn/api/api.h>
+#include <hatn/api/protocol.h>
+
+HATN_API_NAMESPACE_BEGIN
+
+/**
+ * @brief View of message frame in chunk of read-ahead buffer.
+ *
+ * The view keeps the chunk alive so that the chunk is not overwritten while the frame is in use.
+ */
+class FrameView : public common::ByteArrayManaged
+{
+    public:
+
+        FrameView(
+                common::ByteArrayShared chunk,
+                const char* data,
+                size_t size
+            ) : common::ByteArrayManaged(data,size,true),
+                m_chunk(std::move(chunk))
+        {}
+
+    private:
+
+        common::ByteArrayShared m_chunk;
+};
+
+/**
+ * @brief Read-ahead buffer of connection that splits received data to message frames.
+ *
+ * Each frame consists of protocol::Header followed by message of the size set in the header.
+ * Data is read from connection by chunks, all complete frames in a chunk are handed out as zero-copy views.
+ * When the chunk is full the remaining data is moved to the beginning of the chunk if there are no frames in use,
+ * otherwise a new chunk is allocated. Frames that do not fit into a chunk are allocated separately.
+ */
+class FramedReader
+{
+    public:
+
+        constexpr static const size_t DefaultBufferSize=16384;
+        constexpr static const size_t MinReadSize=1024;
+
+        explicit FramedReader(
+                size_t bufferSize=DefaultBufferSize,
+                const common::pmr::AllocatorFactory* factory=common::pmr::AllocatorFactory::getDefault()
+            ) : m_bufferSize((std::max)(bufferSize,MinReadSize*2)),
+                m_factory(factory),
+                m_begin(0),
+                m_end(0)
+        {}
+
+        size_t bufferSize() const noexcept
+        {
+            return m_bufferSize;
+        }
+
+        size_t bufferedSize() const noexcept
+        {
+            return m_end-m_begin;
+        }
+
+        /**
+         * @brief Get size of the next frame.
+         * @param size Size of frame message.
+         * @return False if header of the next frame is not received yet.
+         */
+        bool frameSize(uint32_t& size) const noexcept
+        {
+            if (bufferedSize()<protocol::HEADER_LENGTH)
+            {
+                return false;
+            }
+            size=protocol::bufToSize(m_chunk->data()+m_begin);
+            return true;
+        }
+
+        bool hasFrame(uint32_t size) const noexcept
+        {
+            return bufferedSize()>=protocol::HEADER_LENGTH+size;
+        }
+
+        bool fitsBuffer(uint32_t size) const noexcept
+        {
+            return protocol::HEADER_LENGTH+size<=m_bufferSize;
+        }
+
+        void skipHeader() noexcept
+        {
+            m_begin+=protocol::HEADER_LENGTH;
+        }
+
+        /**
+         * @brief Take complete frame from buffer.
+         * @param size Size of frame message.
+         * @return View of frame message.
+         */
+        common::ByteArrayShared takeFrame(uint32_t size)
+        {
+            const char* data=m_chunk->data()+m_begin+protocol::HEADER_LENGTH;
+            m_begin+=protocol::HEADER_LENGTH+size;
+            return m_factory->createObject<FrameView>(m_chunk,data,size);
+        }
+
+        /**
+         * @brief Take frame that does not fit into buffer.
+         * @param size Size of frame message.
+         * @return Allocated frame message and size of message part already copied from buffer.
+         */
+        std::pair<common::ByteArrayShared,size_t> takeOversizedFrame(uint32_t size)
+        {
+            auto frame=m_factory->createObject<common::ByteArrayManaged>(m_factory->dataMemoryResource());
+            frame->resize(size);
+            size_t copied=(std::min)(bufferedSize()-protocol::HEADER_LENGTH,static_cast<size_t>(size));
+            if (copied!=0)
+            {
+                memcpy(frame->data(),m_chunk->data()+m_begin+protocol::HEADER_LENGTH,copied);
+            }
+            m_begin+=protocol::HEADER_LENGTH+copied;
+            return std::make_pair(std::move(frame),copied);
+        }
+
+        /**
+         * @brief Prepare buffer for reading from connection.
+         * @return Pointer to free space in buffer and size of that space.
+         */
+        std::pair<char*,size_t> prepareRead()
+        {
+            if (!m_chunk)
+            {
+                m_chunk=makeChunk();
+            }
+
+            auto buffered=bufferedSize();
+            size_t frameLength=protocol::HEADER_LENGTH;
+            uint32_t size=0;
+            if (frameSize(size))
+            {
+                frameLength+=size;
+            }
+
+            // frames of the chunk are not in use
+            bool unique=m_chunk.refCount()==1;
+
+            if (buffered==0 && unique)
+            {
+                m_begin=0;
+                m_end=0;
+            }
+            else if (m_begin+frameLength>m_bufferSize || m_bufferSize-m_end<MinReadSize)
+            {
+                if (unique)
+                {
+                    memmove(m_chunk->data(),m_chunk->data()+m_begin,buffered);
+                }
+                else
+                {
+                    auto chunk=makeChunk();
+                    memcpy(chunk->data(),m_chunk->data()+m_begin,buffered);
+                    m_chunk=std::move(chunk);
+                }
+                m_begin=0;
+                m_end=buffered;
+            }
+
+            return std::make_pair(m_chunk->data()+m_end,m_bufferSize-m_end);
+        }
+
+        void commitRead(size_t size) noexcept
+        {
+            m_end+=size;
+        }
+
+    private:
+
+        common::ByteArrayShared makeChunk() const
+        {
+            auto chunk=m_factory->createObject<common::ByteArrayManaged>(m_factory->dataMemoryResource());
+            chunk->resize(m_bufferSize);
+            return chunk;
+        }
+
+        size_t m_bufferSize;
+        const common::pmr::AllocatorFactory* m_factory;
+
+        common::ByteArrayShared m_chunk;
+        size_t m_begin;
+        size_t m_end;
+};
+
+HATN_API_NAMESPACE_END
+
+#endif // HATNAPIFRAMEDREADER_H
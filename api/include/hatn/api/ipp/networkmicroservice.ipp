@@ -44,18 +44,16 @@ Error NetworkMicroServiceTraits<MicroServiceT,EnvT,DispatcherT,AuthDispatcherT,N
     auto connectionsStore=std::make_shared<ConnectionsStore>();
     m_server=std::make_shared<Server>(std::move(connectionsStore),m_microservice->dispatcher(),m_microservice->authDispatcher());
 
-    // make and init network server
-    auto networkServerCtx=NetworkMicroServiceConfigT::makeAndInitNetworkServer(name,env,app,configTree,configTreePath);
-    if (networkServerCtx)
+    // make and init network servers
+    auto networkServerCtxs=NetworkMicroServiceConfigT::makeAndInitNetworkServer(name,env,app,configTree,configTreePath);
+    if (networkServerCtxs)
     {
         //! @todo Log error
-        return networkServerCtx.takeError();
+        return networkServerCtxs.takeError();
     }
-    m_networkServerCtx=networkServerCtx.takeValue();
-    auto& networkServer=m_networkServerCtx->template get<NetworkServer>();
-    networkServer.setEnv(env);
+    m_networkServerCtxs=networkServerCtxs.takeValue();
 
-    // set handler of new network connection
+    // set handler of new network connection, connections of all servers are kept in the same connections store
     auto onNewNetworkConnection=[server{std::weak_ptr{m_server}}](common::SharedPtr<ConnectionCtx> connectionCtx, const Error& ec, auto cb)
     {
         auto serv=server.lock();
@@ -73,14 +71,21 @@ Error NetworkMicroServiceTraits<MicroServiceT,EnvT,DispatcherT,AuthDispatcherT,N
         auto& connection=connectionCtx->template get<Connection>();
         serv->handleNewConnection(connectionCtx,connection,cb);
     };
-    networkServer.setConnectionHandler(onNewNetworkConnection);
 
-    // run network server
-    auto ec=networkServer.run(m_networkServerCtx);
-    if (ec)
+    // run network servers
+    for (auto&& networkServerCtx: m_networkServerCtxs)
     {
-        //! @todo Log error
-        return ec;
+        auto& networkServer=networkServerCtx->template get<NetworkServer>();
+        networkServer.setEnv(env);
+        m_server->setMaxPipelinedRequests(networkServer.maxPipelinedRequests());
+        networkServer.setConnectionHandler(onNewNetworkConnection);
+
+        auto ec=networkServer.run(networkServerCtx);
+        if (ec)
+        {
+            //! @todo Log error
+            return ec;
+        }
     }
 
     // done
@@ -101,9 +106,9 @@ void NetworkMicroServiceTraits<MicroServiceT,EnvT,DispatcherT,AuthDispatcherT,Ne
         m_server->close();
     }
 
-    if (m_networkServerCtx)
+    for (auto&& networkServerCtx: m_networkServerCtxs)
     {
-        auto& networkServer=m_networkServerCtx->template get<NetworkServer>();
+        auto& networkServer=networkServerCtx->template get<NetworkServer>();
         auto ec=networkServer.close();
         //! @todo Log error?
         std::ignore=ec;
@@ -39,6 +39,8 @@ HDU_UNIT(tcp_server_config,
     HDU_FIELD(port,TYPE_UINT16,2,true)
     HDU_FIELD(max_pending_connections,TYPE_UINT32,3,false,boost::asio::ip::tcp::socket::max_listen_connections)
     HDU_FIELD(server_thread,TYPE_UINT32,4)
+    HDU_FIELD(max_pipelined_requests,TYPE_UINT32,5,false,1)
+    HDU_FIELD(acceptor_shards,TYPE_UINT32,6,false,1)
 )
 
 using TcpServerConfig=HATN_BASE_NAMESPACE::ConfigObject<tcp_server_config::type>;
@@ -46,7 +48,7 @@ using TcpServerConfig=HATN_BASE_NAMESPACE::ConfigObject<tcp_server_config::type>
 //---------------------------------------------------------------
 
 template <typename EnvT>
-Result<common::SharedPtr<typename PlainTcpMicroServiceConfig<EnvT>::NetworkServerCtx>>
+Result<std::vector<common::SharedPtr<typename PlainTcpMicroServiceConfig<EnvT>::NetworkServerCtx>>>
     PlainTcpMicroServiceConfig<EnvT>::makeAndInitNetworkServer(
         lib::string_view name,
         common::SharedPtr<Env> env,
@@ -78,40 +80,66 @@ Result<common::SharedPtr<typename PlainTcpMicroServiceConfig<EnvT>::NetworkServe
 
     // select server thread
     auto thread=app.appThread();
+    size_t firstThreadIdx=0;
     if (config.config().isSet(tcp_server_config::server_thread))
     {
-        thread=app.thread(config.config().fieldValue(tcp_server_config::server_thread));
+        firstThreadIdx=config.config().fieldValue(tcp_server_config::server_thread);
+        thread=app.thread(firstThreadIdx);
     }
 
-    // create server context
-    auto tcpServerCtx=HATN_COMMON_NAMESPACE::allocateTaskContextType<NetworkServerCtx>(
-        allocator,
-        HATN_COMMON_NAMESPACE::subcontexts(
-            HATN_COMMON_NAMESPACE::subcontext(thread),
-            HATN_COMMON_NAMESPACE::subcontext(),
-            HATN_COMMON_NAMESPACE::subcontext(config.config().fieldValue(tcp_server_config::max_pending_connections))
-            ),
-        name
-    );
-
-    // set asio server configuration
-    const auto& asioServerConfig=tcpServerCtx->template get<HATN_NETWORK_NAMESPACE::asio::TcpServerConfig>();
-    auto& tcpServer=tcpServerCtx->template get<NetworkServer>();
-    tcpServer.setConfig(&asioServerConfig);
-
-    try
+    // with sharded acceptors each server listens on own thread and keeps accepted connections on that thread
+    size_t shards=(std::max)(config.config().fieldValue(tcp_server_config::acceptor_shards),uint32_t(1));
+    bool sharded=shards>1;
+    if (sharded && firstThreadIdx+shards>app.threadCount())
     {
-        HATN_NETWORK_NAMESPACE::asio::TcpEndpoint ep{config.config().fieldValue(tcp_server_config::ip_address),port};
-        tcpServer.setServerEndpoint(std::move(ep));
+        ec=apiLibError(ApiLibError::TCP_SERVER_INVALID_THREAD);
+        return ec;
     }
-    catch (...)
+
+    std::vector<common::SharedPtr<NetworkServerCtx>> tcpServerCtxs;
+    tcpServerCtxs.reserve(shards);
+    for (size_t i=0;i<shards;i++)
     {
-        ec=apiLibError(ApiLibError::TCP_SERVER_INVALID_IP_ADDRESS);
-        return ec;
+        if (sharded)
+        {
+            thread=app.thread(firstThreadIdx+i,false);
+        }
+
+        // create server context
+        auto tcpServerCtx=HATN_COMMON_NAMESPACE::allocateTaskContextType<NetworkServerCtx>(
+            allocator,
+            HATN_COMMON_NAMESPACE::subcontexts(
+                HATN_COMMON_NAMESPACE::subcontext(thread),
+                HATN_COMMON_NAMESPACE::subcontext(),
+                HATN_COMMON_NAMESPACE::subcontext(config.config().fieldValue(tcp_server_config::max_pending_connections))
+                ),
+            name
+        );
+
+        // set asio server configuration
+        auto& asioServerConfig=tcpServerCtx->template get<HATN_NETWORK_NAMESPACE::asio::TcpServerConfig>();
+        asioServerConfig.setReusePort(sharded);
+        auto& tcpServer=tcpServerCtx->template get<NetworkServer>();
+        tcpServer.setConfig(&asioServerConfig);
+        tcpServer.setMaxPipelinedRequests(config.config().fieldValue(tcp_server_config::max_pipelined_requests));
+        tcpServer.setConnectionsOnServerThread(sharded);
+
+        try
+        {
+            HATN_NETWORK_NAMESPACE::asio::TcpEndpoint ep{config.config().fieldValue(tcp_server_config::ip_address),port};
+            tcpServer.setServerEndpoint(std::move(ep));
+        }
+        catch (...)
+        {
+            ec=apiLibError(ApiLibError::TCP_SERVER_INVALID_IP_ADDRESS);
+            return ec;
+        }
+
+        tcpServerCtxs.push_back(std::move(tcpServerCtx));
     }
 
     // done
-    return tcpServerCtx;
+    return tcpServerCtxs;
 }
 
 //---------------------------------------------------------------
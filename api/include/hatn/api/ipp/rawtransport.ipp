@@ -42,6 +42,23 @@ void RawTransport<RouterT,Traits>::sendRequest(
         CallbackT callback
     )
 {
+    // in multiplexing mode response is received by reading loop of connection
+    if (m_connectionPool.isMultiplexingMode())
+    {
+        auto reqPtr=req.get();
+        m_connectionPool.sendMultiplexed(
+            reqPtr->taskCtx,
+            reqPtr->id(),
+            reqPtr->spanBuffers(),
+            reqPtr->responseData,
+            [req=std::move(req),callback=std::move(callback)](const Error& ec)
+            {
+                callback(ec);
+            }
+        );
+        return;
+    }
+
     auto send=[this](auto&& recv, common::SharedPtr<RequestT> req, CallbackT callback)
     {
         auto reqPtr=req.get();
@@ -186,6 +203,8 @@ Error RawTransport<RouterT,Traits>::loadLogConfig(
     auto ec=base::ConfigObject<raw_transport_config::type>::loadLogConfig(configTree,configPath,records,settings);
     HATN_CHECK_EC(ec)
     m_connectionPool.setMaxConnectionsPerPriority(config().fieldValue(raw_transport_config::max_pool_priority_connections));
+    m_connectionPool.setMultiplexingMode(config().fieldValue(raw_transport_config::multiplexing));
+    m_connectionPool.setMaxMultiplexedRequests(config().fieldValue(raw_transport_config::max_multiplexed_requests));
 
     return OK;
 }
@@ -36,6 +36,11 @@ HDU_UNIT(response,
     HDU_FIELD(message,TYPE_DATAUNIT,4)
 )
 
+//! Response with ID only, used to match responses to requests without full parsing.
+HDU_UNIT(response_id,
+    HDU_FIELD(id,TYPE_STRING,1)
+)
+
 HDU_UNIT(response_error_message,
     HDU_FIELD(code,TYPE_INT32,1,true)
     HDU_FIELD(family,HDU_TYPE_FIXED_STRING(ResponseFamilyNameLengthMax),3,true)
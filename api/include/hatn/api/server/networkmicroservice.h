@@ -19,6 +19,8 @@
 #ifndef HATNAPINETWORKMICROSERVICE_H
 #define HATNAPINETWORKMICROSERVICE_H
 
+#include <vector>
+
 #include <hatn/common/sharedptr.h>
 
 #include <hatn/app/appdefs.h>
@@ -45,8 +47,13 @@ struct NetworkMicroServiceConfig
     using NetworkServerCtx=NetworkServerCtxT;
     using NetworkServer=NetworkServerT;
 
+    /**
+     * @brief Make network servers of microservice.
+     *
+     * If a few servers are returned then all of them listen on the same endpoint with sharded acceptors.
+     */
     template <typename EnvT>
-    static Result<common::SharedPtr<NetworkServerCtx>> makeAndInitNetworkServer(
+    static Result<std::vector<common::SharedPtr<NetworkServerCtx>>> makeAndInitNetworkServer(
         lib::string_view name,
         common::SharedPtr<EnvT> env,
         const HATN_APP_NAMESPACE::App& app,
@@ -105,7 +112,7 @@ class NetworkMicroServiceTraits
 
         MicroServiceT* m_microservice;
 
-        common::SharedPtr<NetworkServerCtx> m_networkServerCtx;
+        std::vector<common::SharedPtr<NetworkServerCtx>> m_networkServerCtxs;
         std::shared_ptr<Server> m_server;
 };
 
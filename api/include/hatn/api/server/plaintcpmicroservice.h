@@ -38,7 +38,7 @@ struct PlainTcpMicroServiceConfig
     using NetworkServerCtx=PlainTcpServerContextT<Env>;
     using NetworkServer=PlainTcpServerT<Env>;
 
-    static Result<common::SharedPtr<NetworkServerCtx>> makeAndInitNetworkServer(
+    static Result<std::vector<common::SharedPtr<NetworkServerCtx>>> makeAndInitNetworkServer(
         lib::string_view name,
         common::SharedPtr<Env> env,
         const HATN_APP_NAMESPACE::App& app,
@@ -62,7 +62,7 @@ class PlainTcpConnectionTraits
             auto& server=ctx->template get<TcpServer<PlainTcpConnectionTraits>>();
             auto connectionCtx=common::makeTaskContextType<PlainTcpConnectionContextT<Env>>(
                 common::subcontexts(
-                    common::subcontext(server.env()->threads()->randomThread()),
+                    common::subcontext(server.connectionThread()),
                     common::subcontext(),
                     common::subcontext(),
                     common::subcontext()
@@ -86,7 +86,7 @@ class PlainTcpConnectionTraits
             auto connectionCtx=common::allocateTaskContextType<PlainTcpConnectionContextT<Env>>(
                 allocator,
                 common::subcontexts(
-                    common::subcontext(server.env()->template get<Threads>().threads()->randomThread()),
+                    common::subcontext(server.connectionThread()),
                     common::subcontext(),
                     common::subcontext(),
                     common::subcontext()
@@ -20,9 +20,14 @@
 #define HATNAPISERVER_H
 
 #include <memory>
+#include <map>
+#include <deque>
+#include <vector>
+#include <algorithm>
 
 #include <hatn/common/pmr//allocatorfactory.h>
 #include <hatn/common/sharedptr.h>
+#include <hatn/common/locker.h>
 
 #include <hatn/api/api.h>
 #include <hatn/api/apiliberror.h>
@@ -48,13 +53,15 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
             ) : m_connectionsStore(std::move(connectionsStore)),
                 m_dispatcher(std::move(dispatcher)),
                 m_authDispatcher(std::move(authDispatcher)),
-                m_closed(false)
+                m_closed(false),
+                m_maxPipelinedRequests(1)
         {}
 
         void close()
         {
             m_closed=true;
             closeAllConnections();
+            closeAllPipelines();
         }
 
         bool isClosed() const noexcept
@@ -72,6 +79,33 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
             return m_authDispatcher;
         }
 
+        /**
+         * @brief Set max number of requests processed in parallel on one connection.
+         * @param count Max number of requests.
+         *
+         * If count is greater than 1 then server keeps reading requests from connection while previous
+         * requests are being processed. Responses are sent in order of requests completion and must be correlated
+         * with requests by request ID. When the limit is reached, reading is paused until some response is sent.
+         * By default only one request is processed at a time and the next request is read only after response to
+         * the previous request is sent.
+         *
+         * Must be set before the server starts handling connections.
+         */
+        void setMaxPipelinedRequests(size_t count) noexcept
+        {
+            m_maxPipelinedRequests=(count==0)?1:count;
+        }
+
+        size_t maxPipelinedRequests() const noexcept
+        {
+            return m_maxPipelinedRequests;
+        }
+
+        bool isPipelining() const noexcept
+        {
+            return m_maxPipelinedRequests>1;
+        }
+
         /**
          * @brief Handle new connection by server.
          * @param ctx Connection context.
@@ -89,6 +123,11 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
                 return;
             }
             m_connectionsStore->registerConnection(ctx);
+            if (isPipelining())
+            {
+                common::MutexScopedLock l{m_pipelinesMutex};
+                m_pipelines.emplace(ctx->id(),std::make_shared<Pipeline>());
+            }
 
             waitForRequest(std::move(ctx),connection);
             if (waitNextConnection)
@@ -123,27 +162,28 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
             {
                 HATN_CTX_SCOPE("apiwaitforrequest")
 
-                // recv header
+                // recv message frame
                 auto self=this->shared_from_this();
-                connection.recv(
+                auto maxMessageSize=req.env->template get<ProtocolConfig>().maxMessageSize();
+                connection.recvFrame(
                     std::move(reqCtx),
-                    req.header.data(),
-                    req.header.size(),
-                    [ctx{std::move(ctx)},self{std::move(self)},this,&connection,&req](common::SharedPtr<RequestContext<Request>> reqCtx, const Error& ec)
+                    static_cast<uint32_t>(maxMessageSize),
+                    [ctx{std::move(ctx)},self{std::move(self)},this,&connection,&req](common::SharedPtr<RequestContext<Request>> reqCtx, const Error& ec, common::ByteArrayShared frame, uint32_t frameSize)
                     {
-                        HATN_CTX_SCOPE("apireqheader")
+                        HATN_CTX_SCOPE("apireq")
 
                         // handle error
                         if (ec)
                         {
-                            HATN_CTX_SCOPE_ERROR("recv header failed")
+                            HATN_CTX_SCOPE_ERROR("recv message failed")
                             closeRequest(reqCtx,ec);
                             resetConnection(ctx);
                             return;
                         }
 
                         // if no message then wait for the next request
-                        if (req.header.messageSize()==0)
+                        req.header.setMessageSize(frameSize);
+                        if (frameSize==0)
                         {
                             HATN_CTX_WARN("zero request size")
                             closeRequest(reqCtx);
@@ -151,76 +191,61 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
                             return;
                         }
 
-                        if (req.header.messageSize() > req.env->template get<ProtocolConfig>().maxMessageSize())
+                        if (!frame)
                         {
                             //! @todo Detect HTTP request and optionally redirect to some URL or send http-response
 
                             req.setResponseError(protocol::ResponseStatus::RequestTooBig);
+                            pipelineRequest(ctx,connection,false);
                             sendResponse(std::move(ctx),std::move(reqCtx),connection);
                             return;
                         }
+                        req.setRawData(std::move(frame));
+
+                        // parse request
+                        auto ec1=req.parseMessage();
+                        if (ec1)
+                        {
+                            HATN_CTX_SCOPE_ERROR("failed to parse message")
+                            req.setResponseError(std::move(ec1),protocol::ResponseStatus::FormatError);
+                            pipelineRequest(ctx,connection,false);
+                            sendResponse(std::move(ctx),std::move(reqCtx),connection);
+                            return;
+                        }
+
+                        //! @todo Validate request
+
+                        //! @todo Handle proxy field if allowed by server settings
+
+                        HATN_CTX_PUSH_FIXED_VAR("mthd",req.unit.fieldValue(protocol::request::method))
+                        HATN_CTX_PUSH_FIXED_VAR("req",lib::string_view{req.unit.fieldValue(protocol::request::id).toString()})
+                        HATN_CTX_PUSH_FIXED_VAR("srv",req.unit.fieldValue(protocol::request::service))
+                        if (req.unit.field(protocol::request::service_version).isSet())
+                        {
+                            HATN_CTX_PUSH_FIXED_VAR("s_ver",req.unit.fieldValue(protocol::request::service_version))
+                        }
+                        if (req.unit.field(protocol::request::topic).isSet())
+                        {
+                            HATN_CTX_PUSH_FIXED_VAR("tpc",req.unit.fieldValue(protocol::request::topic))
+                        }
+                        if (req.unit.field(protocol::request::message_type).isSet())
+                        {
+                            HATN_CTX_PUSH_FIXED_VAR("typ",req.unit.fieldValue(protocol::request::message_type))
+                        }
 
-                        // receive message
-                        req.rawData()->resize(req.header.messageSize());
-                        connection.recv(
-                            std::move(reqCtx),
-                            req.rawData()->data(),
-                            req.rawData()->size(),
-                            [ctx{std::move(ctx)},self{std::move(self)},this,&connection,&req](common::SharedPtr<RequestContext<Request>> reqCtx, const Error& ec)
-                            {
-                                HATN_CTX_SCOPE("apireq")
-
-                                // handle error
-                                if (ec)
-                                {
-                                    HATN_CTX_SCOPE_ERROR("recv body failed")
-                                    closeRequest(reqCtx,ec);
-                                    resetConnection(ctx);
-                                    return;
-                                }
-
-                                // parse request
-                                auto ec1=req.parseMessage();
-                                if (ec1)
-                                {
-                                    HATN_CTX_SCOPE_ERROR("failed to parse message")
-                                    req.setResponseError(std::move(ec1),protocol::ResponseStatus::FormatError);
-                                    sendResponse(std::move(ctx),std::move(reqCtx),connection);
-                                    return;
-                                }
-
-                                //! @todo Validate request
-
-                                //! @todo Handle proxy field if allowed by server settings
-
-                                auto& req=reqCtx->template get<Request>();
-                                HATN_CTX_PUSH_FIXED_VAR("mthd",req.unit.fieldValue(protocol::request::method))
-                                HATN_CTX_PUSH_FIXED_VAR("req",lib::string_view{req.unit.fieldValue(protocol::request::id).toString()})
-                                HATN_CTX_PUSH_FIXED_VAR("srv",req.unit.fieldValue(protocol::request::service))
-                                if (req.unit.field(protocol::request::service_version).isSet())
-                                {
-                                    HATN_CTX_PUSH_FIXED_VAR("s_ver",req.unit.fieldValue(protocol::request::service_version))
-                                }
-                                if (req.unit.field(protocol::request::topic).isSet())
-                                {
-                                    HATN_CTX_PUSH_FIXED_VAR("tpc",req.unit.fieldValue(protocol::request::topic))
-                                }
-                                if (req.unit.field(protocol::request::message_type).isSet())
-                                {
-                                    HATN_CTX_PUSH_FIXED_VAR("typ",req.unit.fieldValue(protocol::request::message_type))
-                                }
-
-                                // auth request if auth dispatcher is set
-                                if (m_authDispatcher)
-                                {
-                                    authRequest(std::move(ctx),std::move(reqCtx),connection);
-                                }
-                                else
-                                {
-                                    dispatchRequest(std::move(ctx),std::move(reqCtx),connection);
-                                }
-                            }
-                            );
+                        // auth request if auth dispatcher is set
+                        auto connectionCtx=ctx;
+                        if (m_authDispatcher)
+                        {
+                            authRequest(std::move(ctx),std::move(reqCtx),connection);
+                        }
+                        else
+                        {
+                            dispatchRequest(std::move(ctx),std::move(reqCtx),connection);
+                        }
+
+                        // in pipelining mode read the next request while this one is being processed
+                        pipelineRequest(connectionCtx,connection,true);
                     }
                     );
             }
@@ -257,7 +282,10 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
             }
 
             auto wCtx=common::toWeakPtr(ctx);
-            watchConnection(std::move(ctx),connection);
+            if (!isPipelining())
+            {
+                watchConnection(std::move(ctx),connection);
+            }
 
             auto self=this->shared_from_this();
             m_authDispatcher->dispatch(std::move(reqCtx),
@@ -282,7 +310,7 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
                                         }
 
                                         // cancel connection watching
-                                        if (ctx)
+                                        if (ctx && !isPipelining())
                                         {
                                             connection.cancel();
                                         }
@@ -314,7 +342,10 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
             }
 
             auto wCtx=common::toWeakPtr(ctx);
-            watchConnection(std::move(ctx),connection);
+            if (!isPipelining())
+            {
+                watchConnection(std::move(ctx),connection);
+            }
 
             auto self=this->shared_from_this();
             m_dispatcher->dispatch(std::move(reqCtx),
@@ -339,7 +370,10 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
                     }
 
                     // cancel connection watching
-                    connection.cancel();
+                    if (!isPipelining())
+                    {
+                        connection.cancel();
+                    }
 
                     // close connection if needed
                     if (req.closeConnection)
@@ -366,72 +400,120 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
                 closeRequest(reqCtx,apiLibError(ApiLibError::SERVER_CLOSED));
                 return;
             }
-            auto& req=reqCtx->template get<Request>();
-            req.setResponseStatus();
 
-            // serialize response
-            auto ec=req.response.serialize();
-            if (ec)
+            auto factory=reqCtx->template get<Request>().env->template get<AllocatorFactory>().factory();
+            common::SpanBuffers buffers{factory->template dataAllocator<common::SpanBuffer>()};
+            std::vector<common::SharedPtr<RequestContext<Request>>> coalesced;
+
+            // in pipelining mode responses are sent in order of requests completion,
+            // responses completed while previous write is in progress are coalesced into the next write
+            if (isPipelining())
             {
-                HATN_CTX_ERROR(ec,"failed to serialize response")
-                req.setResponseError(protocol::ResponseStatus::InternalServerError);
+                auto pipeline=ctx?findPipeline(ctx):std::shared_ptr<Pipeline>{};
+                if (!pipeline)
+                {
+                    closeRequest(reqCtx,apiLibError(ApiLibError::CONNECTION_CLOSED));
+                    return;
+                }
+                if (pipeline->sending)
+                {
+                    pipeline->responses.push_back(std::move(reqCtx));
+                    return;
+                }
+                pipeline->sending=true;
+
+                coalesced.reserve(pipeline->responses.size());
+                while (!pipeline->responses.empty())
+                {
+                    coalesced.push_back(std::move(pipeline->responses.front()));
+                    pipeline->responses.pop_front();
+                }
             }
 
-            auto self=this->shared_from_this();
+            // prepare gather list of response frames
+            appendResponse(reqCtx,buffers);
+            for (auto&& it: coalesced)
+            {
+                appendResponse(it,buffers);
+            }
 
-            // send header
-            req.header.setMessageSize(static_cast<uint32_t>(req.response.size()));
+            // send all frames with single write
+            auto self=this->shared_from_this();
             connection.send(
                 std::move(reqCtx),
-                req.header.data(),
-                req.header.size(),
-                [ctx{std::move(ctx)},self{std::move(self)},this,&connection,&req](common::SharedPtr<RequestContext<Request>> reqCtx, const Error& ec, size_t)
+                std::move(buffers),
+                [ctx{std::move(ctx)},self{std::move(self)},this,&connection,coalesced{std::move(coalesced)}](common::SharedPtr<RequestContext<Request>> reqCtx, const Error& ec, size_t,common::SpanBuffers)
                 {
-                    HATN_CTX_SCOPE("apirespheadercb")
+                    HATN_CTX_SCOPE("apisendresponsecb")
 
                     if (m_closed)
                     {
                         closeRequest(reqCtx,apiLibError(ApiLibError::SERVER_CLOSED));
+                        for (auto&& it: coalesced)
+                        {
+                            closeRequest(it,apiLibError(ApiLibError::SERVER_CLOSED));
+                        }
                         return;
                     }
 
                     // handle error
                     if (ec)
                     {
-                        HATN_CTX_SCOPE_ERROR("send header failed")
+                        HATN_CTX_SCOPE_ERROR("send response failed")
                         closeRequest(reqCtx,ec);
+                        for (auto&& it: coalesced)
+                        {
+                            closeRequest(it,ec);
+                        }
                         resetConnection(ctx);
                         return;
                     }
 
-                    // send message
-                    connection.send(
-                        std::move(reqCtx),
-                        req.response.buffers(req.env->template get<AllocatorFactory>().factory()),
-                        [ctx{std::move(ctx)},self{std::move(self)},this,&connection](common::SharedPtr<RequestContext<Request>> reqCtx, const Error& ec, size_t,common::SpanBuffers)
-                        {
-                            // handle error
-                            if (ec)
-                            {
-                                HATN_CTX_SCOPE("apirespbodycb")
-                                HATN_CTX_SCOPE_ERROR("send body failed")
-                                closeRequest(reqCtx,ec);
-                                resetConnection(ctx);
-                                return;
-                            }
-
-                            // close request
-                            closeRequest(reqCtx);
+                    // close requests
+                    closeRequest(reqCtx);
+                    for (auto&& it: coalesced)
+                    {
+                        closeRequest(it);
+                    }
 
-                            // wait for next request
-                            waitForRequest(std::move(ctx),connection);
-                        }
-                    );
+                    // wait for next request
+                    if (isPipelining())
+                    {
+                        pipelineResponseSent(std::move(ctx),connection,1+coalesced.size());
+                    }
+                    else
+                    {
+                        waitForRequest(std::move(ctx),connection);
+                    }
                 }
             );
         }
 
-        void closeRequest(common::SharedPtr<RequestContext<Request>>& reqCtx, const Error& ec={})
+        void appendResponse(const common::SharedPtr<RequestContext<Request>>& reqCtx, common::SpanBuffers& buffers)
+        {
+            auto& req=reqCtx->template get<Request>();
+            req.setResponseStatus();
+
+            // serialize response
+            auto ec=req.response.serialize();
+            if (ec)
+            {
+                HATN_CTX_ERROR(ec,"failed to serialize response")
+                req.setResponseError(protocol::ResponseStatus::InternalServerError);
+            }
+
+            // header and message buffers of response frame
+            req.header.setMessageSize(static_cast<uint32_t>(req.response.size()));
+            auto messageBufs=req.response.buffers(req.env->template get<AllocatorFactory>().factory());
+            buffers.reserve(buffers.size()+1+messageBufs.size());
+            buffers.emplace_back(req.header.data(),req.header.size());
+            for (auto&& buf: messageBufs)
+            {
+                buffers.emplace_back(std::move(buf));
+            }
+        }
+
+        void closeRequest(const common::SharedPtr<RequestContext<Request>>& reqCtx, const Error& ec={})
         {
             auto& req=reqCtx->template get<Request>();
             req.close(ec);
@@ -466,12 +548,134 @@ class Server : public std::enable_shared_from_this<Server<ConnectionsStoreT,Disp
         {
             ctx->resetParentCtx();
             m_connectionsStore->removeConnection(ctx->id());
+            if (isPipelining())
+            {
+                closePipeline(ctx->id());
+            }
+        }
+
+        /**
+         * @brief State of requests pipelining on a connection.
+         *
+         * State is accessed only from the thread of connection.
+         */
+        struct Pipeline
+        {
+            size_t inFlight=0;
+            bool readPaused=false;
+            bool sending=false;
+            std::deque<common::SharedPtr<RequestContext<Request>>> responses;
+        };
+
+        template <typename ConnectionContext>
+        std::shared_ptr<Pipeline> findPipeline(const common::SharedPtr<ConnectionContext>& ctx) const
+        {
+            common::MutexScopedLock l{m_pipelinesMutex};
+            auto it=m_pipelines.find(ctx->id());
+            if (it!=m_pipelines.end())
+            {
+                return it->second;
+            }
+            return std::shared_ptr<Pipeline>{};
+        }
+
+        template <typename ConnectionContext, typename Connection>
+        void pipelineRequest(const common::SharedPtr<ConnectionContext>& ctx, Connection& connection, bool readNext)
+        {
+            if (!isPipelining())
+            {
+                return;
+            }
+            auto pipeline=findPipeline(ctx);
+            if (!pipeline)
+            {
+                return;
+            }
+
+            pipeline->inFlight++;
+            if (readNext && pipeline->inFlight<m_maxPipelinedRequests)
+            {
+                waitForRequest(ctx,connection);
+            }
+            else
+            {
+                // backpressure, next request will be read when some response is sent
+                pipeline->readPaused=true;
+            }
+        }
+
+        template <typename ConnectionContext, typename Connection>
+        void pipelineResponseSent(common::SharedPtr<ConnectionContext> ctx, Connection& connection, size_t count)
+        {
+            auto pipeline=findPipeline(ctx);
+            if (!pipeline)
+            {
+                return;
+            }
+
+            pipeline->sending=false;
+            pipeline->inFlight-=(std::min)(pipeline->inFlight,count);
+
+            // send responses completed during previous write
+            if (!pipeline->responses.empty())
+            {
+                auto reqCtx=std::move(pipeline->responses.front());
+                pipeline->responses.pop_front();
+                sendResponse(ctx,std::move(reqCtx),connection);
+            }
+
+            // resume reading
+            if (pipeline->readPaused && pipeline->inFlight<m_maxPipelinedRequests)
+            {
+                pipeline->readPaused=false;
+                waitForRequest(std::move(ctx),connection);
+            }
+        }
+
+        void closePipeline(const lib::string_view& id)
+        {
+            std::shared_ptr<Pipeline> pipeline;
+            {
+                common::MutexScopedLock l{m_pipelinesMutex};
+                auto it=m_pipelines.find(id);
+                if (it==m_pipelines.end())
+                {
+                    return;
+                }
+                pipeline=std::move(it->second);
+                m_pipelines.erase(it);
+            }
+            for (auto&& reqCtx: pipeline->responses)
+            {
+                closeRequest(reqCtx,apiLibError(ApiLibError::CONNECTION_CLOSED));
+            }
+            pipeline->responses.clear();
+        }
+
+        void closeAllPipelines()
+        {
+            std::map<common::TaskContextId,std::shared_ptr<Pipeline>> pipelines;
+            {
+                common::MutexScopedLock l{m_pipelinesMutex};
+                pipelines.swap(m_pipelines);
+            }
+            for (auto&& it: pipelines)
+            {
+                for (auto&& reqCtx: it.second->responses)
+                {
+                    closeRequest(reqCtx,apiLibError(ApiLibError::SERVER_CLOSED));
+                }
+            }
         }
 
         std::shared_ptr<ConnectionsStoreT> m_connectionsStore;
         std::shared_ptr<DispatcherT> m_dispatcher;
         std::shared_ptr<AuthDispatcherT> m_authDispatcher;
         bool m_closed;
+
+        size_t m_maxPipelinedRequests;
+        mutable common::MutexLock m_pipelinesMutex;
+        std::map<common::TaskContextId,std::shared_ptr<Pipeline>> m_pipelines;
 };
 
 } // namespace server
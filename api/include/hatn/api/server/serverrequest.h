@@ -247,6 +247,12 @@ struct Request : public common::TaskSubcontext
         return requestBuf.mainContainer();
     }
 
+    void setRawData(common::ByteArrayShared data)
+    {
+        requestBuf=du::WireBufSolidShared{std::move(data),env->template get<AllocatorFactory>().factory()};
+        requestBuf.setUseInlineBuffers(true);
+    }
+
     common::ByteArrayShared message() const
     {
         const auto& messageField=unit.field(protocol::request::message);
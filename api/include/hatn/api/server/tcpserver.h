@@ -113,6 +113,41 @@ class TcpServer : public WithEnv<typename Traits::Env>,
             return m_serverEndpoint;
         }
 
+        void setMaxPipelinedRequests(size_t count) noexcept
+        {
+            m_maxPipelinedRequests=count;
+        }
+
+        size_t maxPipelinedRequests() const noexcept
+        {
+            return m_maxPipelinedRequests;
+        }
+
+        /**
+         * @brief Keep accepted connections on the thread of this server.
+         *
+         * Used when a few servers listen on the same endpoint on different threads,
+         * otherwise connections are distributed among threads of environment.
+         */
+        void setConnectionsOnServerThread(bool enable) noexcept
+        {
+            m_connectionsOnServerThread=enable;
+        }
+
+        bool isConnectionsOnServerThread() const noexcept
+        {
+            return m_connectionsOnServerThread;
+        }
+
+        common::Thread* connectionThread() const
+        {
+            if (m_connectionsOnServerThread)
+            {
+                return this->thread();
+            }
+            return this->env()->template get<Threads>().threads()->randomThread();
+        }
+
         template <typename ServerContextT>
         auto makeContext(
                 common::SharedPtr<ServerContextT> ctx
@@ -203,6 +238,8 @@ class TcpServer : public WithEnv<typename Traits::Env>,
         }
 
         const common::pmr::AllocatorFactory* m_allocatorFactory=common::pmr::AllocatorFactory::getDefault();
+        size_t m_maxPipelinedRequests=1;
+        bool m_connectionsOnServerThread=false;
 };
 
 }
@@ -1,5 +1,6 @@
 SET (TEST_SOURCES
     ${API_TEST_SRC}/testplaintcpconnection.cpp
+    ${API_TEST_SRC}/testframedreader.cpp
     ${API_TEST_SRC}/testclientserver.cpp
     ${API_TEST_SRC}/testmicroservice.cpp
 )
@@ -31,6 +32,9 @@ SET (TEST_JSON
     ${API_TEST_SRC}/assets/microservice-unknown-dispatcher.jsonc
     ${API_TEST_SRC}/assets/microservice-unknown-authdispatcher.jsonc
     ${API_TEST_SRC}/assets/microservice-port-busy.jsonc
+    ${API_TEST_SRC}/assets/microservices-sharded.jsonc
+    ${API_TEST_SRC}/assets/microservices-pipelined.jsonc
+    ${API_TEST_SRC}/assets/microservice-invalid-shards.jsonc
 )
 
 ADD_CUSTOM_TARGET(apitest-json SOURCES ${TEST_JSON})
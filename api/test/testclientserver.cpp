@@ -15,6 +15,8 @@
 
 /****************************************************************************/
 
+#include <atomic>
+
 #include <boost/test/unit_test.hpp>
 
 #include "hatn_test_config.h"
@@ -24,6 +26,8 @@
 
 #include <hatn/logcontext/streamlogger.h>
 
+#include <hatn/base/configtreeloader.h>
+
 #include <hatn/dataunit/ipp/syntax.ipp>
 #include <hatn/dataunit/ipp/wirebuf.ipp>
 #include <hatn/dataunit/ipp/objectid.ipp>
@@ -179,6 +183,9 @@ using Service1=server::ServerServiceV<server::ServiceSingleMethod<Service1Method
 
 //---------------------------------------------------------------
 
+std::atomic<size_t> Service2Method1InFlight{0};
+std::atomic<size_t> Service2Method1MaxInFlight{0};
+
 class Service2Method1Traits : public server::NoValidatorTraits
 {
     public:
@@ -186,6 +193,8 @@ class Service2Method1Traits : public server::NoValidatorTraits
         using Request=server::Request<>;
         using Message=service2_msg1::managed;
 
+        constexpr static const uint64_t ResponseDelayUs=20000;
+
         void exec(
             SharedPtr<server::RequestContext<server::Request<>>> request,
             server::RouteCb<server::Request<>> callback,
@@ -194,9 +203,34 @@ class Service2Method1Traits : public server::NoValidatorTraits
         {
             BOOST_TEST_MESSAGE(fmt::format("Service2 method1 exec: field1={}, field2={}",msg->fieldValue(service2_msg1::field1),msg->fieldValue(service2_msg1::field2)));
 
-            auto& req=request->get<server::Request<>>();
-            req.response.setSuccess();
-            callback(std::move(request));
+            // count requests waiting for responses
+            auto inFlight=++Service2Method1InFlight;
+            auto maxInFlight=Service2Method1MaxInFlight.load();
+            while (inFlight>maxInFlight && !Service2Method1MaxInFlight.compare_exchange_weak(maxInFlight,inFlight))
+            {}
+
+            // delay response so that pipelined requests are executed concurrently
+            auto thread=TaskWithContextThread::current();
+            thread->installTimer(
+                ResponseDelayUs,
+                [thread,request{std::move(request)},callback{std::move(callback)}]()
+                {
+                    postAsyncTask(
+                        thread,
+                        request,
+                        [callback](auto request)
+                        {
+                            --Service2Method1InFlight;
+
+                            auto& req=request->template get<server::Request<>>();
+                            req.response.setSuccess();
+                            callback(std::move(request));
+                        }
+                    );
+                    return false;
+                },
+                true
+            );
         }
 };
 class Service2Method1 : public server::ServiceMethodV<server::ServiceMethodT<Service2Method1Traits>>
@@ -459,5 +493,81 @@ BOOST_FIXTURE_TEST_CASE(TestExec,TestEnv)
     BOOST_CHECK(true);
 }
 
+BOOST_FIXTURE_TEST_CASE(TestExecMultiplexed,TestEnv)
+{
+    createThreads(2);
+    auto serverThread=threadWithContextTask(0);
+    auto clientThread=threadWithContextTask(1);
+
+    std::map<std::string,SharedPtr<server::PlainTcpConnectionContext>> connections;
+    auto server=createServer(serverThread.get(),connections);
+    server.first->setMaxPipelinedRequests(4);
+
+    auto session=client::makeSessionNoAuthContext();
+    auto client=createClient(clientThread.get());
+
+    HATN_BASE_NAMESPACE::ConfigTreeLoader loader;
+    HATN_BASE_NAMESPACE::ConfigTree configTree;
+    auto ec=loader.loadFromString(configTree,"{\"client\" : {\"multiplexing\" : true, \"max_multiplexed_requests\" : 8}}");
+    BOOST_REQUIRE(!ec);
+    HATN_BASE_NAMESPACE::config_object::LogRecords records;
+    ec=client->get<ClientType>().loadLogConfig(configTree,"client",records,HATN_BASE_NAMESPACE::config_object::LogSettings{});
+    BOOST_REQUIRE(!ec);
+
+    auto clientWithAuth=createClientWithAuth(client,session);
+    auto service2Client=makeShared<client::ServiceClient<ClientWithAuthCtxType,ClientWithAuthType>>("service2",clientWithAuth);
+
+    serverThread->start();
+    clientThread->start();
+
+    Service2Method1MaxInFlight.store(0);
+
+    constexpr const size_t RequestCount=20;
+    std::atomic<size_t> doneCount{0};
+    auto invokeTasks=[service2Client,&doneCount]()
+    {
+        for (size_t i=0;i<RequestCount;i++)
+        {
+            auto cb=[&doneCount](auto, const Error& ec, auto)
+            {
+                BOOST_CHECK(!ec);
+                if (!ec)
+                {
+                    ++doneCount;
+                }
+            };
+
+            auto ctx=makeLogCtx();
+            service2_msg1::type msg;
+            msg.setFieldValue(service2_msg1::field2,static_cast<uint32_t>(i));
+            msg.setFieldValue(service2_msg1::field1,"Hi!");
+            service2Client->exec(
+                ctx,
+                cb,
+                "service2_method1",
+                msg,
+                "topic1"
+                );
+        }
+    };
+
+    clientThread->execAsync(invokeTasks);
+
+    int secs=3;
+    BOOST_TEST_MESSAGE(fmt::format("Running test for {} seconds",secs));
+    exec(secs);
+
+    serverThread->stop();
+    clientThread->stop();
+
+    BOOST_CHECK_EQUAL(doneCount.load(),RequestCount);
+    BOOST_CHECK_EQUAL(connections.size(),1);
+
+    // requests were multiplexed on one connection and executed concurrently up to the server's pipelining limit
+    BOOST_TEST_MESSAGE(fmt::format("Max requests in flight: {}",Service2Method1MaxInFlight.load()));
+    BOOST_CHECK_GT(Service2Method1MaxInFlight.load(),1);
+    BOOST_CHECK_LE(Service2Method1MaxInFlight.load(),4);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
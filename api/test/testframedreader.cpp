@@ -0,0 +1,261 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/*
+
+*/
+/** @file api/test/testframedreader.cpp
+  */
+
+/****************************************************************************/
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <hatn/api/framedreader.h>
+
+HATN_API_USING
+HATN_COMMON_USING
+
+namespace {
+
+std::string makeFrame(const std::string& msg)
+{
+    std::string frame;
+    frame.resize(protocol::HEADER_LENGTH);
+    protocol::sizeToBuf(static_cast<uint32_t>(msg.size()),&frame[0]);
+    frame.append(msg);
+    return frame;
+}
+
+std::string makeMessage(size_t size, char first)
+{
+    std::string msg;
+    msg.reserve(size);
+    for (size_t i=0;i<size;i++)
+    {
+        msg.push_back(static_cast<char>(first+i%26));
+    }
+    return msg;
+}
+
+// write data to reader as it would be read from connection
+void feed(FramedReader& reader, const char* data, size_t size)
+{
+    while (size!=0)
+    {
+        auto buf=reader.prepareRead();
+        BOOST_REQUIRE_GT(buf.second,0);
+        auto count=(std::min)(buf.second,size);
+        memcpy(buf.first,data,count);
+        reader.commitRead(count);
+        data+=count;
+        size-=count;
+    }
+}
+
+void feed(FramedReader& reader, const std::string& data)
+{
+    feed(reader,data.data(),data.size());
+}
+
+std::string frameContent(const ByteArrayShared& frame)
+{
+    return std::string{frame->data(),frame->size()};
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(TestFramedReader)
+
+BOOST_AUTO_TEST_CASE(PartialHeader)
+{
+    FramedReader reader;
+
+    auto msg=makeMessage(100,'a');
+    auto frame=makeFrame(msg);
+
+    // header is not complete
+    uint32_t size=0;
+    BOOST_CHECK(!reader.frameSize(size));
+    feed(reader,frame.data(),2);
+    BOOST_CHECK(!reader.frameSize(size));
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),2);
+
+    // header is complete but message is not
+    feed(reader,frame.data()+2,protocol::HEADER_LENGTH);
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_CHECK_EQUAL(size,msg.size());
+    BOOST_CHECK(!reader.hasFrame(size));
+
+    // the rest of message
+    feed(reader,frame.data()+2+protocol::HEADER_LENGTH,frame.size()-2-protocol::HEADER_LENGTH);
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view=reader.takeFrame(size);
+    BOOST_CHECK_EQUAL(frameContent(view),msg);
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),0);
+    BOOST_CHECK(!reader.frameSize(size));
+}
+
+BOOST_AUTO_TEST_CASE(MultipleFrames)
+{
+    FramedReader reader;
+
+    auto msg1=makeMessage(10,'a');
+    auto msg2=makeMessage(0,'a');
+    auto msg3=makeMessage(300,'k');
+    feed(reader,makeFrame(msg1)+makeFrame(msg2)+makeFrame(msg3));
+
+    uint32_t size=0;
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view1=reader.takeFrame(size);
+
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_CHECK_EQUAL(size,0);
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view2=reader.takeFrame(size);
+
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view3=reader.takeFrame(size);
+
+    BOOST_CHECK_EQUAL(frameContent(view1),msg1);
+    BOOST_CHECK_EQUAL(view2->size(),0);
+    BOOST_CHECK_EQUAL(frameContent(view3),msg3);
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),0);
+}
+
+BOOST_AUTO_TEST_CASE(PrepareReadCompaction)
+{
+    FramedReader reader{FramedReader::MinReadSize*2};
+    auto bufferSize=reader.bufferSize();
+    auto begin=reader.prepareRead().first;
+
+    // first frame almost fills the buffer and head of the second frame is in the tail of the buffer
+    auto msg1=makeMessage(bufferSize-protocol::HEADER_LENGTH-500,'a');
+    auto msg2=makeMessage(800,'b');
+    auto frame2=makeFrame(msg2);
+    size_t head=100;
+    feed(reader,makeFrame(msg1)+frame2.substr(0,head));
+    uint32_t size=0;
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_REQUIRE(reader.hasFrame(size));
+    {
+        auto view1=reader.takeFrame(size);
+        BOOST_CHECK_EQUAL(frameContent(view1),msg1);
+    }
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),head);
+
+    // there is no room for reading, buffered data is moved to the beginning of the same chunk
+    auto buf=reader.prepareRead();
+    BOOST_CHECK(buf.first==begin+head);
+    BOOST_CHECK_EQUAL(buf.second,bufferSize-head);
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),head);
+
+    feed(reader,frame2.data()+head,frame2.size()-head);
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view2=reader.takeFrame(size);
+    BOOST_CHECK_EQUAL(frameContent(view2),msg2);
+}
+
+BOOST_AUTO_TEST_CASE(ChunkReallocation)
+{
+    FramedReader reader{FramedReader::MinReadSize*2};
+    auto bufferSize=reader.bufferSize();
+    auto begin=reader.prepareRead().first;
+
+    // first frame almost fills the buffer and head of the second frame is in the tail of the buffer
+    auto msg1=makeMessage(bufferSize-protocol::HEADER_LENGTH-500,'a');
+    auto msg2=makeMessage(800,'b');
+    auto frame2=makeFrame(msg2);
+    size_t head=100;
+    feed(reader,makeFrame(msg1)+frame2.substr(0,head));
+
+    // view of the first frame is kept alive
+    uint32_t size=0;
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view1=reader.takeFrame(size);
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),head);
+
+    // chunk is in use by the first view, so buffered data is copied to a new chunk
+    auto buf=reader.prepareRead();
+    BOOST_CHECK(buf.first!=begin+head);
+    BOOST_CHECK_EQUAL(buf.second,bufferSize-head);
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),head);
+
+    // fill the new chunk with more frames, the first view is not overwritten
+    feed(reader,frame2.data()+head,frame2.size()-head);
+    auto msg3=makeMessage(bufferSize/2,'c');
+    feed(reader,makeFrame(msg3));
+
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view2=reader.takeFrame(size);
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view3=reader.takeFrame(size);
+
+    BOOST_CHECK_EQUAL(frameContent(view1),msg1);
+    BOOST_CHECK_EQUAL(frameContent(view2),msg2);
+    BOOST_CHECK_EQUAL(frameContent(view3),msg3);
+}
+
+BOOST_AUTO_TEST_CASE(OversizedFrame)
+{
+    FramedReader reader{FramedReader::MinReadSize*2};
+    auto bufferSize=reader.bufferSize();
+
+    auto msg1=makeMessage(bufferSize*3,'a');
+    auto frame1=makeFrame(msg1);
+    size_t head=1000;
+    feed(reader,frame1.data(),protocol::HEADER_LENGTH+head);
+
+    uint32_t size=0;
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_CHECK_EQUAL(size,msg1.size());
+    BOOST_CHECK(!reader.fitsBuffer(size));
+
+    // received part of the message is copied to the frame, the rest is read directly to the frame
+    auto frame=reader.takeOversizedFrame(size);
+    BOOST_REQUIRE_EQUAL(frame.first->size(),msg1.size());
+    BOOST_CHECK_EQUAL(frame.second,head);
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),0);
+    memcpy(frame.first->data()+frame.second,msg1.data()+frame.second,msg1.size()-frame.second);
+    BOOST_CHECK_EQUAL(frameContent(frame.first),msg1);
+
+    // reader is ready for the next frame
+    auto msg2=makeMessage(50,'z');
+    feed(reader,makeFrame(msg2));
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_REQUIRE(reader.hasFrame(size));
+    auto view2=reader.takeFrame(size);
+    BOOST_CHECK_EQUAL(frameContent(view2),msg2);
+}
+
+BOOST_AUTO_TEST_CASE(SkipHeader)
+{
+    FramedReader reader;
+
+    // frame that exceeds max size is dropped by consuming its header only
+    auto msg1=makeMessage(100,'a');
+    auto msg2=makeMessage(20,'b');
+    feed(reader,makeFrame(msg1)+makeFrame(msg2));
+
+    uint32_t size=0;
+    BOOST_REQUIRE(reader.frameSize(size));
+    BOOST_CHECK_EQUAL(size,msg1.size());
+    reader.skipHeader();
+    BOOST_CHECK_EQUAL(reader.bufferedSize(),msg1.size()+protocol::HEADER_LENGTH+msg2.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,9 @@
 
 /****************************************************************************/
 
+#include <atomic>
+#include <algorithm>
+
 #include <boost/test/unit_test.hpp>
 
 #include "hatn_test_config.h"
@@ -24,6 +27,8 @@
 
 #include <hatn/logcontext/streamlogger.h>
 
+#include <hatn/base/configtreeloader.h>
+
 #include <hatn/dataunit/ipp/syntax.ipp>
 #include <hatn/dataunit/ipp/wirebuf.ipp>
 #include <hatn/dataunit/ipp/objectid.ipp>
@@ -219,6 +224,10 @@ class Service2Method1 : public server::ServiceMethodV<server::ServiceMethodT<Ser
         {}
 };
 
+constexpr const uint32_t PipelinedRequestCount=20;
+std::atomic<size_t> Service2Method3InFlight{0};
+std::atomic<size_t> Service2Method3MaxInFlight{0};
+
 class Service2Method2Traits : public server::NoValidatorTraits
 {
     public:
@@ -249,6 +258,65 @@ class Service2Method2 : public server::ServiceMethodV<server::ServiceMethodT<Ser
         {}
 };
 
+class Service2Method3Traits : public server::NoValidatorTraits
+{
+    public:
+
+        using Request=server::Request<>;
+        using Message=service2_msg1::managed;
+
+        constexpr static const uint64_t ResponseDelayUs=10000;
+
+        void exec(
+            SharedPtr<server::RequestContext<server::Request<>>> request,
+            server::RouteCb<server::Request<>> callback,
+            SharedPtr<service2_msg1::managed> msg
+            ) const
+        {
+            BOOST_TEST_MESSAGE(fmt::format("Service2 method3 exec: field2={}",msg->fieldValue(service2_msg1::field2)));
+
+            // count requests being processed
+            auto inFlight=++Service2Method3InFlight;
+            auto maxInFlight=Service2Method3MaxInFlight.load();
+            while (inFlight>maxInFlight && !Service2Method3MaxInFlight.compare_exchange_weak(maxInFlight,inFlight))
+            {}
+
+            // later requests complete earlier so that responses are sent out of order of requests
+            auto delay=ResponseDelayUs*(1+(PipelinedRequestCount-msg->fieldValue(service2_msg1::field2))%4);
+            auto thread=TaskWithContextThread::current();
+            thread->installTimer(
+                delay,
+                [thread,request{std::move(request)},callback{std::move(callback)},msg{std::move(msg)}]()
+                {
+                    postAsyncTask(
+                        thread,
+                        request,
+                        [callback,msg](auto request)
+                        {
+                            --Service2Method3InFlight;
+
+                            // echo message to correlate response with request
+                            auto& req=request->template get<server::Request<>>();
+                            req.response.setSuccessMessage(msg);
+                            callback(std::move(request));
+                        }
+                    );
+                    return false;
+                },
+                true
+            );
+        }
+};
+class Service2Method3 : public server::ServiceMethodV<server::ServiceMethodT<Service2Method3Traits>>
+{
+    public:
+
+        using Base=server::ServiceMethodV<server::ServiceMethodT<Service2Method3Traits>>;
+
+        Service2Method3() : Base("service2_method3")
+        {}
+};
+
 using Service2=server::ServerServiceV<server::ServiceMultipleMethods<>>;
 
 //---------------------------------------------------------------
@@ -303,7 +371,8 @@ Result<ServerApp> createServer(std::string configFileName, int expectedErrorCode
     server::ServiceMultipleMethods<> serv2;
     auto service2Method1=std::make_shared<Service2Method1>();
     auto service2Method2=std::make_shared<Service2Method2>();
-    serv2.registerMethods({service2Method1,service2Method2});
+    auto service2Method3=std::make_shared<Service2Method3>();
+    serv2.registerMethods({service2Method1,service2Method2,service2Method3});
     auto service2=std::make_shared<Service2>("service2",std::move(serv2));
     serviceRouter->registerLocalService(std::move(service2));
     using dispatcherType=server::ServiceDispatcher<>;
@@ -399,6 +468,11 @@ BOOST_FIXTURE_TEST_CASE(MicroservicePortBusy,TestEnv)
     runCreateServer("microservice-port-busy.jsonc",this,ApiLibError::MICROSERVICE_RUN_FAILED);
 }
 
+BOOST_FIXTURE_TEST_CASE(MicroserviceInvalidShards,TestEnv)
+{
+    runCreateServer("microservice-invalid-shards.jsonc",this,ApiLibError::MICROSERVICE_RUN_FAILED);
+}
+
 BOOST_FIXTURE_TEST_CASE(TestExec,TestEnv)
 {
     auto serverCtx=createServer("microservices.jsonc");
@@ -499,5 +573,176 @@ BOOST_FIXTURE_TEST_CASE(TestExec,TestEnv)
     BOOST_CHECK(true);
 }
 
+BOOST_FIXTURE_TEST_CASE(TestExecSharded,TestEnv)
+{
+    // microservice1 listens on two acceptors sharing the same port
+    auto serverCtx=createServer("microservices-sharded.jsonc");
+
+    createThreads(1);
+    auto clientThread=threadWithContextTask(0);
+
+    // each client opens own connection, connections are distributed among acceptors
+    constexpr const size_t ClientCount=8;
+    std::vector<SharedPtr<client::ServiceClient<ClientWithAuthCtxType,ClientWithAuthType>>> serviceClients;
+    for (size_t i=0;i<ClientCount;i++)
+    {
+        auto session=client::makeSessionNoAuthContext();
+        auto client=createClient(clientThread.get());
+        auto clientWithAuth=createClientWithAuth(client,session);
+        serviceClients.push_back(makeShared<client::ServiceClient<ClientWithAuthCtxType,ClientWithAuthType>>("service1",clientWithAuth));
+    }
+
+    clientThread->start();
+
+    std::atomic<size_t> responseCount{0};
+    auto invokeTasks=[&serviceClients,&responseCount]()
+    {
+        for (size_t i=0;i<serviceClients.size();i++)
+        {
+            auto cb=[&responseCount,i](auto, const Error& ec, auto)
+            {
+                HATN_TEST_MESSAGE_TS(fmt::format("invokeTasks cb {}, ec: {}/{}",i,ec.value(),ec.message()));
+                BOOST_CHECK(!ec);
+                if (!ec)
+                {
+                    responseCount++;
+                }
+            };
+
+            auto ctx=makeLogCtx();
+            service1_msg1::type msg;
+            msg.setFieldValue(service1_msg1::field1,static_cast<uint32_t>(i));
+            msg.setFieldValue(service1_msg1::field2,"hello sharded acceptors!");
+            Message msgData;
+            auto ec=msgData.setContent(msg);
+            BOOST_CHECK(!ec);
+            serviceClients[i]->exec(
+                ctx,
+                cb,
+                "service1_method1",
+                std::move(msgData),
+                "topic1"
+            );
+        }
+    };
+
+    clientThread->execAsync(invokeTasks);
+
+    int secs=3;
+    BOOST_TEST_MESSAGE(fmt::format("Running test for {} seconds",secs));
+    exec(secs);
+
+    clientThread->stop();
+    BOOST_CHECK_EQUAL(responseCount.load(),ClientCount);
+
+    for (auto&& it: serverCtx->microservices)
+    {
+        it.second->close();
+    }
+    exec(1);
+    serverCtx->app->close();
+
+    exec(1);
+}
+
+BOOST_FIXTURE_TEST_CASE(TestExecPipelined,TestEnv)
+{
+    // microservice1 processes up to 4 requests of a connection in parallel
+    constexpr const size_t MaxPipelinedRequests=4;
+    auto serverCtx=createServer("microservices-pipelined.jsonc");
+
+    createThreads(1);
+    auto clientThread=threadWithContextTask(0);
+
+    // client multiplexes requests on one connection
+    auto session=client::makeSessionNoAuthContext();
+    auto client=createClient(clientThread.get());
+    HATN_BASE_NAMESPACE::ConfigTreeLoader loader;
+    HATN_BASE_NAMESPACE::ConfigTree configTree;
+    auto ec=loader.loadFromString(configTree,"{\"client\" : {\"multiplexing\" : true, \"max_multiplexed_requests\" : 8}}");
+    BOOST_REQUIRE(!ec);
+    HATN_BASE_NAMESPACE::config_object::LogRecords records;
+    ec=client->get<ClientType>().loadLogConfig(configTree,"client",records,HATN_BASE_NAMESPACE::config_object::LogSettings{});
+    BOOST_REQUIRE(!ec);
+    auto clientWithAuth=createClientWithAuth(client,session);
+    auto service2Client=makeShared<client::ServiceClient<ClientWithAuthCtxType,ClientWithAuthType>>("service2",clientWithAuth);
+
+    clientThread->start();
+
+    Service2Method3InFlight.store(0);
+    Service2Method3MaxInFlight.store(0);
+
+    std::atomic<size_t> responseCount{0};
+    std::atomic<size_t> mismatchCount{0};
+    std::vector<uint32_t> responseOrder;
+    auto invokeTasks=[service2Client,&responseCount,&mismatchCount,&responseOrder]()
+    {
+        for (uint32_t i=0;i<PipelinedRequestCount;i++)
+        {
+            auto cb=[&responseCount,&mismatchCount,&responseOrder,i](auto, const Error& ec, auto response)
+            {
+                BOOST_CHECK(!ec);
+                if (ec)
+                {
+                    return;
+                }
+
+                // response must belong to this request
+                service2_msg1::type msg;
+                auto ec1=response.parse(msg);
+                BOOST_CHECK(!ec1);
+                if (ec1 || msg.fieldValue(service2_msg1::field2)!=i)
+                {
+                    mismatchCount++;
+                }
+                responseOrder.push_back(i);
+                responseCount++;
+            };
+
+            auto ctx=makeLogCtx();
+            service2_msg1::type msg;
+            msg.setFieldValue(service2_msg1::field2,i);
+            msg.setFieldValue(service2_msg1::field1,"pipelined");
+            service2Client->exec(
+                ctx,
+                cb,
+                "service2_method3",
+                msg,
+                "topic1"
+            );
+        }
+    };
+
+    clientThread->execAsync(invokeTasks);
+
+    int secs=3;
+    BOOST_TEST_MESSAGE(fmt::format("Running test for {} seconds",secs));
+    exec(secs);
+
+    clientThread->stop();
+
+    // all requests completed, so reading of the connection was resumed after each pause at the limit
+    BOOST_CHECK_EQUAL(responseCount.load(),PipelinedRequestCount);
+
+    // responses are sent in order of completion and each one is correlated with own request
+    BOOST_CHECK_EQUAL(mismatchCount.load(),0);
+    BOOST_CHECK_EQUAL(responseOrder.size(),PipelinedRequestCount);
+    BOOST_CHECK(!std::is_sorted(responseOrder.begin(),responseOrder.end()));
+
+    // requests were processed in parallel not exceeding the in-flight limit
+    BOOST_TEST_MESSAGE(fmt::format("Max requests in flight: {}",Service2Method3MaxInFlight.load()));
+    BOOST_CHECK_GT(Service2Method3MaxInFlight.load(),1);
+    BOOST_CHECK_LE(Service2Method3MaxInFlight.load(),MaxPipelinedRequests);
+
+    for (auto&& it: serverCtx->microservices)
+    {
+        it.second->close();
+    }
+    exec(1);
+    serverCtx->app->close();
+
+    exec(1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
@@ -174,6 +174,11 @@ HDU_UNIT(thread_config,
     HDU_FIELD(min_count,TYPE_UINT8,2,false,1)
     HDU_FIELD(id_prefix,TYPE_STRING,3,false,"tg")
     HDU_REPEATED_FIELD(tags,TYPE_STRING,4)
+    // Threads steal queued tasks from each other, so a task can run in a sibling thread of the group.
+    // Allowed only for pure worker groups tagged with not_mapped and without app_default/network_default tags,
+    // because tasks bound to a thread (asio objects, mapped database threads, server connections) must run in own thread.
+    // Threads of such group must not be selected as server threads of microservices either.
+    HDU_FIELD(work_stealing,TYPE_BOOL,5)
 )
 
 HDU_UNIT(app_config,
@@ -557,10 +562,41 @@ Error App::initThreads()
     {
         const auto& threadConfig=threadConfigs.at(i);
         uint8_t groupCount=threadGroupCounts[i];
+
+        // work stealing is allowed only for groups of worker threads that have no thread affinity of tasks
+        bool workStealing=threadConfig.fieldValue(thread_config::work_stealing);
+        if (workStealing)
+        {
+            bool notMapped=false;
+            bool affine=false;
+            const auto& threadTags=threadConfig.field(thread_config::tags);
+            for (size_t j=0;j<threadTags.count();j++)
+            {
+                auto tag=std::string{threadTags.at(j)};
+                if (tag==ThreadTagNotMappedThread)
+                {
+                    notMapped=true;
+                }
+                else if (tag==ThreadTagAppThread || tag==ThreadTagNetworkThread)
+                {
+                    affine=true;
+                }
+            }
+            if (!notMapped || affine)
+            {
+                return chainAndLogError(appError(AppError::INVALID_THREAD_CONFIG),
+                                        fmt::format(fmt::runtime(_TR("work stealing is allowed only for not mapped worker threads, thread group {}","app")),
+                                                    threadConfig.fieldValue(thread_config::id_prefix))
+                                        );
+            }
+        }
+
+        std::vector<common::TaskWithContextThread*> groupThreads;
         for (size_t i=0;i<groupCount;i++)
         {
             threadName=fmt::format("{}{}",threadConfig.fieldValue(thread_config::id_prefix),i);
             auto thread=std::make_shared<common::TaskWithContextThread>(threadName);
+            groupThreads.push_back(thread.get());
             const auto& threadTags=threadConfig.field(thread_config::tags);
             for (size_t j=0;j<threadTags.count();j++)
             {
@@ -577,6 +613,28 @@ Error App::initThreads()
             }
 
             m_threads.push_back(thread);
+        }
+
+        // threads of the group steal tasks from each other
+        if (workStealing && groupThreads.size()>1)
+        {
+            for (auto&& thread: groupThreads)
+            {
+                std::vector<common::TaskWithContextThread*> siblings;
+                for (auto&& sibling: groupThreads)
+                {
+                    if (sibling!=thread)
+                    {
+                        siblings.push_back(sibling);
+                    }
+                }
+                thread->setStealingSiblings(std::move(siblings));
+            }
+        }
+
+        for (auto&& thread: groupThreads)
+        {
+            threadName=thread->id().c_str();
             thread->start();
 
             // create fallback log context for thread
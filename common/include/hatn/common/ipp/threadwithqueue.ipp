@@ -46,6 +46,10 @@ class ThreadWithQueueTraits_p
 
         ThreadQ<TaskT,ThreadWithQueueTraits>* threadQueueInterface;
 
+        std::vector<ThreadWithQueueTraits_p<TaskT>*> siblings;
+        std::atomic<bool> idle;
+        std::atomic<bool> consuming;
+
         ThreadWithQueueTraits_p(
                 ThreadWithQueueTraits<TaskT> *traits,
                 Queue<TaskT>* q
@@ -54,7 +58,9 @@ class ThreadWithQueueTraits_p
                 currentTask(nullptr),
                 currentItem(nullptr),
                 lockForAdd(0),
-                threadQueueInterface(nullptr)
+                threadQueueInterface(nullptr),
+                idle(true),
+                consuming(false)
         {
             if (queue==nullptr)
             {
@@ -72,10 +78,20 @@ class ThreadWithQueueTraits_p
 #if 0
             std::cout<<"Start queue loop, size="<<queue->size()<<std::endl;
 #endif
+            bool stealing=!siblings.empty();
+            if (stealing)
+            {
+                idle.store(false,std::memory_order_relaxed);
+            }
+
             int processedCount=0;
             while (!thread->isStopped())
             {
-                bool dequeued=queue->popValAndItem(currentTask,currentItem);
+                bool dequeued=popTask();
+                if (!dequeued && stealing)
+                {
+                    dequeued=stealTask();
+                }
                 if (dequeued)
                 {
                     (*currentTask)();
@@ -97,6 +113,12 @@ class ThreadWithQueueTraits_p
 #ifdef TEST_BOUNDARIES
                     std::cout<<"Breaking queue loop, queue size="<<queue->size()<<std::endl;
 #endif
+                    if (stealing)
+                    {
+                        // tasks posted to siblings after the last steal attempt are run by the siblings themselves
+                        // until the next post to a busy sibling wakes up this thread
+                        idle.store(true,std::memory_order_release);
+                    }
                     break;
                 }
 #ifdef TEST_BOUNDARIES
@@ -111,6 +133,76 @@ class ThreadWithQueueTraits_p
 #endif
             }
         }
+
+        //! Dequeue task from own queue
+        bool popTask() noexcept
+        {
+            if (siblings.empty())
+            {
+                return queue->popValAndItem(currentTask,currentItem);
+            }
+
+            // queue can be consumed by sibling threads, so consumers must be serialized
+            while (consuming.exchange(true,std::memory_order_acquire))
+            {
+            }
+            bool ok=queue->popValAndItem(currentTask,currentItem);
+            consuming.store(false,std::memory_order_release);
+            return ok;
+        }
+
+        //! Dequeue task from own queue on behalf of sibling thread, give up if the queue is being consumed by other thread
+        bool popTaskForSibling(TaskT*& task, QueueItem*& item) noexcept
+        {
+            if (queue->isEmpty() || consuming.exchange(true,std::memory_order_acquire))
+            {
+                return false;
+            }
+            bool ok=queue->popValAndItem(task,item);
+            consuming.store(false,std::memory_order_release);
+            return ok;
+        }
+
+        //! Steal task from queue of sibling thread starting with random victim
+        bool stealTask()
+        {
+            auto count=siblings.size();
+            auto first=static_cast<size_t>(Random::uniform(0,static_cast<uint32_t>(count-1)));
+            for (size_t i=0;i<count;i++)
+            {
+                auto victim=siblings[(first+i)%count];
+                if (victim->popTaskForSibling(currentTask,currentItem))
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        //! Wake up one idle sibling thread so that it could steal tasks from the queue of this thread
+        void wakeSibling()
+        {
+            auto count=siblings.size();
+            auto first=static_cast<size_t>(Random::uniform(0,static_cast<uint32_t>(count-1)));
+            for (size_t i=0;i<count;i++)
+            {
+                auto sibling=siblings[(first+i)%count];
+                bool expected=true;
+                if (sibling->idle.load(std::memory_order_relaxed)
+                    &&
+                    sibling->idle.compare_exchange_strong(expected,false,std::memory_order_acq_rel)
+                    )
+                {
+                    sibling->thread->execAsync(
+                        [sibling]()
+                        {
+                            sibling->taskLoop();
+                        }
+                    );
+                    return;
+                }
+            }
+        }
 };
 
 //---------------------------------------------------------------
@@ -159,6 +251,11 @@ void ThreadWithQueueTraits<TaskT>::doPost(
             }
         );
     }
+    else if (!d->siblings.empty())
+    {
+        // thread is busy with backlog, let idle sibling take part of it
+        d->wakeSibling();
+    }
 }
 
 //---------------------------------------------------------------
@@ -315,6 +412,19 @@ ThreadQ<TaskT,ThreadWithQueueTraits>* ThreadWithQueue<TaskT>::threadQueueInterfa
     return this->traits().d->threadQueueInterface;
 }
 
+//---------------------------------------------------------------
+template <typename TaskT>
+void ThreadWithQueue<TaskT>::setStealingSiblings(std::vector<ThreadWithQueue<TaskT>*> siblings)
+{
+    auto& d=this->traits().d;
+    d->siblings.clear();
+    d->siblings.reserve(siblings.size());
+    for (auto&& sibling:siblings)
+    {
+        d->siblings.push_back(sibling->traits().d.get());
+    }
+}
+
 namespace detail
 {
 template <typename TaskT>
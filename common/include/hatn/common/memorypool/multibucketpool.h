@@ -33,6 +33,7 @@
 
 #include <hatn/common/memorypool/pool.h>
 #include <hatn/common/memorypool/preallocatedbucket.h>
+#include <hatn/common/memorypool/threadmagazines.h>
 
 HATN_COMMON_NAMESPACE_BEGIN
 namespace memorypool {
@@ -52,7 +53,8 @@ class MultiBucketPoolTraits : public WithTraits<SyncInvoker>
         MultiBucketPoolTraits(
             Thread* thread,
             PoolT* pool,
-            size_t initialChunksPerBucket
+            size_t initialChunksPerBucket,
+            size_t threadCacheSize=0
         );
 
         ~MultiBucketPoolTraits();
@@ -80,6 +82,35 @@ class MultiBucketPoolTraits : public WithTraits<SyncInvoker>
         //! Deallocate block of raw data
         void deallocateRawBlock(RawBlock* rawBlock) noexcept;
 
+        /**
+         * @brief Allocate a batch of raw blocks for thread cache
+         * @param chunks Buffer for allocated blocks
+         * @param count Max number of blocks to allocate
+         * @return Number of allocated blocks, at least one
+         */
+        size_t allocateChunks(void** chunks, size_t count);
+
+        //! Deallocate a batch of raw blocks from thread cache
+        void deallocateChunks(void** chunks, size_t count) noexcept;
+
+        void setThreadCacheSize(size_t size) noexcept
+        {
+            m_threadCache.setCapacity(size);
+        }
+        size_t threadCacheSize() const noexcept
+        {
+            return m_threadCache.capacity();
+        }
+
+        void flushThreadCache()
+        {
+            m_threadCache.flush();
+        }
+        void flushThreadCaches() noexcept
+        {
+            m_threadCache.drain();
+        }
+
         void setGarbageCollectorEnabled(bool enable);
         bool isGarbageCollectorEnabled() const noexcept
         {
@@ -133,6 +164,8 @@ class MultiBucketPoolTraits : public WithTraits<SyncInvoker>
         typename SyncInvoker::SyncT::template Atomic<bool> m_freedBucketSinceLastGbCollecting;
 
         std::map<BucketT*,uint32_t> m_dropSchedule;
+
+        ThreadMagazines<MultiBucketPoolTraits> m_threadCache;
 };
 
 //! Pool with list of buckets of allocated memory
@@ -147,7 +180,7 @@ class MultiBucketPool : public WithThread,
             Thread* thread,
             const PoolConfig::Parameters& params
         ) noexcept : WithThread(thread),
-                     Pool<MultiBucketPoolTraits<SyncInvoker>>(params,thread,this,params.chunkCount),
+                     Pool<MultiBucketPoolTraits<SyncInvoker>>(params,thread,this,params.chunkCount,params.threadCacheSize),
                      m_dropBucketDelay(5)
         {
         }
@@ -181,6 +214,28 @@ class MultiBucketPool : public WithThread,
             this->traits().runGarbageCollector();
         }
 
+        /**
+         * @brief Set max number of chunks cached per thread
+         * @param size Cache size, 0 disables thread caches
+         *
+         * Thread caches let threads allocate and deallocate chunks without touching shared buckets.
+         * Chunks held in thread caches are counted as used.
+         */
+        inline void setThreadCacheSize(size_t size) noexcept
+        {
+            this->traits().setThreadCacheSize(size);
+        }
+        inline size_t threadCacheSize() const noexcept
+        {
+            return this->traits().threadCacheSize();
+        }
+
+        //! Return chunks cached by all threads back to the pool
+        inline void flushThreadCaches() noexcept
+        {
+            this->traits().flushThreadCaches();
+        }
+
         inline static size_t alignedChunkSize(size_t chunkSize) noexcept
         {
             return MultiBucketPoolTraits<SyncInvoker>::alignedChunkSize(chunkSize);
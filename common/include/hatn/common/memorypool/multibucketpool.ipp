@@ -33,7 +33,8 @@ template <typename SyncInvoker>
 MultiBucketPoolTraits<SyncInvoker>::MultiBucketPoolTraits(
         Thread* thread,
         PoolT* pool,
-        size_t initialChunksPerBucket
+        size_t initialChunksPerBucket,
+        size_t threadCacheSize
     )  : WithTraits<SyncInvoker>(thread),
          m_pool(pool),
          m_gbCollectTimer(makeShared<AsioDeadlineTimer>(thread)),
@@ -45,7 +46,8 @@ MultiBucketPoolTraits<SyncInvoker>::MultiBucketPoolTraits(
          m_garbageCollectorEnable(false),
          m_garbageCollectorPeriod(15000),
          m_createdBucketSinceLastGbCollecting(false),
-         m_freedBucketSinceLastGbCollecting(false)
+         m_freedBucketSinceLastGbCollecting(false),
+         m_threadCache(this,threadCacheSize)
 {
     m_gbCollectTimer->setSingleShot(false);
     setGarbageCollectorEnabled(true);
@@ -81,6 +83,9 @@ void MultiBucketPoolTraits<SyncInvoker>::doClear()
 {
     HATN_DEBUG_LVL(mempool,3,"clear begin");
 
+    // chunks held in thread caches belong to buckets that are deleted below
+    m_threadCache.drain(false);
+
     auto bucket=m_headBucket.load(std::memory_order_relaxed);
     while (bucket!=nullptr)
     {
@@ -404,6 +409,12 @@ void MultiBucketPoolTraits<SyncInvoker>::setGarbageCollectorEnabled(bool enable)
 template <typename SyncInvoker>
 RawBlock* MultiBucketPoolTraits<SyncInvoker>::allocateRawBlock()
 {
+    auto cached=m_threadCache.allocate();
+    if (cached!=nullptr)
+    {
+        return cached;
+    }
+
     BucketT* bucket=nullptr;
     void* chunk=allocateChunk(bucket);
     auto block=new(chunk) RawBlock();
@@ -415,6 +426,11 @@ RawBlock* MultiBucketPoolTraits<SyncInvoker>::allocateRawBlock()
 template <typename SyncInvoker>
 void MultiBucketPoolTraits<SyncInvoker>::deallocateRawBlock(RawBlock *rawBlock) noexcept
 {
+    if (m_threadCache.deallocate(rawBlock))
+    {
+        return;
+    }
+
     auto bucket=static_cast<BucketT*>(rawBlock->bucket());
     rawBlock->~RawBlock();
     bucket->deallocate(rawBlock);
@@ -425,6 +441,78 @@ void MultiBucketPoolTraits<SyncInvoker>::deallocateRawBlock(RawBlock *rawBlock)
     }
 }
 
+//---------------------------------------------------------------
+template <typename SyncInvoker>
+size_t MultiBucketPoolTraits<SyncInvoker>::allocateChunks(void** chunks, size_t count)
+{
+    size_t allocated=0;
+    auto each=[chunks,count,&allocated](BucketT* bucket)
+    {
+        auto bucketCount=bucket->allocateBatch(chunks+allocated,count-allocated);
+        for (size_t i=allocated;i<allocated+bucketCount;i++)
+        {
+            auto block=new(chunks[i]) RawBlock();
+            block->setBucket(bucket);
+        }
+        allocated+=bucketCount;
+        return allocated<count;
+    };
+    iterateBuckets(each);
+
+    if (allocated==0)
+    {
+        // all buckets are full, allocate in new bucket
+        BucketT* bucket=nullptr;
+        auto chunk=allocateChunkSync(bucket);
+        auto block=new(chunk) RawBlock();
+        block->setBucket(bucket);
+        chunks[0]=block;
+        allocated=1;
+
+        // fill the rest from the new bucket
+        iterateBuckets(each);
+    }
+    return allocated;
+}
+
+//---------------------------------------------------------------
+template <typename SyncInvoker>
+void MultiBucketPoolTraits<SyncInvoker>::deallocateChunks(void** chunks, size_t count) noexcept
+{
+    auto bucketOf=[](void* chunk)
+    {
+        return static_cast<BucketT*>(static_cast<RawBlock*>(chunk)->bucket());
+    };
+
+    // group chunks by buckets to deallocate them in batches
+    std::sort(chunks,chunks+count,
+        [&bucketOf](void* left, void* right)
+        {
+            return std::less<BucketT*>{}(bucketOf(left),bucketOf(right));
+        }
+    );
+    size_t first=0;
+    while (first<count)
+    {
+        auto bucket=bucketOf(chunks[first]);
+        size_t last=first+1;
+        while (last<count && bucketOf(chunks[last])==bucket)
+        {
+            ++last;
+        }
+        for (size_t i=first;i<last;i++)
+        {
+            static_cast<RawBlock*>(chunks[i])->~RawBlock();
+        }
+        bucket->deallocateBatch(chunks+first,last-first);
+        if (bucket->isEmpty())
+        {
+            m_freedBucketSinceLastGbCollecting.store(true,std::memory_order_release);
+        }
+        first=last;
+    }
+}
+
 //---------------------------------------------------------------
 template <typename SyncInvoker>
 void MultiBucketPoolTraits<SyncInvoker>::setGarbageCollectorPeriod(uint32_t milliseconds)
@@ -497,6 +585,7 @@ void MultiBucketPoolTraits<SyncInvoker>::getStats(Stats &stats) const noexcept
         stats.minBucketChunkCount=stats.maxBucketChunkCount;
     }
     stats.allocatedChunkCount+=m_scheduleDropChunkCount.load(std::memory_order_relaxed);
+    stats.cachedChunkCount=m_threadCache.cachedCount();
 }
 
 //---------------------------------------------------------------
@@ -511,6 +600,8 @@ size_t MultiBucketPoolTraits<SyncInvoker>::allocatedChunkSize() const noexcept
 template <typename SyncInvoker>
 void MultiBucketPoolTraits<SyncInvoker>::runGarbageCollector()
 {
+    // return cached chunks so that buckets can become empty
+    m_threadCache.drain();
     garbageCollectorSync(true);
 }
 
@@ -91,6 +91,10 @@ class NewDeletePoolTraits
         //! Get actual average allocated size per chunk
         inline size_t allocatedChunkSize() const noexcept;
 
+        //! Thread caches are not used by this pool
+        inline void flushThreadCache() noexcept
+        {}
+
         inline void clear()
         {
             if (m_chunkCount!=0)
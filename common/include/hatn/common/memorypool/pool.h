@@ -43,6 +43,9 @@ struct Stats
     size_t maxBucketUsedChunkCount;
     size_t minBucketUsedChunkCount;
 
+    //! Chunks held in thread caches, they are also counted in usedChunkCount
+    size_t cachedChunkCount;
+
     //! Ctor
     Stats(
         )  noexcept :
@@ -51,7 +54,8 @@ struct Stats
             maxBucketChunkCount(0),
             minBucketChunkCount(std::numeric_limits<size_t>::max()),
             maxBucketUsedChunkCount(0),
-            minBucketUsedChunkCount(std::numeric_limits<size_t>::max())
+            minBucketUsedChunkCount(std::numeric_limits<size_t>::max()),
+            cachedChunkCount(0)
     {
     }
 
@@ -64,6 +68,7 @@ struct Stats
         minBucketChunkCount=std::numeric_limits<size_t>::max();
         maxBucketUsedChunkCount=0;
         minBucketUsedChunkCount=std::numeric_limits<size_t>::max();
+        cachedChunkCount=0;
     }
 
     //! Clear statistics
@@ -75,6 +80,7 @@ struct Stats
         minBucketChunkCount=0;
         maxBucketUsedChunkCount=0;
         minBucketUsedChunkCount=0;
+        cachedChunkCount=0;
     }
 };
 
@@ -86,10 +92,14 @@ class PoolConfig
         //! Pool parameters
         struct Parameters
         {
-            Parameters(size_t chunkSize,size_t chunkCount=1024):chunkSize(chunkSize),chunkCount(chunkCount)
+            Parameters(size_t chunkSize,size_t chunkCount=1024,size_t threadCacheSize=0)
+                :chunkSize(chunkSize),chunkCount(chunkCount),threadCacheSize(threadCacheSize)
             {}
             size_t chunkSize;
             size_t chunkCount;
+
+            //! Max number of chunks cached per thread, 0 disables thread caches
+            size_t threadCacheSize;
         };
 
         PoolConfig(
@@ -247,6 +257,12 @@ class Pool : public WithTraits<Traits>,
             this->traits().deallocateRawBlock(rawBlock);
         }
 
+        //! Return chunks cached by current thread back to the pool
+        void flushThreadCache()
+        {
+            this->traits().flushThreadCache();
+        }
+
         //! Get buckets count
         size_t bucketsCount() const noexcept
         {
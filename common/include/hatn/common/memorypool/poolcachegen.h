@@ -62,6 +62,7 @@ class PoolCacheGen
             size_t minBlockSize=MemBlockSize::DEFAULT_MIN_BLOCK_SIZE,
             size_t maxBlockSize=MemBlockSize::DEFAULT_MAX_BLOCK_SIZE
         ) : m_bucketUsefulSize(bucketUsefulSize),
+            m_threadCacheSize(0),
             m_sizes(minBlockSize,maxBlockSize),
             m_poolCreator(&PoolCacheGen<PoolT>::defaultPoolCreator)
         {}
@@ -97,6 +98,37 @@ class PoolCacheGen
             return m_bucketUsefulSize;
         }
 
+        /**
+         * @brief Set max number of chunks cached per thread in generated pools
+         * @param size Cache size, 0 disables thread caches
+         */
+        inline void setThreadCacheSize(
+            size_t size
+        )
+        {
+            Assert(m_pools.empty()&&m_exactPools.empty(),"Size may be set only before any pools were generated!");
+            m_threadCacheSize=size;
+        }
+
+        inline size_t threadCacheSize() const noexcept
+        {
+            return m_threadCacheSize;
+        }
+
+        //! Return chunks cached by current thread back to generated pools
+        inline void flushThreadCache()
+        {
+            SharedLocker::SharedScope l(m_locker);
+            for (auto&& it:m_pools)
+            {
+                it.second->flushThreadCache();
+            }
+            for (auto&& it:m_exactPools)
+            {
+                it.second->flushThreadCache();
+            }
+        }
+
         //! Owned pools of range sizes
         inline const std::map<KeyRange,std::shared_ptr<PoolT>>& pools() const noexcept
         {
@@ -116,7 +148,7 @@ class PoolCacheGen
             {
                 chunkCount=1;
             }
-            return memorypool::PoolConfig::Parameters(objectSize,chunkCount);
+            return memorypool::PoolConfig::Parameters(objectSize,chunkCount,m_threadCacheSize);
         }
 
         const MemBlockSize& sizes() const
@@ -201,6 +233,7 @@ class PoolCacheGen
         static size_t DEFAULT_BUCKET_USEFUL_SIZE; // 256*1024;
 
         size_t m_bucketUsefulSize;
+        size_t m_threadCacheSize;
         mutable SharedLocker m_locker;
 
         std::map<KeyRange,std::shared_ptr<PoolT>> m_pools;
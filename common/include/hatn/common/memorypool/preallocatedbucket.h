@@ -59,6 +59,9 @@ class PreallocatedBucketTraits : public BucketTraitsBase<PreallocatedBucket<Pool
         void* allocate();
         void deallocate(void* chunk) noexcept;
 
+        size_t allocateBatch(void** chunks, size_t count);
+        void deallocateBatch(void** chunks, size_t count) noexcept;
+
         inline size_t freeCount() const noexcept
         {
             return m_freeCount.load(std::memory_order_relaxed);
@@ -86,6 +89,9 @@ class PreallocatedBucketTraits : public BucketTraitsBase<PreallocatedBucket<Pool
 
     private:
 
+        void* takeChunk();
+        void putChunk(size_t cursor, void* chunk) noexcept;
+
         typename SyncT::template Atomic<BucketT*> m_next;
 
         size_t m_chunkCount;
@@ -115,6 +121,18 @@ class PreallocatedBucket : public Bucket<PoolT,PreallocatedBucketTraits<PoolT,Sy
 
         void* allocate();
         void deallocate(void* chunk) noexcept;
+
+        /**
+         * @brief Allocate a batch of chunks
+         * @param chunks Buffer for allocated chunks
+         * @param count Max number of chunks to allocate
+         * @return Number of allocated chunks
+         */
+        size_t allocateBatch(void** chunks, size_t count);
+
+        //! Deallocate a batch of chunks under single lock
+        void deallocateBatch(void** chunks, size_t count) noexcept;
+
         size_t freeCount() const noexcept;
         bool isEmpty() const noexcept;
 
@@ -46,6 +46,10 @@ PreallocatedBucketTraits<PoolT,SyncT>::PreallocatedBucketTraits(
         m_data(new char[chunkCount*m_alignedChunkSize]),
         m_freeChunks(chunkCount)
 {
+    for (auto&& slot:m_freeChunks)
+    {
+        slot.store(nullptr,std::memory_order_relaxed);
+    }
 }
 
 //---------------------------------------------------------------
@@ -67,6 +71,13 @@ void* PreallocatedBucketTraits<PoolT,SyncT>::allocate()
         return nullptr;
     }
 
+    return takeChunk();
+}
+
+//---------------------------------------------------------------
+template <typename PoolT, typename SyncT>
+void* PreallocatedBucketTraits<PoolT,SyncT>::takeChunk()
+{
     auto cursor=m_firstReadCursor.fetch_add(1,std::memory_order_acq_rel);
     if (cursor<m_chunkCount)
     {
@@ -75,9 +86,51 @@ void* PreallocatedBucketTraits<PoolT,SyncT>::allocate()
     }
     m_firstReadCursor.fetch_sub(1,std::memory_order_relaxed);
 
-    // reuse chunk that was deallocated earlier
+    // reuse chunk that was deallocated earlier,
+    // slot is cleared so that writer can not overwrite it before it is read
     cursor=m_readCursor.fetch_add(1,std::memory_order_acq_rel)%m_chunkCount;
-    return SyncT::template atomic_load_explicit<void*>(&m_freeChunks[cursor],std::memory_order_consume);
+    void* chunk=nullptr;
+    while (chunk==nullptr)
+    {
+        chunk=m_freeChunks[cursor].exchange(nullptr,std::memory_order_acq_rel);
+    }
+    return chunk;
+}
+
+//---------------------------------------------------------------
+template <typename PoolT, typename SyncT>
+void PreallocatedBucketTraits<PoolT,SyncT>::putChunk(size_t cursor, void* chunk) noexcept
+{
+    // wait until slow reader takes previous chunk from the slot
+    auto& slot=m_freeChunks[cursor%m_chunkCount];
+    while (SyncT::template atomic_load_explicit<void*>(&slot,std::memory_order_acquire)!=nullptr)
+    {
+    }
+    SyncT::template atomic_store_explicit<void*>(&slot,chunk,std::memory_order_release);
+}
+
+//---------------------------------------------------------------
+template <typename PoolT, typename SyncT>
+size_t PreallocatedBucketTraits<PoolT,SyncT>::allocateBatch(void** chunks, size_t count)
+{
+    // reserve as many free chunks as possible
+    auto freeCount=m_freeCount.load(std::memory_order_acquire);
+    int reserved=0;
+    do
+    {
+        if (freeCount<=0)
+        {
+            return 0;
+        }
+        reserved=(std::min)(freeCount,static_cast<int>(count));
+    }
+    while (!m_freeCount.compare_exchange_weak(freeCount,freeCount-reserved,std::memory_order_acq_rel));
+
+    for (int i=0;i<reserved;i++)
+    {
+        chunks[i]=takeChunk();
+    }
+    return static_cast<size_t>(reserved);
 }
 
 //---------------------------------------------------------------
@@ -85,12 +138,26 @@ template <typename PoolT, typename SyncT>
 void PreallocatedBucketTraits<PoolT,SyncT>::deallocate(void *chunk) noexcept
 {
     m_deallocateLock.lock();
-    auto cursor=m_writeCursor.fetch_add(1,std::memory_order_acq_rel)%m_chunkCount;
-    SyncT::template atomic_store_explicit<void*>(&m_freeChunks[cursor],chunk,std::memory_order_relaxed);
+    auto cursor=m_writeCursor.fetch_add(1,std::memory_order_acq_rel);
+    putChunk(cursor,chunk);
     m_freeCount.fetch_add(1,std::memory_order_acq_rel);
     m_deallocateLock.unlock();
 }
 
+//---------------------------------------------------------------
+template <typename PoolT, typename SyncT>
+void PreallocatedBucketTraits<PoolT,SyncT>::deallocateBatch(void** chunks, size_t count) noexcept
+{
+    m_deallocateLock.lock();
+    auto cursor=m_writeCursor.fetch_add(count,std::memory_order_acq_rel);
+    for (size_t i=0;i<count;i++)
+    {
+        putChunk(cursor+i,chunks[i]);
+    }
+    m_freeCount.fetch_add(static_cast<int>(count),std::memory_order_acq_rel);
+    m_deallocateLock.unlock();
+}
+
 /********************** PreallocatedBucket **************************/
 
 //---------------------------------------------------------------
@@ -107,6 +174,20 @@ void PreallocatedBucket<PoolT,SyncT>::deallocate(void* chunk) noexcept
     this->traits().deallocate(chunk);
 }
 
+//---------------------------------------------------------------
+template <typename PoolT, typename SyncT>
+size_t PreallocatedBucket<PoolT,SyncT>::allocateBatch(void** chunks, size_t count)
+{
+    return this->traits().allocateBatch(chunks,count);
+}
+
+//---------------------------------------------------------------
+template <typename PoolT, typename SyncT>
+void PreallocatedBucket<PoolT,SyncT>::deallocateBatch(void** chunks, size_t count) noexcept
+{
+    this->traits().deallocateBatch(chunks,count);
+}
+
 //---------------------------------------------------------------
 template <typename PoolT, typename SyncT>
 size_t PreallocatedBucket<PoolT,SyncT>::freeCount() const noexcept
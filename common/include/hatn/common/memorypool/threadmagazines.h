@@ -0,0 +1,406 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/** @file common/memorypool/threadmagazines.h
+  *
+  *     Per-thread magazines of free chunks placed in front of shared memory pool
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNMEMORYPOOLTHREADMAGAZINES_H
+#define HATNMEMORYPOOLTHREADMAGAZINES_H
+
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+
+#include <hatn/common/common.h>
+#include <hatn/common/locker.h>
+
+#include <hatn/common/memorypool/rawblock.h>
+
+HATN_COMMON_NAMESPACE_BEGIN
+namespace memorypool {
+
+/**
+ * @brief Per-thread magazines of free chunks placed in front of shared memory pool.
+ *
+ * Each thread gets its own bounded magazine of chunks of the pool.
+ * Chunks are taken from and returned to the magazine of current thread without touching shared buckets of the pool.
+ * When magazine is empty it is refilled with a batch of chunks from the pool,
+ * when magazine is full then a half of it is flushed back to the pool as a batch.
+ *
+ * Chunks held in magazines are initialized raw blocks with bucket already set.
+ * Magazine of a thread is flushed back to the pool when the thread exits.
+ *
+ * OwnerT must implement the following methods:
+ *  - size_t allocateChunks(void** chunks, size_t count) - allocate at least one and at most count chunks;
+ *  - void deallocateChunks(void** chunks, size_t count) noexcept - deallocate chunks.
+ *
+ * Neither of them is called while the magazine is locked.
+ */
+template <typename OwnerT>
+class ThreadMagazines
+{
+    public:
+
+        //! Ctor
+        ThreadMagazines(
+            OwnerT* owner,
+            size_t capacity=0
+        ) : m_registry(std::make_shared<Registry>(owner)),
+            m_capacity(capacity)
+        {}
+
+        //! Dtor
+        ~ThreadMagazines()
+        {
+            drain(false,true);
+        }
+
+        ThreadMagazines(const ThreadMagazines&)=delete;
+        ThreadMagazines(ThreadMagazines&&) =delete;
+        ThreadMagazines& operator=(const ThreadMagazines&)=delete;
+        ThreadMagazines& operator=(ThreadMagazines&&) =delete;
+
+        /**
+         * @brief Set max number of chunks in magazine of each thread
+         * @param capacity Capacity, 0 disables magazines
+         *
+         * Magazines holding more chunks than new capacity are trimmed on their next use.
+         */
+        void setCapacity(size_t capacity) noexcept
+        {
+            m_capacity.store(capacity,std::memory_order_relaxed);
+        }
+
+        //! Get max number of chunks in magazine of each thread
+        size_t capacity() const noexcept
+        {
+            return m_capacity.load(std::memory_order_relaxed);
+        }
+
+        //! Check if magazines are enabled
+        bool isEnabled() const noexcept
+        {
+            return capacity()!=0;
+        }
+
+        /**
+         * @brief Allocate chunk from magazine of current thread
+         * @return Raw block or nullptr if magazines are disabled
+         */
+        RawBlock* allocate()
+        {
+            auto capacity=this->capacity();
+            if (capacity==0)
+            {
+                return nullptr;
+            }
+            auto magazine=threadMagazine(capacity);
+            if (magazine==nullptr)
+            {
+                return nullptr;
+            }
+
+            {
+                SpinScopedLock l(magazine->lock);
+                if (!magazine->chunks.empty())
+                {
+                    auto chunk=magazine->chunks.back();
+                    magazine->chunks.pop_back();
+                    return static_cast<RawBlock*>(chunk);
+                }
+            }
+
+            // refill magazine with a half of its capacity
+            auto& batch=magazine->batch;
+            batch.resize(batchSize(capacity));
+            auto count=m_registry->owner->allocateChunks(batch.data(),batch.size());
+            if (count>1)
+            {
+                SpinScopedLock l(magazine->lock);
+                magazine->chunks.insert(magazine->chunks.end(),batch.begin()+1,batch.begin()+count);
+            }
+            return static_cast<RawBlock*>(batch[0]);
+        }
+
+        /**
+         * @brief Deallocate chunk to magazine of current thread
+         * @param block Raw block
+         * @return False if magazines are disabled and block must be deallocated by caller
+         */
+        bool deallocate(RawBlock* block) noexcept
+        {
+            auto capacity=this->capacity();
+            if (capacity==0)
+            {
+                return false;
+            }
+            Magazine* magazine=nullptr;
+            try
+            {
+                magazine=threadMagazine(capacity);
+            }
+            catch (...)
+            {
+            }
+            if (magazine==nullptr)
+            {
+                return false;
+            }
+
+            auto& batch=magazine->batch;
+            batch.clear();
+            bool done=false;
+            {
+                SpinScopedLock l(magazine->lock);
+                auto& chunks=magazine->chunks;
+                try
+                {
+                    if (chunks.size()>=capacity)
+                    {
+                        // move a half of magazine to batch for flushing
+                        auto keep=capacity-batchSize(capacity);
+                        batch.assign(chunks.begin()+keep,chunks.end());
+                        chunks.resize(keep);
+                    }
+                    chunks.push_back(block);
+                    done=true;
+                }
+                catch (...)
+                {
+                }
+            }
+            if (!batch.empty())
+            {
+                m_registry->owner->deallocateChunks(batch.data(),batch.size());
+            }
+            return done;
+        }
+
+        //! Flush magazine of current thread back to the pool
+        void flush()
+        {
+            auto slots=threadSlots();
+            if (slots==nullptr)
+            {
+                return;
+            }
+            auto magazine=slots->find(m_registry.get());
+            if (magazine==nullptr)
+            {
+                return;
+            }
+
+            auto& batch=magazine->batch;
+            {
+                SpinScopedLock l(magazine->lock);
+                batch.assign(magazine->chunks.begin(),magazine->chunks.end());
+                magazine->chunks.clear();
+            }
+            if (!batch.empty())
+            {
+                m_registry->owner->deallocateChunks(batch.data(),batch.size());
+                batch.clear();
+            }
+        }
+
+        /**
+         * @brief Drain magazines of all threads
+         * @param returnChunks If true then chunks are returned to the pool, otherwise they are just forgotten
+         * @param detach Detach magazines from the pool so that they are not used any more
+         */
+        void drain(bool returnChunks=true, bool detach=false) noexcept
+        {
+            MutexScopedLock l(m_registry->mutex);
+            std::vector<void*> chunks;
+            for (auto&& magazine: m_registry->magazines)
+            {
+                {
+                    SpinScopedLock ml(magazine->lock);
+                    chunks.assign(magazine->chunks.begin(),magazine->chunks.end());
+                    magazine->chunks.clear();
+                }
+                if (returnChunks && !chunks.empty())
+                {
+                    m_registry->owner->deallocateChunks(chunks.data(),chunks.size());
+                }
+                chunks.clear();
+            }
+            if (detach)
+            {
+                m_registry->owner=nullptr;
+                m_registry->magazines.clear();
+            }
+        }
+
+        //! Get total number of chunks held in magazines of all threads
+        size_t cachedCount() const noexcept
+        {
+            size_t count=0;
+            MutexScopedLock l(m_registry->mutex);
+            for (auto&& magazine: m_registry->magazines)
+            {
+                SpinScopedLock ml(magazine->lock);
+                count+=magazine->chunks.size();
+            }
+            return count;
+        }
+
+    private:
+
+        struct Registry;
+
+        struct Magazine
+        {
+            Magazine(std::shared_ptr<Registry> registry) : registry(std::move(registry))
+            {}
+
+            SpinLock lock;
+            std::vector<void*> chunks;
+
+            // used only by owning thread for batch exchange with the pool
+            std::vector<void*> batch;
+
+            std::shared_ptr<Registry> registry;
+        };
+
+        struct Registry
+        {
+            Registry(OwnerT* owner) : owner(owner)
+            {}
+
+            MutexLock mutex;
+            OwnerT* owner;
+            std::vector<Magazine*> magazines;
+        };
+
+        struct ThreadSlots
+        {
+            ThreadSlots(bool* finalized) : finalized(finalized)
+            {}
+
+            ~ThreadSlots()
+            {
+                *finalized=true;
+                for (auto&& magazine: magazines)
+                {
+                    release(magazine.get());
+                }
+            }
+
+            ThreadSlots(const ThreadSlots&)=delete;
+            ThreadSlots(ThreadSlots&&) =delete;
+            ThreadSlots& operator=(const ThreadSlots&)=delete;
+            ThreadSlots& operator=(ThreadSlots&&) =delete;
+
+            Magazine* find(const Registry* registry) const noexcept
+            {
+                for (auto&& magazine: magazines)
+                {
+                    if (magazine->registry.get()==registry)
+                    {
+                        return magazine.get();
+                    }
+                }
+                return nullptr;
+            }
+
+            //! Return chunks of magazine to the pool if the pool is still alive
+            static void release(Magazine* magazine) noexcept
+            {
+                auto& registry=*magazine->registry;
+                MutexScopedLock l(registry.mutex);
+                if (registry.owner==nullptr)
+                {
+                    return;
+                }
+                if (!magazine->chunks.empty())
+                {
+                    registry.owner->deallocateChunks(magazine->chunks.data(),magazine->chunks.size());
+                    magazine->chunks.clear();
+                }
+                auto it=std::find(registry.magazines.begin(),registry.magazines.end(),magazine);
+                if (it!=registry.magazines.end())
+                {
+                    registry.magazines.erase(it);
+                }
+            }
+
+            //! Drop magazines of destroyed pools
+            void prune()
+            {
+                auto it=std::remove_if(magazines.begin(),magazines.end(),
+                    [](const std::shared_ptr<Magazine>& magazine)
+                    {
+                        MutexScopedLock l(magazine->registry->mutex);
+                        return magazine->registry->owner==nullptr;
+                    }
+                );
+                magazines.erase(it,magazines.end());
+            }
+
+            bool* finalized;
+            std::vector<std::shared_ptr<Magazine>> magazines;
+        };
+
+        static ThreadSlots* threadSlots()
+        {
+            // pool can be used by destructors of other thread-local objects after slots are destroyed
+            static thread_local bool finalized=false;
+            if (finalized)
+            {
+                return nullptr;
+            }
+            static thread_local ThreadSlots slots(&finalized);
+            return &slots;
+        }
+
+        static size_t batchSize(size_t capacity) noexcept
+        {
+            return (std::max)(capacity/2,static_cast<size_t>(1));
+        }
+
+        Magazine* threadMagazine(size_t capacity)
+        {
+            auto slots=threadSlots();
+            if (slots==nullptr)
+            {
+                return nullptr;
+            }
+            auto magazine=slots->find(m_registry.get());
+            if (magazine!=nullptr)
+            {
+                return magazine;
+            }
+
+            slots->prune();
+            auto newMagazine=std::make_shared<Magazine>(m_registry);
+            newMagazine->chunks.reserve(capacity+1);
+            newMagazine->batch.reserve(capacity);
+            slots->magazines.push_back(newMagazine);
+            {
+                MutexScopedLock l(m_registry->mutex);
+                m_registry->magazines.push_back(newMagazine.get());
+            }
+            return newMagazine.get();
+        }
+
+        std::shared_ptr<Registry> m_registry;
+        std::atomic<size_t> m_capacity;
+};
+
+//---------------------------------------------------------------
+        } // namespace memorypool
+HATN_COMMON_NAMESPACE_END
+#endif // HATNMEMORYPOOLTHREADMAGAZINES_H
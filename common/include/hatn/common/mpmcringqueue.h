@@ -0,0 +1,488 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/** @file common/mpmcringqueue.h
+  *
+  *     Bounded Multiple Producers Multiple Consumers ring queue.
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNMPMCRINGQUEUE_H
+#define HATNMPMCRINGQUEUE_H
+
+#include <chrono>
+#include <algorithm>
+#include <memory>
+
+#include <hatn/common/common.h>
+#include <hatn/common/locker.h>
+#include <hatn/common/queue.h>
+
+#ifdef max
+#undef max
+#endif
+
+#ifdef min
+#undef min
+#endif
+
+HATN_COMMON_NAMESPACE_BEGIN
+
+//! Multiple producers multiple consumers ring queue
+/**
+ * Lock-free bounded queue of D.Vyukov's design: each cell of the ring has a sequence number
+ * telling producers and consumers whether the cell is free or filled for their position.
+ * Positions of producers and consumers as well as cells are aligned to cache lines to avoid false sharing.
+ *
+ * Queue interface can not reject items, so when the ring is full the items are put to overflow list protected with mutex.
+ * While the overflow list is not empty producers append to the list too, consumers take items from the ring first.
+ * Thus, capacity of the ring should be selected for expected backlog of the queue.
+ */
+template <typename T>
+class MPMCRingQueue : public Queue<T>
+{
+    public:
+
+        using Item=typename Queue<T>::Item;
+
+        constexpr static const size_t CacheLineSize=64;
+        constexpr static const size_t DefaultCapacity=4096;
+
+        /**
+         * @brief Ctor
+         * @param capacity Capacity of the ring, rounded up to power of two
+         * @param memResource Allocator's memory resource
+         */
+        MPMCRingQueue(
+                size_t capacity=DefaultCapacity,
+                pmr::memory_resource* memResource=pmr::get_default_resource()
+            ) : Queue<T>(memResource),
+                m_capacity(roundCapacity(capacity)),
+                m_mask(m_capacity-1),
+                m_cells(std::make_unique<Cell[]>(m_capacity)),
+                m_overflowFirst(nullptr),
+                m_overflowLast(nullptr),
+                m_maxSize(0),
+                m_minSize(0),
+                m_maxDuration(0),
+                m_minDuration(0)
+        {
+            for (size_t i=0;i<m_capacity;i++)
+            {
+                m_cells[i].sequence.store(i,std::memory_order_relaxed);
+            }
+            m_pushPos.value.store(0,std::memory_order_relaxed);
+            m_popPos.value.store(0,std::memory_order_relaxed);
+            m_overflowSize.value.store(0,std::memory_order_relaxed);
+        }
+
+        explicit MPMCRingQueue(
+                pmr::memory_resource* memResource
+            ) : MPMCRingQueue(DefaultCapacity,memResource)
+        {}
+
+        //! Dtor
+        virtual ~MPMCRingQueue()
+        {
+            doClear();
+        }
+
+        MPMCRingQueue(const MPMCRingQueue&)=delete;
+        MPMCRingQueue(MPMCRingQueue&&) =delete;
+        MPMCRingQueue& operator=(const MPMCRingQueue&)=delete;
+        MPMCRingQueue& operator=(MPMCRingQueue&&) =delete;
+
+        //! Get capacity of the ring
+        size_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+
+        //! Push item to queue
+        virtual void pushInternalItem(Item* item) noexcept override final
+        {
+            doPush(&item,1);
+        }
+
+        /**
+         * @brief Push batch of prepared items to queue
+         * @param items Items
+         * @param count Number of items
+         *
+         * Positions in the ring are reserved for as many items of the batch as possible at once,
+         * so those items are not interleaved with items of other producers.
+         */
+        void pushItems(Item** items, size_t count) noexcept
+        {
+            if (this->isStatsEnabled())
+            {
+                auto now=std::chrono::high_resolution_clock::now();
+                for (size_t i=0;i<count;i++)
+                {
+                    items[i]->m_enqueuedTime=now;
+                }
+            }
+            doPush(items,count);
+        }
+
+        /**
+         * @brief Pop batch of items
+         * @param items Buffer for items
+         * @param maxCount Max number of items to pop
+         * @return Number of items
+         */
+        size_t popItems(Item** items, size_t maxCount) noexcept
+        {
+            auto count=popRingItems(items,maxCount);
+            while (count<maxCount)
+            {
+                auto item=popOverflow();
+                if (item==nullptr)
+                {
+                    break;
+                }
+                items[count++]=item;
+            }
+            if (count!=0 && this->isStatsEnabled())
+            {
+                updateSizeStats();
+                for (size_t i=0;i<count;i++)
+                {
+                    updateEnqueuedDurationStats(items[i]);
+                }
+            }
+            return count;
+        }
+
+        //! Dequeue item without destroying it
+        virtual Item* popItem() noexcept override final
+        {
+            Item* item=nullptr;
+            popItems(&item,1);
+            return item;
+        }
+
+        //! Get approximate size
+        virtual size_t size() const noexcept override final
+        {
+            return ringSize()+m_overflowSize.value.load(std::memory_order_relaxed);
+        }
+
+        //! Check if queue is empty
+        virtual bool isEmpty() const noexcept override final
+        {
+            return size()==0;
+        }
+
+        /**
+         * @brief Clear the queue
+         *
+         * If producers are still active then only approximately initial size of queue will be cleared.
+         */
+        virtual void clear() noexcept override final
+        {
+            doClear();
+        }
+
+        //! Read statistics
+        virtual void readStats(size_t& maxSize,size_t& minSize,int64_t& maxDuration,int64_t& minDuration) noexcept override final
+        {
+            maxSize=m_maxSize.load(std::memory_order_relaxed);
+            minSize=m_minSize.load(std::memory_order_relaxed);
+            maxDuration=m_maxDuration.load(std::memory_order_relaxed);
+            minDuration=m_minDuration.load(std::memory_order_relaxed);
+        }
+
+        //! Reset statistics
+        virtual void resetStats() noexcept override final
+        {
+            doResetStats();
+        }
+
+        //! Build queue of self type
+        virtual Queue<T>* buildQueue(pmr::memory_resource* memResource=nullptr) override
+        {
+            return new MPMCRingQueue<T>(m_capacity,memResource?memResource:this->allocator().resource());
+        }
+
+    private:
+
+        struct alignas(CacheLineSize) Cell
+        {
+            std::atomic<size_t> sequence;
+            Item* item=nullptr;
+        };
+
+        struct alignas(CacheLineSize) Position
+        {
+            std::atomic<size_t> value;
+        };
+
+        static size_t roundCapacity(size_t capacity) noexcept
+        {
+            size_t result=2;
+            while (result<capacity)
+            {
+                result<<=1;
+            }
+            return result;
+        }
+
+        size_t ringSize() const noexcept
+        {
+            auto popPos=m_popPos.value.load(std::memory_order_relaxed);
+            auto pushPos=m_pushPos.value.load(std::memory_order_relaxed);
+            return (pushPos>popPos)?(pushPos-popPos):0;
+        }
+
+        void doPush(Item** items, size_t count) noexcept
+        {
+            size_t pushed=0;
+            if (m_overflowSize.value.load(std::memory_order_acquire)==0)
+            {
+                pushed=pushRingItems(items,count);
+            }
+            for (size_t i=pushed;i<count;i++)
+            {
+                pushOverflow(items[i]);
+            }
+            if (this->isStatsEnabled())
+            {
+                updateSizeStats();
+            }
+        }
+
+        size_t pushRingItems(Item** items, size_t count) noexcept
+        {
+            auto pos=m_pushPos.value.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                // count free cells starting from current position
+                size_t n=0;
+                bool retry=false;
+                for (;n<count;n++)
+                {
+                    auto& cell=m_cells[(pos+n)&m_mask];
+                    auto seq=cell.sequence.load(std::memory_order_acquire);
+                    auto diff=static_cast<intptr_t>(seq)-static_cast<intptr_t>(pos+n);
+                    if (diff!=0)
+                    {
+                        // cell is either still occupied or already reserved by other producer
+                        retry=n==0 && diff>0;
+                        break;
+                    }
+                }
+                if (n==0)
+                {
+                    if (retry)
+                    {
+                        pos=m_pushPos.value.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    return 0;
+                }
+
+                // reserve cells
+                if (m_pushPos.value.compare_exchange_weak(pos,pos+n,std::memory_order_relaxed))
+                {
+                    for (size_t i=0;i<n;i++)
+                    {
+                        auto& cell=m_cells[(pos+i)&m_mask];
+                        cell.item=items[i];
+                        cell.sequence.store(pos+i+1,std::memory_order_release);
+                    }
+                    return n;
+                }
+            }
+        }
+
+        size_t popRingItems(Item** items, size_t maxCount) noexcept
+        {
+            auto pos=m_popPos.value.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                // count filled cells starting from current position
+                size_t n=0;
+                bool retry=false;
+                for (;n<maxCount;n++)
+                {
+                    auto& cell=m_cells[(pos+n)&m_mask];
+                    auto seq=cell.sequence.load(std::memory_order_acquire);
+                    auto diff=static_cast<intptr_t>(seq)-static_cast<intptr_t>(pos+n+1);
+                    if (diff!=0)
+                    {
+                        // cell is either not filled yet or already taken by other consumer
+                        retry=n==0 && diff>0;
+                        break;
+                    }
+                }
+                if (n==0)
+                {
+                    if (retry)
+                    {
+                        pos=m_popPos.value.load(std::memory_order_relaxed);
+                        continue;
+                    }
+                    return 0;
+                }
+
+                // take cells
+                if (m_popPos.value.compare_exchange_weak(pos,pos+n,std::memory_order_relaxed))
+                {
+                    for (size_t i=0;i<n;i++)
+                    {
+                        auto& cell=m_cells[(pos+i)&m_mask];
+                        items[i]=cell.item;
+                        cell.item=nullptr;
+                        cell.sequence.store(pos+i+m_capacity,std::memory_order_release);
+                    }
+                    return n;
+                }
+            }
+        }
+
+        void pushOverflow(Item* item) noexcept
+        {
+            item->m_next.store(nullptr,std::memory_order_relaxed);
+
+            MutexScopedLock l(m_overflowLock);
+            if (m_overflowLast!=nullptr)
+            {
+                m_overflowLast->m_next.store(item,std::memory_order_relaxed);
+            }
+            else
+            {
+                m_overflowFirst=item;
+            }
+            m_overflowLast=item;
+            m_overflowSize.value.fetch_add(1,std::memory_order_release);
+        }
+
+        Item* popOverflow() noexcept
+        {
+            if (m_overflowSize.value.load(std::memory_order_acquire)==0)
+            {
+                return nullptr;
+            }
+
+            MutexScopedLock l(m_overflowLock);
+            auto item=m_overflowFirst;
+            if (item!=nullptr)
+            {
+                m_overflowFirst=item->m_next.load(std::memory_order_relaxed);
+                if (m_overflowFirst==nullptr)
+                {
+                    m_overflowLast=nullptr;
+                }
+                m_overflowSize.value.fetch_sub(1,std::memory_order_release);
+            }
+            return item;
+        }
+
+        //! Reset statistics
+        inline void doResetStats() noexcept
+        {
+            m_maxDuration.store(0,std::memory_order_relaxed);
+            m_minDuration.store(0,std::memory_order_relaxed);
+            m_maxSize.store(0,std::memory_order_relaxed);
+            m_minSize.store(0,std::memory_order_relaxed);
+        }
+
+        inline void doClear() noexcept
+        {
+            constexpr static const size_t BatchSize=64;
+            Item* items[BatchSize];
+
+            auto maxCount=size()+16; // 16 is just because the size can be approximate rather than exact
+            size_t i=0;
+            while (i<maxCount)
+            {
+                auto count=popRingItems(items,BatchSize);
+                if (count==0)
+                {
+                    break;
+                }
+                for (size_t j=0;j<count;j++)
+                {
+                    items[j]->drop();
+                }
+                i+=count;
+            }
+
+            Item* first=nullptr;
+            {
+                MutexScopedLock l(m_overflowLock);
+                first=m_overflowFirst;
+                m_overflowFirst=nullptr;
+                m_overflowLast=nullptr;
+                m_overflowSize.value.store(0,std::memory_order_release);
+            }
+            while (first!=nullptr)
+            {
+                auto next=first->m_next.load(std::memory_order_relaxed);
+                first->drop();
+                first=next;
+            }
+
+            doResetStats();
+        }
+
+        inline void updateSizeStats() noexcept
+        {
+            // approximate statistics, so relaxed is ok
+
+            auto size=this->size();
+            auto minSize=m_minSize.load(std::memory_order_relaxed);
+            auto newMinSize=std::min(minSize,size);
+            m_minSize.compare_exchange_strong(minSize,newMinSize,std::memory_order_relaxed);
+
+            auto maxSize=m_maxSize.load(std::memory_order_relaxed);
+            auto newMaxSize=std::max(maxSize,size);
+            m_maxSize.compare_exchange_strong(maxSize,newMaxSize,std::memory_order_relaxed);
+        }
+
+        inline void updateEnqueuedDurationStats(Item* item) noexcept
+        {
+            // approximate statistics, so relaxed is ok
+
+            auto now=std::chrono::high_resolution_clock::now();
+            auto duration=static_cast<int64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now-item->m_enqueuedTime).count());
+
+            auto minDuration=m_minDuration.load(std::memory_order_relaxed);
+            auto newMinDuration=std::min(minDuration,duration);
+            m_minDuration.compare_exchange_strong(minDuration,newMinDuration,std::memory_order_relaxed);
+
+            auto maxDuration=m_maxDuration.load(std::memory_order_relaxed);
+            auto newMaxDuration=std::max(maxDuration,duration);
+            m_maxDuration.compare_exchange_strong(maxDuration,newMaxDuration,std::memory_order_relaxed);
+        }
+
+        const size_t m_capacity;
+        const size_t m_mask;
+        std::unique_ptr<Cell[]> m_cells;
+
+        Position m_pushPos;
+        Position m_popPos;
+
+        mutable MutexLock m_overflowLock;
+        Item* m_overflowFirst;
+        Item* m_overflowLast;
+        Position m_overflowSize;
+
+        std::atomic<size_t> m_maxSize;
+        std::atomic<size_t> m_minSize;
+        std::atomic<int64_t> m_maxDuration;
+        std::atomic<int64_t> m_minDuration;
+};
+
+//---------------------------------------------------------------
+HATN_COMMON_NAMESPACE_END
+#endif // HATNMPMCRINGQUEUE_H
@@ -101,13 +101,20 @@ class HATN_COMMON_EXPORT AllocatorFactory final
 
         /**
          * @brief Create factory using memory pools using default settings
+         * @param threadCacheSize Max number of chunks cached per thread in each pool, 0 disables thread caches
          * @return Allocator factory
+         *
+         * With thread caches the objects and data allocated and freed on worker threads
+         * mostly bypass shared buckets of the pools.
          */
         template <typename ObjectPoolT, typename DataPoolT>
-        static std::shared_ptr<AllocatorFactory> createFactoryWithPools()
+        static std::shared_ptr<AllocatorFactory> createFactoryWithPools(size_t threadCacheSize=0)
         {
-            auto objectMemoryResource=std::make_shared<PoolMemoryResource<ObjectPoolT>>();
+            auto objectPoolCacheGen=std::make_shared<memorypool::PoolCacheGen<ObjectPoolT>>();
+            objectPoolCacheGen->setThreadCacheSize(threadCacheSize);
+            auto objectMemoryResource=std::make_shared<PoolMemoryResource<ObjectPoolT>>(objectPoolCacheGen);
             auto dataPoolCacheGen=std::make_shared<memorypool::PoolCacheGen<DataPoolT>>();
+            dataPoolCacheGen->setThreadCacheSize(threadCacheSize);
             auto dataMemoryResource=std::make_shared<PoolMemoryResource<DataPoolT>>(dataPoolCacheGen);
 
             auto factory=std::make_shared<AllocatorFactory>(objectMemoryResource.get(),dataMemoryResource.get());
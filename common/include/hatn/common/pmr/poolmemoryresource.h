@@ -127,6 +127,25 @@ class PoolMemoryResource final : public memory_resource
             return m_poolOptions;
         }
 
+        /**
+         * @brief Return chunks cached by current thread back to the pools
+         *
+         * Call it before a thread stops using the resource for a long time,
+         * chunks cached by a thread are also returned when the thread exits.
+         */
+        void flushThreadCache()
+        {
+            auto poolPtr=m_poolPtr.load(std::memory_order_acquire);
+            if (poolPtr!=nullptr)
+            {
+                poolPtr->flushThreadCache();
+            }
+            if (m_poolOptions.poolCacheGen)
+            {
+                m_poolOptions.poolCacheGen->flushThreadCache();
+            }
+        }
+
         /**
          * @brief Deallocate block
          * @param p Pointer to underlying memory buffer
@@ -0,0 +1,731 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/** @file common/shardedcache.h
+  *
+  *     Sharded thread safe hash cache with CLOCK eviction and optional TTL
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNSHARDEDCACHE_H
+#define HATNSHARDEDCACHE_H
+
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include <hatn/common/thread.h>
+#include <hatn/common/locker.h>
+#include <hatn/common/asiotimer.h>
+
+HATN_COMMON_NAMESPACE_BEGIN
+
+//! Statistics of sharded cache
+struct ShardedCacheStats
+{
+    uint64_t hits=0;
+    uint64_t misses=0;
+    uint64_t insertions=0;
+    uint64_t evictions=0;
+    uint64_t expirations=0;
+
+    void add(const ShardedCacheStats& other) noexcept
+    {
+        hits+=other.hits;
+        misses+=other.misses;
+        insertions+=other.insertions;
+        evictions+=other.evictions;
+        expirations+=other.expirations;
+    }
+};
+
+/**
+ * @brief Thread safe cache split into shards with hash tables of open addressing.
+ *
+ * Each shard is guarded by its own mutex and holds a fixed number of entries, a shard is selected by hash of the key.
+ * Entries are found with linear probing in the index table of the shard that is never filled more than by a half.
+ * When the shard is full then an entry is displaced using CLOCK algorithm: each lookup marks the entry as referenced,
+ * and the clock hand skips and unmarks referenced entries until it finds an entry that was not referenced since the last pass.
+ *
+ * If TTL is not zero then entries expire after TTL elapsed since they were inserted or found last time.
+ * Expired entries are removed lazily when accessed or displaced,
+ * as well as by periodical sweeping in the thread of the cache after start() is called.
+ *
+ * Unlike CacheLru and CacheLruTtl all methods are thread safe and values are copied out of the cache,
+ * so that no references to the cache content are held outside of the lock of the shard.
+ * Use visit() to access a value in place.
+ *
+ * KeyT and ValueT must be default constructible and move assignable,
+ * default values are assigned to removed entries to release resources held by them.
+ */
+template <typename KeyT, typename ValueT, typename HashT=std::hash<KeyT>, typename KeyEqualT=std::equal_to<KeyT>>
+class ShardedCache
+{
+    public:
+
+        using Stats=ShardedCacheStats;
+
+        constexpr static const size_t MinShardCapacity=16;
+
+    private:
+
+        //! Current time in milliseconds that is read only when needed
+        struct Clock
+        {
+            uint64_t ms=0;
+
+            uint64_t now() noexcept
+            {
+                if (ms==0)
+                {
+                    ms=ShardedCache::nowMs();
+                }
+                return ms;
+            }
+
+            bool isExpired(uint64_t expireAtMs) noexcept
+            {
+                return expireAtMs!=0 && expireAtMs<=now();
+            }
+        };
+
+        struct Entry
+        {
+            KeyT key;
+            ValueT value;
+            uint64_t hash=0;
+            uint64_t expireAtMs=0;
+            bool occupied=false;
+            bool referenced=false;
+        };
+
+        struct Slot
+        {
+            // index of entry plus 1, 0 means empty slot
+            uint32_t index=0;
+            uint32_t tag=0;
+        };
+
+        struct Shard
+        {
+            Shard(size_t capacity) : entries(capacity),
+                                     slots(tableSize(capacity)),
+                                     slotMask(slots.size()-1),
+                                     count(0),
+                                     used(0),
+                                     hand(0)
+            {
+                freeEntries.reserve(capacity);
+            }
+
+            MutexLock mutex;
+            std::vector<Entry> entries;
+            std::vector<Slot> slots;
+            std::vector<uint32_t> freeEntries;
+            size_t slotMask;
+            size_t count;
+            size_t used;
+            size_t hand;
+            Stats stats;
+
+            static size_t tableSize(size_t capacity) noexcept
+            {
+                size_t size=1;
+                while (size<capacity*2)
+                {
+                    size<<=1;
+                }
+                return size;
+            }
+
+            static uint32_t tag(uint64_t hash) noexcept
+            {
+                return static_cast<uint32_t>(hash>>16);
+            }
+
+            Slot* findSlot(const KeyT& key, uint64_t hash, const KeyEqualT& keyEqual) noexcept
+            {
+                auto t=tag(hash);
+                for (size_t pos=hash&slotMask;;pos=(pos+1)&slotMask)
+                {
+                    auto& slot=slots[pos];
+                    if (slot.index==0)
+                    {
+                        return nullptr;
+                    }
+                    if (slot.tag==t && keyEqual(entries[slot.index-1].key,key))
+                    {
+                        return &slot;
+                    }
+                }
+            }
+
+            void insertSlot(uint32_t entryIndex, uint64_t hash) noexcept
+            {
+                for (size_t pos=hash&slotMask;;pos=(pos+1)&slotMask)
+                {
+                    auto& slot=slots[pos];
+                    if (slot.index==0)
+                    {
+                        slot.index=entryIndex+1;
+                        slot.tag=tag(hash);
+                        return;
+                    }
+                }
+            }
+
+            //! Remove slot shifting following slots of the same probe sequence backwards so that no tombstones are needed
+            void removeSlot(Slot* slot) noexcept
+            {
+                auto hole=static_cast<size_t>(slot-slots.data());
+                for (size_t pos=(hole+1)&slotMask;;pos=(pos+1)&slotMask)
+                {
+                    auto& next=slots[pos];
+                    if (next.index==0)
+                    {
+                        break;
+                    }
+                    auto home=entries[next.index-1].hash&slotMask;
+                    if (((pos-home)&slotMask) >= ((pos-hole)&slotMask))
+                    {
+                        slots[hole]=next;
+                        hole=pos;
+                    }
+                }
+                slots[hole]=Slot{};
+            }
+
+            void removeEntry(uint32_t entryIndex, Slot* slot)
+            {
+                removeSlot(slot);
+                auto& entry=entries[entryIndex];
+                entry.key=KeyT{};
+                entry.value=ValueT{};
+                entry.occupied=false;
+                entry.referenced=false;
+                freeEntries.push_back(entryIndex);
+                --count;
+            }
+
+            void removeEntry(uint32_t entryIndex)
+            {
+                const auto& entry=entries[entryIndex];
+                for (size_t pos=entry.hash&slotMask;;pos=(pos+1)&slotMask)
+                {
+                    auto& slot=slots[pos];
+                    if (slot.index==entryIndex+1)
+                    {
+                        removeEntry(entryIndex,&slot);
+                        return;
+                    }
+                    Assert(slot.index!=0,"Entry of sharded cache not found in index");
+                }
+            }
+
+            //! Find entry for displacement moving the clock hand
+            uint32_t displace(Clock& clock)
+            {
+                for (;;)
+                {
+                    auto index=static_cast<uint32_t>(hand);
+                    hand=(hand+1)%entries.size();
+
+                    auto& entry=entries[index];
+                    if (clock.isExpired(entry.expireAtMs))
+                    {
+                        ++stats.expirations;
+                        return index;
+                    }
+                    if (!entry.referenced)
+                    {
+                        ++stats.evictions;
+                        return index;
+                    }
+                    entry.referenced=false;
+                }
+            }
+
+            uint32_t allocateEntry(Clock& clock)
+            {
+                if (!freeEntries.empty())
+                {
+                    auto index=freeEntries.back();
+                    freeEntries.pop_back();
+                    return index;
+                }
+                if (used<entries.size())
+                {
+                    return static_cast<uint32_t>(used++);
+                }
+                auto index=displace(clock);
+                removeEntry(index);
+                freeEntries.pop_back();
+                return index;
+            }
+
+            size_t sweep(Clock& clock)
+            {
+                size_t removed=0;
+                for (size_t i=0;i<used;i++)
+                {
+                    auto& entry=entries[i];
+                    if (entry.occupied && clock.isExpired(entry.expireAtMs))
+                    {
+                        removeEntry(static_cast<uint32_t>(i));
+                        ++stats.expirations;
+                        ++removed;
+                    }
+                }
+                return removed;
+            }
+
+            void clear()
+            {
+                for (size_t i=0;i<used;i++)
+                {
+                    auto& entry=entries[i];
+                    entry.key=KeyT{};
+                    entry.value=ValueT{};
+                    entry.occupied=false;
+                    entry.referenced=false;
+                }
+                std::fill(slots.begin(),slots.end(),Slot{});
+                freeEntries.clear();
+                count=0;
+                used=0;
+                hand=0;
+            }
+        };
+
+        struct ShardedCache_p
+        {
+            ShardedCache_p(
+                    size_t capacity,
+                    uint64_t ttl,
+                    Thread* thread,
+                    size_t shardCount,
+                    const HashT& hasher,
+                    const KeyEqualT& keyEqual
+                ) : capacity(capacity),
+                    ttlMs(ttl),
+                    timer(thread),
+                    timerPeriodMs(1000),
+                    shardShift(0),
+                    hasher(hasher),
+                    keyEqual(keyEqual)
+            {
+                Assert(capacity!=0,"Capacity of sharded cache must not be zero");
+                Assert(capacity<=(std::numeric_limits<uint32_t>::max)(),"Capacity of sharded cache is too big");
+
+                if (shardCount==0)
+                {
+                    shardCount=(std::max)(std::thread::hardware_concurrency(),1u)*4;
+                }
+                shardCount=(std::min)(shardCount,(std::max)(capacity/MinShardCapacity,static_cast<size_t>(1)));
+                size_t shardBits=0;
+                while ((static_cast<size_t>(2)<<shardBits)<=shardCount)
+                {
+                    ++shardBits;
+                }
+                shardCount=static_cast<size_t>(1)<<shardBits;
+                shardShift=64-shardBits;
+
+                auto shardCapacity=(capacity+shardCount-1)/shardCount;
+                shards.reserve(shardCount);
+                for (size_t i=0;i<shardCount;i++)
+                {
+                    shards.emplace_back(std::make_unique<Shard>(shardCapacity));
+                }
+
+                timer.setSingleShot(false);
+                timer.setAutoAsyncGuardEnabled(false);
+            }
+
+            size_t capacity;
+            std::atomic<uint64_t> ttlMs;
+            AsioDeadlineTimer timer;
+            uint32_t timerPeriodMs;
+            size_t shardShift;
+            HashT hasher;
+            KeyEqualT keyEqual;
+            std::vector<std::unique_ptr<Shard>> shards;
+
+            //! Mix bits of hash so that both shard index and slot position are well distributed
+            uint64_t hash(const KeyT& key) const noexcept
+            {
+                auto h=static_cast<uint64_t>(hasher(key));
+                h^=h>>33;
+                h*=0xff51afd7ed558ccdULL;
+                h^=h>>33;
+                h*=0xc4ceb9fe1a85ec53ULL;
+                h^=h>>33;
+                return h;
+            }
+
+            Shard& shard(uint64_t hash) noexcept
+            {
+                if (shardShift==64)
+                {
+                    return *shards[0];
+                }
+                return *shards[static_cast<size_t>(hash>>shardShift)];
+            }
+
+            uint64_t expireAt(Clock& clock) const noexcept
+            {
+                auto ttl=ttlMs.load(std::memory_order_relaxed);
+                return ttl==0 ? 0 : clock.now()+ttl;
+            }
+
+            size_t sweep()
+            {
+                Clock clock;
+                size_t removed=0;
+                for (auto&& shard : shards)
+                {
+                    MutexScopedLock l{shard->mutex};
+                    removed+=shard->sweep(clock);
+                }
+                return removed;
+            }
+        };
+
+    public:
+
+        /**
+         * @brief Constructor
+         * @param capacity Max number of entries in the cache
+         * @param ttl Time to live in milliseconds, 0 means that entries never expire
+         * @param thread Thread where expired entries are swept periodically after start()
+         * @param shardCount Number of shards, rounded down to power of 2. If 0 then number of shards is selected by number of CPU cores.
+         * @param hasher Hash functor
+         * @param keyEqual Keys comparator
+         *
+         * Number of shards is limited so that each shard holds at least MinShardCapacity entries.
+         */
+        explicit ShardedCache(
+                size_t capacity,
+                uint64_t ttl=0,
+                Thread* thread=Thread::currentThreadOrMain(),
+                size_t shardCount=0,
+                const HashT& hasher=HashT{},
+                const KeyEqualT& keyEqual=KeyEqualT{}
+            ) : pimpl(std::make_shared<ShardedCache_p>(capacity,ttl,thread,shardCount,hasher,keyEqual))
+        {}
+
+        //! Destructor
+        ~ShardedCache()
+        {
+            stop();
+        }
+
+        ShardedCache(const ShardedCache&)=delete;
+        ShardedCache& operator=(const ShardedCache&)=delete;
+
+        ShardedCache(ShardedCache&&) =default;
+        ShardedCache& operator=(ShardedCache&&) =default;
+
+        /**
+         * @brief Start timer of sweeping expired entries.
+         * @param timerPeriodMs Period of timer invokation in milliseconds. If 0 then use previously set period or default.
+         *
+         * Defaut period is 1000ms.
+         */
+        void start(uint32_t timerPeriodMs=0)
+        {
+            if (timerPeriodMs!=0)
+            {
+                pimpl->timerPeriodMs=timerPeriodMs;
+            }
+            pimpl->timer.setPeriodUs(pimpl->timerPeriodMs*1000);
+            auto p=pimpl;
+            pimpl->timer.start(
+                [p](AsioDeadlineTimer::Status status)
+                {
+                    if (status!=AsioDeadlineTimer::Status::Timeout)
+                    {
+                        p->timer.reset();
+                        return;
+                    }
+                    if (p->ttlMs.load(std::memory_order_relaxed)!=0)
+                    {
+                        p->sweep();
+                    }
+                }
+            );
+        }
+
+        //! Stop timer of sweeping expired entries
+        void stop()
+        {
+            if (pimpl)
+            {
+                pimpl->timer.stop();
+            }
+        }
+
+        /**
+         * @brief Set TTL of entries.
+         * @param ttl New TTL in milliseconds, 0 means that entries never expire.
+         *
+         * New TTL will be applied only to new inserted or found entries.
+         */
+        void setTtl(uint64_t ttl) noexcept
+        {
+            pimpl->ttlMs.store(ttl,std::memory_order_relaxed);
+        }
+
+        //! Get TTL of entries
+        uint64_t ttl() const noexcept
+        {
+            return pimpl->ttlMs.load(std::memory_order_relaxed);
+        }
+
+        //! Get max number of entries in the cache
+        size_t capacity() const noexcept
+        {
+            return pimpl->capacity;
+        }
+
+        //! Get number of shards
+        size_t shardCount() const noexcept
+        {
+            return pimpl->shards.size();
+        }
+
+        //! Get current number of entries including expired entries that were not removed yet
+        size_t size() const noexcept
+        {
+            size_t count=0;
+            for (auto&& shard : pimpl->shards)
+            {
+                MutexScopedLock l{shard->mutex};
+                count+=shard->count;
+            }
+            return count;
+        }
+
+        //! Check if cache is empty
+        bool empty() const noexcept
+        {
+            return size()==0;
+        }
+
+        /**
+         * @brief Insert or replace value
+         * @param key Key
+         * @param value Value
+         * @return True if new entry was inserted, false if value of existing entry was replaced
+         *
+         * If the shard of the key is full then some entry of that shard is displaced.
+         */
+        template <typename T>
+        bool insert(const KeyT& key, T&& value)
+        {
+            auto hash=pimpl->hash(key);
+            Clock clock;
+            auto& shard=pimpl->shard(hash);
+
+            MutexScopedLock l{shard.mutex};
+            auto slot=shard.findSlot(key,hash,pimpl->keyEqual);
+            if (slot!=nullptr)
+            {
+                auto& entry=shard.entries[slot->index-1];
+                entry.value=std::forward<T>(value);
+                entry.expireAtMs=pimpl->expireAt(clock);
+                entry.referenced=true;
+                return false;
+            }
+
+            auto index=shard.allocateEntry(clock);
+            auto& entry=shard.entries[index];
+            entry.key=key;
+            entry.value=std::forward<T>(value);
+            entry.hash=hash;
+            entry.expireAtMs=pimpl->expireAt(clock);
+            entry.occupied=true;
+            entry.referenced=false;
+            shard.insertSlot(index,hash);
+            ++shard.count;
+            ++shard.stats.insertions;
+            return true;
+        }
+
+        /**
+         * @brief Find value and copy it
+         * @param key Key
+         * @param value Found value
+         * @return True if value was found
+         *
+         * Found entry is marked as referenced and its TTL is restarted.
+         */
+        bool find(const KeyT& key, ValueT& value)
+        {
+            return visit(key,
+                [&value](const ValueT& found)
+                {
+                    value=found;
+                }
+            );
+        }
+
+        /**
+         * @brief Find value and invoke handler with it
+         * @param key Key
+         * @param handler Handler with signature void(ValueT&), it is invoked while the shard is locked
+         * @return True if value was found
+         *
+         * Found entry is marked as referenced and its TTL is restarted.
+         * Handler must not access the cache.
+         */
+        template <typename HandlerT>
+        bool visit(const KeyT& key, HandlerT&& handler)
+        {
+            auto hash=pimpl->hash(key);
+            Clock clock;
+            auto& shard=pimpl->shard(hash);
+
+            MutexScopedLock l{shard.mutex};
+            auto slot=shard.findSlot(key,hash,pimpl->keyEqual);
+            if (slot==nullptr)
+            {
+                ++shard.stats.misses;
+                return false;
+            }
+
+            auto index=slot->index-1;
+            auto& entry=shard.entries[index];
+            if (clock.isExpired(entry.expireAtMs))
+            {
+                shard.removeEntry(index,slot);
+                ++shard.stats.expirations;
+                ++shard.stats.misses;
+                return false;
+            }
+
+            entry.referenced=true;
+            entry.expireAtMs=pimpl->expireAt(clock);
+            ++shard.stats.hits;
+            handler(entry.value);
+            return true;
+        }
+
+        /**
+         * @brief Check if cache contains not expired entry
+         * @param key Key
+         * @return Operation status
+         *
+         * Neither entry state nor statistics are updated.
+         */
+        bool contains(const KeyT& key) const
+        {
+            auto hash=pimpl->hash(key);
+            Clock clock;
+            auto& shard=pimpl->shard(hash);
+
+            MutexScopedLock l{shard.mutex};
+            auto slot=shard.findSlot(key,hash,pimpl->keyEqual);
+            if (slot==nullptr)
+            {
+                return false;
+            }
+            const auto& entry=shard.entries[slot->index-1];
+            return !clock.isExpired(entry.expireAtMs);
+        }
+
+        /**
+         * @brief Remove entry
+         * @param key Key
+         * @return True if entry was found and removed
+         */
+        bool remove(const KeyT& key)
+        {
+            auto hash=pimpl->hash(key);
+            auto& shard=pimpl->shard(hash);
+
+            MutexScopedLock l{shard.mutex};
+            auto slot=shard.findSlot(key,hash,pimpl->keyEqual);
+            if (slot==nullptr)
+            {
+                return false;
+            }
+            shard.removeEntry(slot->index-1,slot);
+            return true;
+        }
+
+        //! Remove all entries
+        void clear()
+        {
+            for (auto&& shard : pimpl->shards)
+            {
+                MutexScopedLock l{shard->mutex};
+                shard->clear();
+            }
+        }
+
+        /**
+         * @brief Remove expired entries
+         * @return Number of removed entries
+         *
+         * Called periodically in thread of the cache after start().
+         */
+        size_t sweep()
+        {
+            if (pimpl->ttlMs.load(std::memory_order_relaxed)==0)
+            {
+                return 0;
+            }
+            return pimpl->sweep();
+        }
+
+        //! Get statistics summed over all shards
+        Stats stats() const
+        {
+            Stats result;
+            for (auto&& shard : pimpl->shards)
+            {
+                MutexScopedLock l{shard->mutex};
+                result.add(shard->stats);
+            }
+            return result;
+        }
+
+        //! Reset statistics
+        void resetStats()
+        {
+            for (auto&& shard : pimpl->shards)
+            {
+                MutexScopedLock l{shard->mutex};
+                shard->stats=Stats{};
+            }
+        }
+
+        //! Get monotonic time in milliseconds used for expiration
+        static uint64_t nowMs() noexcept
+        {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()
+                ).count());
+        }
+
+    private:
+
+        std::shared_ptr<ShardedCache_p> pimpl;
+};
+
+//---------------------------------------------------------------
+HATN_COMMON_NAMESPACE_END
+#endif // HATNSHARDEDCACHE_H
@@ -95,6 +95,10 @@ template <typename ...Types> using variant=boost::variant2::variant<Types...>;
     {
         return boost::variant2::visit(std::forward<Visitor>(vis),std::forward<Variant>(var));
     }
+    template <std::size_t I, typename Variant>
+    using variant_alternative_t=boost::variant2::variant_alternative_t<I,Variant>;
+    template <typename Variant>
+    using variant_size=boost::variant2::variant_size<Variant>;
     template <typename T> using optional=boost::optional<T>;
 
     using monostate=boost::monostate;
@@ -120,6 +124,10 @@ template <typename ...Types> using variant=boost::variant2::variant<Types...>;
     {
         return std::visit(std::forward<Visitor>(vis),std::forward<Variant>(var));
     }
+    template <std::size_t I, typename Variant>
+    using variant_alternative_t=std::variant_alternative_t<I,Variant>;
+    template <typename Variant>
+    using variant_size=std::variant_size<Variant>;
     template <typename T> using optional=std::optional<T>;
     #define HATN_VARIANT_CPP17
 
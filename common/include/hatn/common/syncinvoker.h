@@ -67,6 +67,10 @@ struct SyncNo
             {
                 return std::exchange(m_val,m_val-val);
             }
+            T exchange(const T& val,std::memory_order =std::memory_order_seq_cst) noexcept
+            {
+                return std::exchange(m_val,val);
+            }
             bool compare_exchange_strong(T& checkDst,const T& newVal,std::memory_order=std::memory_order_seq_cst) noexcept
             {
                 if (m_val==checkDst)
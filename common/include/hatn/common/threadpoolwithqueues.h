@@ -103,6 +103,27 @@ class ThreadPoolWithQueues : public ThreadQ<TaskT,ThreadPoolWithQueuesTraits>
         ThreadPoolWithQueues& operator=(const ThreadPoolWithQueues&)=delete;
         ThreadPoolWithQueues& operator=(ThreadPoolWithQueues&&) noexcept;
 
+        /**
+         * @brief Enable or disable work stealing
+         * @param enable Flag
+         *
+         * With work stealing enabled a thread of the pool runs tasks from queues of other threads of the pool
+         * when its own queue is empty, and tasks posted from the pool's threads go to the queue of the posting thread.
+         * Consumers of each queue are serialized, so any queue type can be used.
+         * Order of tasks is not preserved, so use it only for independent tasks.
+         *
+         * A stolen task runs in other thread of the pool, so Thread::currentThread() and containsCurrentThread()
+         * do not refer to the thread the task was posted to. Use it only for pure worker pools whose tasks
+         * have no thread affinity, i.e. tasks must not use asio objects of a thread, thread-local state or
+         * callbacks bound to the thread they were posted to.
+         *
+         * Not thread safe, call it only in setup routines before starting threads.
+         */
+        void setWorkStealing(bool enable);
+
+        //! Check if work stealing is enabled
+        bool isWorkStealing() const noexcept;
+
         //! Get thread count
         size_t threadCount() const;
 
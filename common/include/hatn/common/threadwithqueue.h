@@ -18,6 +18,8 @@
 #ifndef HATNTHREADWITHQUEUE_H
 #define HATNTHREADWITHQUEUE_H
 
+#include <vector>
+
 #include <hatn/common/common.h>
 #include <hatn/common/stdwrappers.h>
 #include <hatn/common/threadq.h>
@@ -137,6 +139,16 @@ class ThreadWithQueue : public Thread, public ThreadQ<TaskT,ThreadWithQueueTrait
         //! Get thread queue interface if this thread is a part of thread pool
         ThreadQ<TaskT,ThreadWithQueueTraits>* threadQueueInterface() const noexcept;
 
+        /**
+         * @brief Set sibling threads to steal tasks from when own queue is empty
+         * @param siblings Threads whose queues can be consumed by this thread, empty vector disables stealing
+         *
+         * Stealing breaks the order of tasks posted to the same thread, so use it only for independent tasks.
+         * Stolen tasks run in sibling threads, so use it only for worker threads whose queued tasks have no thread affinity.
+         * Not thread safe, call it only in setup routines before running thread.
+         */
+        void setStealingSiblings(std::vector<ThreadWithQueue<TaskT>*> siblings);
+
         //! Get current thread interface
         static ThreadWithQueue<TaskT>* current() noexcept;
 
@@ -13,6 +13,7 @@
   */
 
 #include <hatn/common/flatmap.h>
+#include <hatn/common/random.h>
 #include <hatn/common/threadpoolwithqueues.h>
 #include <hatn/common/ipp/threadcategoriespool.ipp>
 
@@ -28,8 +29,39 @@ class ThreadPoolWithQueuesTraits_p
         FlatSet<ThreadWithQueue<TaskT>*> threads;
         int maxHandlersPerLoop=0;
         std::vector<std::shared_ptr<ThreadWithQueue<TaskT>>> threadStorage;
+        bool workStealing=false;
 
         ThreadWithQueue<TaskT>* selectThread()
+        {
+            if (workStealing)
+            {
+                // post from pool's thread to its own queue, idle siblings will steal the backlog
+                auto current=ThreadWithQueue<TaskT>::current();
+                if (current!=nullptr && threads.find(current)!=threads.end())
+                {
+                    return current;
+                }
+            }
+
+            auto count=threadStorage.size();
+            if (count<=2)
+            {
+                return leastLoaded();
+            }
+
+            // power of two choices: pick less loaded of two random threads instead of scanning all threads
+            auto first=Random::uniform(0,static_cast<uint32_t>(count-1));
+            auto second=Random::uniform(0,static_cast<uint32_t>(count-2));
+            if (second>=first)
+            {
+                ++second;
+            }
+            auto thread1=threadStorage[first].get();
+            auto thread2=threadStorage[second].get();
+            return (thread2->queueDepth()<thread1->queueDepth())?thread2:thread1;
+        }
+
+        ThreadWithQueue<TaskT>* leastLoaded()
         {
             ThreadWithQueue<TaskT>* thread=*threads.begin();
             size_t minDepth=std::numeric_limits<size_t>::max();
@@ -220,6 +252,39 @@ void ThreadPoolWithQueues<TaskT>::stop()
 
 //---------------------------------------------------------------
 
+template <typename TaskT>
+void ThreadPoolWithQueues<TaskT>::setWorkStealing(bool enable)
+{
+    auto& d=this->traits().d;
+    d->workStealing=enable;
+    for (auto&& thread:d->threadStorage)
+    {
+        std::vector<ThreadWithQueue<TaskT>*> siblings;
+        if (enable)
+        {
+            siblings.reserve(d->threadStorage.size());
+            for (auto&& sibling:d->threadStorage)
+            {
+                if (sibling!=thread)
+                {
+                    siblings.push_back(sibling.get());
+                }
+            }
+        }
+        thread->setStealingSiblings(std::move(siblings));
+    }
+}
+
+//---------------------------------------------------------------
+
+template <typename TaskT>
+bool ThreadPoolWithQueues<TaskT>::isWorkStealing() const noexcept
+{
+    return this->traits().d->workStealing;
+}
+
+//---------------------------------------------------------------
+
 template <typename TaskT>
 size_t ThreadPoolWithQueues<TaskT>::threadCount() const
 {
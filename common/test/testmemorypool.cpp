@@ -1,3 +1,6 @@
+#include <thread>
+#include <future>
+
 #include <boost/test/unit_test.hpp>
 
 #include <hatn/test/multithreadfixture.h>
@@ -665,7 +668,7 @@ struct ThreadContext
 }
 
 template <typename PoolT>
-static void checkParallelAllocateDeallocate(Env* env)
+static void checkParallelAllocateDeallocate(Env* env, size_t threadCacheSize=0)
 {
     const size_t chunkSize=ThreadContext::chunkSize;
     const size_t chunkCount=256;
@@ -681,6 +684,7 @@ static void checkParallelAllocateDeallocate(Env* env)
     pool.setDynamicBucketSizeEnabled(true);
     pool.setGarbageCollectorPeriod(1000);
     pool.setGarbageCollectorEnabled(true);
+    pool.setThreadCacheSize(threadCacheSize);
 
     for (size_t i=0;i<count*2;i++)
     {
@@ -859,6 +863,131 @@ BOOST_FIXTURE_TEST_CASE(CheckParallelAllocateDeallocateST,Env)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(CheckParallelAllocateDeallocateThreadCache,Env)
+{
+    BOOST_TEST_CONTEXT("Use other thread with thread cache")
+    {
+        checkParallelAllocateDeallocate<SynchronizedThreadPool>(this,64);
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(CheckThreadCache,Env)
+{
+    createThreads(1);
+
+    constexpr const size_t threadCacheSize=32;
+    constexpr const size_t count=100;
+    PoolConfig::Parameters params(64,256,threadCacheSize);
+    auto pool=std::make_shared<SynchronizedMutexPool>(thread(0).get(),params);
+    BOOST_CHECK_EQUAL(pool->threadCacheSize(),threadCacheSize);
+
+    // chunks are taken from buckets in batches of a half of cache size
+    std::vector<RawBlock*> blocks;
+    for (size_t i=0;i<count;i++)
+    {
+        blocks.push_back(pool->allocateRawBlock());
+    }
+    Stats stats;
+    pool->getStats(stats);
+    size_t batchSize=threadCacheSize/2;
+    size_t taken=((count+batchSize-1)/batchSize)*batchSize;
+    BOOST_CHECK_EQUAL(stats.usedChunkCount,taken);
+    BOOST_CHECK_EQUAL(stats.cachedChunkCount,taken-count);
+
+    // freed chunks stay in thread cache up to its size
+    for (auto&& block:blocks)
+    {
+        pool->deallocateRawBlock(block);
+    }
+    pool->getStats(stats);
+    BOOST_CHECK_LE(stats.cachedChunkCount,threadCacheSize);
+    BOOST_CHECK_EQUAL(stats.usedChunkCount,stats.cachedChunkCount);
+    BOOST_CHECK(!pool->isEmpty());
+
+    pool->flushThreadCache();
+    pool->getStats(stats);
+    BOOST_CHECK_EQUAL(stats.cachedChunkCount,0u);
+    BOOST_CHECK_EQUAL(stats.usedChunkCount,0u);
+    BOOST_CHECK(pool->isEmpty());
+
+    // thread cache is flushed when thread exits
+    std::thread worker(
+        [&]()
+        {
+            std::vector<RawBlock*> blocks;
+            for (size_t i=0;i<count;i++)
+            {
+                blocks.push_back(pool->allocateRawBlock());
+            }
+            for (auto&& block:blocks)
+            {
+                pool->deallocateRawBlock(block);
+            }
+        }
+    );
+    worker.join();
+    pool->getStats(stats);
+    BOOST_CHECK_EQUAL(stats.cachedChunkCount,0u);
+    BOOST_CHECK(pool->isEmpty());
+
+    // caches of all threads can be flushed at once
+    pool->deallocateRawBlock(pool->allocateRawBlock());
+    pool->getStats(stats);
+    BOOST_CHECK_EQUAL(stats.cachedChunkCount,batchSize);
+    pool->flushThreadCaches();
+    pool->getStats(stats);
+    BOOST_CHECK_EQUAL(stats.cachedChunkCount,0u);
+    BOOST_CHECK(pool->isEmpty());
+
+    // pool can be destroyed before threads that cache its chunks
+    std::promise<void> poolDestroyed;
+    std::promise<void> blockCached;
+    std::thread worker1(
+        [&]()
+        {
+            pool->deallocateRawBlock(pool->allocateRawBlock());
+            blockCached.set_value();
+            poolDestroyed.get_future().wait();
+        }
+    );
+    blockCached.get_future().wait();
+    pool->getStats(stats);
+    BOOST_CHECK_EQUAL(stats.cachedChunkCount,batchSize);
+    pool.reset();
+    poolDestroyed.set_value();
+    worker1.join();
+
+    // disabled thread cache
+    SynchronizedMutexPool pool1(thread(0).get(),PoolConfig::Parameters(64,256));
+    BOOST_CHECK_EQUAL(pool1.threadCacheSize(),0u);
+    pool1.deallocateRawBlock(pool1.allocateRawBlock());
+    BOOST_CHECK(pool1.isEmpty());
+}
+
+BOOST_FIXTURE_TEST_CASE(CheckThreadCacheResource,Env)
+{
+    auto cacheGen=std::make_shared<PoolCacheGen<SynchronizedMutexPool>>();
+    cacheGen->setThreadCacheSize(16);
+    PoolMemoryResource<SynchronizedMutexPool> resource(cacheGen);
+
+    std::vector<void*> buffers;
+    for (size_t i=0;i<100;i++)
+    {
+        buffers.push_back(resource.allocate(100));
+    }
+    for (auto&& buffer:buffers)
+    {
+        resource.deallocate(buffer,100);
+    }
+
+    auto pool=resource.pool();
+    BOOST_REQUIRE(pool);
+    BOOST_CHECK_EQUAL(pool->threadCacheSize(),16u);
+    BOOST_CHECK(!pool->isEmpty());
+    resource.flushThreadCache();
+    BOOST_CHECK(pool->isEmpty());
+}
+
 template <typename PoolT>
 static void checkParallelAllocateDeallocateGb(Env* env)
 {
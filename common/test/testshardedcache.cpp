@@ -0,0 +1,390 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/** @file common/test/testshardedcache.cpp
+  */
+
+/****************************************************************************/
+
+#include <thread>
+#include <random>
+#include <chrono>
+
+#include <boost/test/unit_test.hpp>
+
+#include <hatn/common/cachelru.h>
+#include <hatn/common/cachelruttl.h>
+#include <hatn/common/shardedcache.h>
+
+#include <hatn/test/multithreadfixture.h>
+
+HATN_USING
+HATN_COMMON_USING
+HATN_TEST_USING
+
+namespace {
+
+struct Item
+{
+    size_t id;
+
+    explicit Item(size_t id) : id(id)
+    {}
+};
+
+using CacheT=ShardedCache<size_t,size_t>;
+
+size_t keysCount(size_t capacity)
+{
+    return capacity*2;
+}
+
+//! Generate keys so that a half of them is hot and gets 90% of lookups
+std::vector<size_t> genKeys(size_t count, size_t capacity, unsigned int seed)
+{
+    std::mt19937 gen{seed};
+    std::uniform_int_distribution<size_t> hot(0,capacity/2);
+    std::uniform_int_distribution<size_t> cold(0,keysCount(capacity));
+    std::uniform_int_distribution<int> ratio(0,9);
+
+    std::vector<size_t> keys(count);
+    for (auto&& key : keys)
+    {
+        key=ratio(gen)==0 ? cold(gen) : hot(gen);
+    }
+    return keys;
+}
+
+int64_t elapsedMs(const std::chrono::steady_clock::time_point& start)
+{
+    auto elapsed=std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-start).count();
+    return elapsed==0 ? 1 : elapsed;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(TestShardedCache)
+
+BOOST_FIXTURE_TEST_CASE(ShardedCacheBasic,MultiThreadFixture)
+{
+    CacheT cache{CacheT::MinShardCapacity};
+    BOOST_CHECK_EQUAL(cache.shardCount(),1);
+    BOOST_CHECK_EQUAL(cache.capacity(),CacheT::MinShardCapacity);
+    BOOST_CHECK(cache.empty());
+
+    BOOST_CHECK(cache.insert(1,10));
+    BOOST_CHECK(cache.insert(2,20));
+    BOOST_CHECK(!cache.insert(2,21));
+    BOOST_CHECK_EQUAL(cache.size(),2);
+
+    size_t value=0;
+    BOOST_CHECK(cache.find(1,value));
+    BOOST_CHECK_EQUAL(value,10);
+    BOOST_CHECK(cache.find(2,value));
+    BOOST_CHECK_EQUAL(value,21);
+    BOOST_CHECK(!cache.find(3,value));
+    BOOST_CHECK(cache.contains(1));
+    BOOST_CHECK(!cache.contains(3));
+
+    BOOST_CHECK(cache.visit(1,[](size_t& val){val=11;}));
+    BOOST_CHECK(cache.find(1,value));
+    BOOST_CHECK_EQUAL(value,11);
+
+    BOOST_CHECK(cache.remove(1));
+    BOOST_CHECK(!cache.remove(1));
+    BOOST_CHECK(!cache.contains(1));
+    BOOST_CHECK(cache.contains(2));
+    BOOST_CHECK_EQUAL(cache.size(),1);
+
+    auto stats=cache.stats();
+    BOOST_CHECK_EQUAL(stats.hits,4);
+    BOOST_CHECK_EQUAL(stats.misses,1);
+    BOOST_CHECK_EQUAL(stats.insertions,2);
+    BOOST_CHECK_EQUAL(stats.evictions,0);
+
+    cache.clear();
+    BOOST_CHECK(cache.empty());
+    BOOST_CHECK(!cache.contains(2));
+
+    // fill the cache and reference a half of entries
+    size_t capacity=cache.capacity();
+    for (size_t i=0;i<capacity;i++)
+    {
+        BOOST_CHECK(cache.insert(i,i*10));
+    }
+    BOOST_CHECK_EQUAL(cache.size(),capacity);
+    for (size_t i=0;i<capacity;i+=2)
+    {
+        BOOST_CHECK(cache.find(i,value));
+    }
+
+    // not referenced entries must be displaced first
+    for (size_t i=capacity;i<capacity+capacity/2;i++)
+    {
+        BOOST_CHECK(cache.insert(i,i*10));
+        BOOST_CHECK_EQUAL(cache.size(),capacity);
+    }
+    for (size_t i=0;i<capacity;i++)
+    {
+        BOOST_CHECK_EQUAL(cache.contains(i),i%2==0);
+    }
+    for (size_t i=capacity;i<capacity+capacity/2;i++)
+    {
+        BOOST_REQUIRE(cache.find(i,value));
+        BOOST_CHECK_EQUAL(value,i*10);
+    }
+    BOOST_CHECK_EQUAL(cache.stats().evictions,capacity/2);
+
+    // remove entries that were moved in probe sequences and check that the rest is still found
+    for (size_t i=0;i<capacity;i+=4)
+    {
+        BOOST_CHECK(cache.remove(i));
+    }
+    for (size_t i=2;i<capacity;i+=4)
+    {
+        BOOST_REQUIRE(cache.find(i,value));
+        BOOST_CHECK_EQUAL(value,i*10);
+    }
+    for (size_t i=capacity;i<capacity+capacity/2;i++)
+    {
+        BOOST_CHECK(cache.contains(i));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(ShardedCacheTtl,MultiThreadFixture)
+{
+    createThreads(1);
+    auto thread1=thread(0);
+    thread1->start();
+
+    uint64_t ttl=300;
+    CacheT cache{256,ttl,thread1.get(),4};
+    BOOST_CHECK_EQUAL(cache.shardCount(),4);
+    BOOST_CHECK_EQUAL(cache.ttl(),ttl);
+
+    // lazy expiration
+    cache.insert(1,10);
+    cache.insert(2,20);
+    exec(1);
+    BOOST_CHECK(!cache.contains(1));
+    BOOST_CHECK_EQUAL(cache.size(),2);
+    size_t value=0;
+    BOOST_CHECK(!cache.find(1,value));
+    BOOST_CHECK_EQUAL(cache.size(),1);
+    BOOST_CHECK_EQUAL(cache.sweep(),1);
+    BOOST_CHECK(cache.empty());
+    BOOST_CHECK_EQUAL(cache.stats().expirations,2);
+
+    // lookups restart TTL
+    cache.insert(3,30);
+    for (size_t i=0;i<5;i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        BOOST_CHECK(cache.find(3,value));
+    }
+
+    // background sweeping
+    cache.start(50);
+    cache.insert(4,40);
+    cache.insert(5,50);
+    exec(1);
+    BOOST_CHECK(cache.empty());
+    cache.stop();
+
+    // zero TTL disables expiration
+    cache.setTtl(0);
+    cache.insert(6,60);
+    exec(1);
+    BOOST_CHECK(cache.find(6,value));
+    BOOST_CHECK_EQUAL(value,60);
+
+    thread1->stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(ShardedCacheParallel,MultiThreadFixture)
+{
+    size_t capacity=4096;
+    CacheT cache{capacity};
+    BOOST_TEST_MESSAGE(fmt::format("Shards count {}",cache.shardCount()));
+
+    size_t threadCount=(std::max)(std::thread::hardware_concurrency(),4u);
+    size_t count=100000;
+    std::atomic<size_t> mismatches{0};
+
+    std::vector<std::thread> workers;
+    for (size_t j=0;j<threadCount;j++)
+    {
+        workers.emplace_back(
+            [&,j]()
+            {
+                auto keys=genKeys(count,capacity,static_cast<unsigned int>(j+1));
+                size_t value=0;
+                for (auto&& key : keys)
+                {
+                    if (cache.find(key,value))
+                    {
+                        if (value!=key*3)
+                        {
+                            ++mismatches;
+                        }
+                        if (key%7==0)
+                        {
+                            cache.remove(key);
+                        }
+                    }
+                    else
+                    {
+                        cache.insert(key,key*3);
+                    }
+                }
+            }
+        );
+    }
+    for (auto&& worker : workers)
+    {
+        worker.join();
+    }
+
+    BOOST_CHECK_EQUAL(mismatches.load(),0);
+    BOOST_CHECK(cache.size()<=capacity);
+    auto stats=cache.stats();
+    BOOST_CHECK_EQUAL(stats.hits+stats.misses,threadCount*count);
+    BOOST_TEST_MESSAGE(fmt::format("Hits {}, misses {}, insertions {}, evictions {}, size {}",
+                                   stats.hits,stats.misses,stats.insertions,stats.evictions,cache.size()));
+}
+
+BOOST_FIXTURE_TEST_CASE(ShardedCacheBenchmark,MultiThreadFixture, * boost::unit_test::disabled())
+{
+#if defined(BUILD_VALGRIND)
+    size_t count=10000;
+#else
+    #if defined(BUILD_DEBUG)
+        size_t count=100000;
+    #else
+        size_t count=1000000;
+    #endif
+#endif
+    size_t capacity=16384;
+    size_t threadCount=(std::max)(std::thread::hardware_concurrency(),4u);
+    auto keys=genKeys(count,capacity,1);
+    std::vector<std::vector<size_t>> threadKeys;
+    for (size_t j=0;j<threadCount;j++)
+    {
+        threadKeys.emplace_back(genKeys(count,capacity,static_cast<unsigned int>(j+1)));
+    }
+
+    // single thread, map based LRU cache without locking
+    {
+        CacheLru<size_t,Item> cache{capacity};
+        size_t hits=0;
+        auto start=std::chrono::steady_clock::now();
+        for (auto&& key : keys)
+        {
+            auto* item=cache.item(key);
+            if (item!=nullptr)
+            {
+                cache.touchItem(*item);
+                ++hits;
+            }
+            else
+            {
+                cache.emplaceItem(key,key);
+            }
+        }
+        auto elapsed=elapsedMs(start);
+        BOOST_TEST_MESSAGE(fmt::format("CacheLru, 1 thread: {} lookups took {} ms, {} lookups/s, hit ratio {}%",
+                                       count,elapsed,count*1000/elapsed,hits*100/count));
+    }
+
+    // single thread, sharded cache
+    {
+        CacheT cache{capacity};
+        auto start=std::chrono::steady_clock::now();
+        size_t value=0;
+        for (auto&& key : keys)
+        {
+            if (!cache.find(key,value))
+            {
+                cache.insert(key,key);
+            }
+        }
+        auto elapsed=elapsedMs(start);
+        auto stats=cache.stats();
+        BOOST_CHECK(cache.size()<=capacity);
+        BOOST_TEST_MESSAGE(fmt::format("ShardedCache, 1 thread: {} lookups took {} ms, {} lookups/s, hit ratio {}%",
+                                       count,elapsed,count*1000/elapsed,stats.hits*100/count));
+    }
+
+    // multiple threads, map based LRU cache with TTL guarded by its mutex
+    {
+        CacheLruTtl<size_t,Item> cache{60000,capacity};
+        std::vector<std::thread> workers;
+        auto start=std::chrono::steady_clock::now();
+        for (size_t j=0;j<threadCount;j++)
+        {
+            workers.emplace_back(
+                [&,j]()
+                {
+                    const auto& keys=threadKeys[j];
+                    for (auto&& key : keys)
+                    {
+                        cache.lock();
+                        if (cache.getAndTouch(key)==nullptr)
+                        {
+                            cache.emplaceItem(key,key);
+                        }
+                        cache.unlock();
+                    }
+                }
+            );
+        }
+        for (auto&& worker : workers)
+        {
+            worker.join();
+        }
+        auto elapsed=elapsedMs(start);
+        BOOST_TEST_MESSAGE(fmt::format("CacheLruTtl, {} threads: {} lookups took {} ms, {} lookups/s",
+                                       threadCount,count*threadCount,elapsed,count*threadCount*1000/elapsed));
+    }
+
+    // multiple threads, sharded cache with TTL
+    {
+        CacheT cache{capacity,60000};
+        std::vector<std::thread> workers;
+        auto start=std::chrono::steady_clock::now();
+        for (size_t j=0;j<threadCount;j++)
+        {
+            workers.emplace_back(
+                [&,j]()
+                {
+                    const auto& keys=threadKeys[j];
+                    size_t value=0;
+                    for (auto&& key : keys)
+                    {
+                        if (!cache.find(key,value))
+                        {
+                            cache.insert(key,key);
+                        }
+                    }
+                }
+            );
+        }
+        for (auto&& worker : workers)
+        {
+            worker.join();
+        }
+        auto elapsed=elapsedMs(start);
+        auto stats=cache.stats();
+        BOOST_CHECK(cache.size()<=capacity);
+        BOOST_TEST_MESSAGE(fmt::format("ShardedCache, {} threads: {} lookups took {} ms, {} lookups/s, hit ratio {}%",
+                                       threadCount,count*threadCount,elapsed,count*threadCount*1000/elapsed,stats.hits*100/(count*threadCount)));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
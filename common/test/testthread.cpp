@@ -1,5 +1,7 @@
 #include <iostream>
 #include <chrono>
+#include <thread>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -15,6 +17,7 @@
 
 #include <hatn/common/mutexqueue.h>
 #include <hatn/common/mpscqueue.h>
+#include <hatn/common/mpmcringqueue.h>
 #include <hatn/common/asiotimer.h>
 
 #include <hatn/test/multithreadfixture.h>
@@ -189,6 +192,12 @@ BOOST_FIXTURE_TEST_CASE(SimpleMpscQueue,MultiThreadFixture)
     testSimpleQueue(queue,this);
 }
 
+BOOST_FIXTURE_TEST_CASE(SimpleMpmcRingQueue,MultiThreadFixture)
+{
+    auto queue=new MPMCRingQueue<Task>(4);
+    testSimpleQueue(queue,this);
+}
+
 void testContextQueue(TaskWithContextQueue* queue, MultiThreadFixture* testFxt, const MemResourceConfig& config)
 {
     int counter=0;
@@ -261,6 +270,15 @@ BOOST_FIXTURE_TEST_CASE(ContextMpscQueue,MultiThreadFixture)
     testContextQueue(queue,this,config);
 }
 
+BOOST_FIXTURE_TEST_CASE(ContextMpmcRingQueue,MultiThreadFixture)
+{
+    MemResourceConfig config(poolCacheGen<MemoryPool>());
+    auto resource=makeResource(config);
+
+    auto queue=new MPMCRingQueue<TaskWithContext>(resource.get());
+    testContextQueue(queue,this,config);
+}
+
 void testClearQueue(TaskQueue* queue,
                    int count)
 {
@@ -310,6 +328,18 @@ BOOST_FIXTURE_TEST_CASE(ClearQueueMPSC,MultiThreadFixture)
     testClearQueue(queue,count);
 }
 
+BOOST_FIXTURE_TEST_CASE(ClearQueueMPMCRing,MultiThreadFixture)
+{
+#ifdef BUILD_VALGRIND
+    int count=10;
+#else
+    int count=1000;
+#endif
+    // part of items goes to overflow list
+    auto queue=new MPMCRingQueue<Task>(256);
+    testClearQueue(queue,count);
+}
+
 void testQueueLoad(TaskQueue* queue,
                    int count,
                    int delay,
@@ -542,6 +572,25 @@ BOOST_FIXTURE_TEST_CASE(MpscQueueLoad,MultiThreadFixture)
     auto queue=new MPSCQueue<Task>();
     testQueueLoad(queue,count,15,this);
 }
+BOOST_FIXTURE_TEST_CASE(MpmcRingQueueLoad,MultiThreadFixture)
+{
+#ifdef BUILD_VALGRIND
+    int count=20;
+#else
+    #if defined (BUILD_ANDROID)
+        int count=200000;
+    #else
+        #if defined(BUILD_DEBUG) || (defined(_WIN32) && !defined(_WIN64))
+            int count=100000;
+        #else
+            int count=10000000;
+        #endif
+    #endif
+#endif
+
+    auto queue=new MPMCRingQueue<Task>(65536);
+    testQueueLoad(queue,count,30,this);
+}
 
 void testQueueBoundaries(TaskQueue* queue,
                    MultiThreadFixture* testFxt,
@@ -750,6 +799,165 @@ BOOST_FIXTURE_TEST_CASE(MpscQueueBoundaries,MultiThreadFixture)
     auto queue=new MPSCQueue<Task>();
     testQueueBoundaries(queue,this,70);
 }
+BOOST_FIXTURE_TEST_CASE(MpmcRingQueueBoundaries,MultiThreadFixture)
+{
+    auto queue=new MPMCRingQueue<Task>(64);
+    testQueueBoundaries(queue,this,70);
+}
+
+BOOST_AUTO_TEST_CASE(MpmcRingQueueBatch)
+{
+    MPMCRingQueue<int> queue(4);
+    BOOST_CHECK_EQUAL(queue.capacity(),4);
+    BOOST_CHECK(queue.isEmpty());
+
+    queue.setStatsEnabled(true);
+
+    std::vector<MPMCRingQueue<int>::Item*> items;
+    for (int i=0;i<6;i++)
+    {
+        items.push_back(queue.prepare(i));
+    }
+
+    // 4 items go to the ring and 2 items go to overflow list
+    queue.pushItems(items.data(),items.size());
+    BOOST_CHECK_EQUAL(queue.size(),6);
+    queue.push(6);
+    BOOST_CHECK_EQUAL(queue.size(),7);
+
+    std::vector<MPMCRingQueue<int>::Item*> popped(8,nullptr);
+    auto count=queue.popItems(popped.data(),3);
+    BOOST_REQUIRE_EQUAL(count,3);
+    for (size_t i=0;i<count;i++)
+    {
+        BOOST_CHECK_EQUAL(popped[i]->m_val,static_cast<int>(i));
+        queue.freeItem(popped[i]);
+    }
+
+    count=queue.popItems(popped.data(),popped.size());
+    BOOST_REQUIRE_EQUAL(count,4);
+    for (size_t i=0;i<count;i++)
+    {
+        BOOST_CHECK_EQUAL(popped[i]->m_val,static_cast<int>(i+3));
+        queue.freeItem(popped[i]);
+    }
+    BOOST_CHECK(queue.isEmpty());
+    BOOST_CHECK(queue.popItem()==nullptr);
+
+    size_t maxSize=0;
+    size_t minSize=0;
+    int64_t maxDuration=0;
+    int64_t minDuration=0;
+    queue.readStats(maxSize,minSize,maxDuration,minDuration);
+    BOOST_CHECK_EQUAL(maxSize,7);
+
+    // wrap around the ring
+    for (int i=0;i<100;i++)
+    {
+        queue.push(i);
+        int val=-1;
+        BOOST_REQUIRE(queue.pop(val));
+        BOOST_CHECK_EQUAL(val,i);
+    }
+    BOOST_CHECK(queue.isEmpty());
+}
+
+namespace {
+
+/**
+ * Producers keep backlog of the queue below maxBacklog, so that the ring queue is measured without overflow.
+ */
+template <typename QueueT>
+void benchmarkQueue(const char* name, QueueT& queue, size_t producers, size_t consumers, int count, size_t maxBacklog=32768)
+{
+    std::atomic<int> consumed(0);
+    std::atomic<int64_t> sum(0);
+    int total=count*static_cast<int>(producers);
+
+    auto start=std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t i=0;i<producers;i++)
+    {
+        threads.emplace_back(
+            [&queue,count,maxBacklog]()
+            {
+                for (int j=0;j<count;j++)
+                {
+                    while (queue.size()>maxBacklog)
+                    {
+                        std::this_thread::yield();
+                    }
+                    queue.push(j);
+                }
+            }
+        );
+    }
+    for (size_t i=0;i<consumers;i++)
+    {
+        threads.emplace_back(
+            [&queue,&consumed,&sum,total]()
+            {
+                int val=0;
+                while (consumed.load(std::memory_order_relaxed)<total)
+                {
+                    if (queue.pop(val))
+                    {
+                        sum.fetch_add(val,std::memory_order_relaxed);
+                        consumed.fetch_add(1,std::memory_order_relaxed);
+                    }
+                }
+            }
+        );
+    }
+    for (auto&& thread:threads)
+    {
+        thread.join();
+    }
+
+    auto elapsed=std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-start).count();
+    std::cout<<name<<": "<<producers<<" producers, "<<consumers<<" consumers, "<<total<<" items took "<<elapsed<<" ms"<<std::endl;
+
+    BOOST_CHECK_EQUAL(consumed.load(),total);
+    BOOST_CHECK_EQUAL(sum.load(),static_cast<int64_t>(count-1)*count/2*static_cast<int64_t>(producers));
+    BOOST_CHECK(queue.isEmpty());
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(QueuesBenchmark)
+{
+#ifdef BUILD_VALGRIND
+    int count=100;
+#else
+    #if defined(BUILD_DEBUG) || defined(BUILD_ANDROID)
+        int count=100000;
+    #else
+        int count=1000000;
+    #endif
+#endif
+
+    {
+        MutexQueue<int> queue;
+        benchmarkQueue("MutexQueue",queue,4,1,count);
+    }
+    {
+        MPSCQueue<int> queue;
+        benchmarkQueue("MPSCQueue",queue,4,1,count);
+    }
+    {
+        MPMCRingQueue<int> queue(65536);
+        benchmarkQueue("MPMCRingQueue",queue,4,1,count);
+    }
+    {
+        MutexQueue<int> queue;
+        benchmarkQueue("MutexQueue",queue,4,4,count);
+    }
+    {
+        MPMCRingQueue<int> queue(65536);
+        benchmarkQueue("MPMCRingQueue",queue,4,4,count);
+    }
+}
 
 BOOST_FIXTURE_TEST_CASE(ThreadPool,MultiThreadFixture)
 {
@@ -823,6 +1031,63 @@ BOOST_FIXTURE_TEST_CASE(ThreadPool,MultiThreadFixture)
     delete pool;
 }
 
+BOOST_FIXTURE_TEST_CASE(ThreadPoolWorkStealing,MultiThreadFixture)
+{
+    auto queue=new MPSCQueue<Task>();
+    auto pool=new ThreadPoolWithQueues<Task>(4,"stealpool",queue);
+    pool->setWorkStealing(true);
+    BOOST_CHECK(pool->isWorkStealing());
+
+    std::atomic<int> counter(0);
+    std::atomic<int> stolenCounter(0);
+    volatile int jjj = 0;
+
+#ifdef BUILD_VALGRIND
+    int repeats=20;
+    int delayCount=20;
+#else
+    int repeats=400;
+    int delayCount=100000;
+#endif
+
+    // all tasks are posted from one thread of the pool to its own queue, other threads must steal them
+    auto producer=[&]()
+    {
+        auto producerThread=Thread::currentThread();
+        for (int i=0;i<repeats;i++)
+        {
+            pool->postTask(Task(
+                [&,producerThread]()
+                {
+                    if (Thread::currentThread()!=producerThread)
+                    {
+                        stolenCounter.fetch_add(1,std::memory_order_relaxed);
+                    }
+                    for (int j=0;j<delayCount;j++)
+                    {
+                        jjj++;
+                    }
+                    counter.fetch_add(1,std::memory_order_relaxed);
+                }
+            ));
+        }
+    };
+
+    pool->start();
+    pool->postTask(Task(producer));
+
+    exec(5);
+
+    pool->stop();
+
+    std::cout<<"Calculated data in pool with work stealing: total="<<counter.load()<<", stolen="<<stolenCounter.load()<<std::endl;
+
+    BOOST_CHECK_EQUAL(counter.load(std::memory_order_relaxed),repeats);
+    BOOST_CHECK_GT(stolenCounter.load(std::memory_order_relaxed),0);
+
+    delete pool;
+}
+
 #ifndef HATN_THREAD_TIMER_TEST_DISABLE
 BOOST_FIXTURE_TEST_CASE(ThreadTimers,MultiThreadFixture)
 #else
@@ -134,6 +134,18 @@ class SecureStream : public common::TaskSubcontext,
             return this->traits().setupSniClient(name,ech);
         }
 
+        //! Set key of the endpoint in session cache of context
+        inline void setSessionCacheKey(std::string key)
+        {
+            this->traits().setSessionCacheKey(std::move(key));
+        }
+
+        //! Check if session was resumed in handshake
+        inline bool isSessionResumed() const noexcept
+        {
+            return this->traits().isSessionResumed();
+        }
+
     private:
 
         SecureStreamContext* m_context;
@@ -211,6 +223,18 @@ class SecureStreamTmplV : public common::StreamTmplV<ImplT,SecureStreamV>
         {
             return this->impl().setMainCtx(mainContext);
         }
+
+        //! Set key of the endpoint in session cache of context
+        virtual void setSessionCacheKey(std::string key) override
+        {
+            this->impl().setSessionCacheKey(std::move(key));
+        }
+
+        //! Check if session was resumed in handshake
+        virtual bool isSessionResumed() const noexcept override
+        {
+            return this->impl().isSessionResumed();
+        }
 };
 
 HATN_CRYPT_NAMESPACE_END
@@ -31,6 +31,7 @@
 #include <hatn/crypt/securestreamtypes.h>
 #include <hatn/crypt/securekey.h>
 #include <hatn/crypt/dh.h>
+#include <hatn/crypt/tlssessioncache.h>
 
 HATN_CRYPT_NAMESPACE_BEGIN
 
@@ -402,6 +403,24 @@ class SecureStreamContext
             return m_parentCtx;
         }
 
+        /**
+         * @brief Set cache of sessions to resume at client side.
+         * @param cache Session cache, can be shared by a few contexts.
+         *
+         * Must be set before creating streams.
+         */
+        void setSessionCache(std::shared_ptr<TlsSessionCache> cache)
+        {
+            m_sessionCache=std::move(cache);
+            updateSessionCache();
+        }
+
+        //! Get cache of sessions to resume at client side
+        const std::shared_ptr<TlsSessionCache>& sessionCache() const noexcept
+        {
+            return m_sessionCache;
+        }
+
     protected:
 
         //! Update endpoint type in derived class
@@ -416,6 +435,10 @@ class SecureStreamContext
         virtual void updateProtocolVersion()
         {}
 
+        //! Update session cache in derived class
+        virtual void updateSessionCache()
+        {}
+
     private:
 
         SecureStreamTypes::ProtocolVersion m_minProtocolVersion;
@@ -432,6 +455,8 @@ class SecureStreamContext
         bool m_ignoreUnknownSniHost;
 
         common::SharedPtr<common::TaskContext> m_parentCtx;
+
+        std::shared_ptr<TlsSessionCache> m_sessionCache;
 };
 
 HATN_CRYPT_NAMESPACE_END
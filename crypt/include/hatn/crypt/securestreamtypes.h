@@ -143,6 +143,23 @@ class HATN_CRYPT_EXPORT SecureStreamV : public common::StreamV
             }
             return cryptError(CryptError::SNI_NOT_SUPPORTED);
         }
+
+        /**
+         * @brief Set key of the endpoint in session cache of context.
+         * @param key Endpoint key, e.g. name:port of server.
+         *
+         * If key is not set then the name used for SNI or peer verification is used as the key.
+         */
+        virtual void setSessionCacheKey(std::string key)
+        {
+            std::ignore=key;
+        }
+
+        //! Check if session was resumed in handshake
+        virtual bool isSessionResumed() const noexcept
+        {
+            return false;
+        }
 };
 
 HATN_CRYPT_NAMESPACE_END
@@ -0,0 +1,153 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/** @file crypt/tlssessioncache.h
+  *
+  *   Client side cache of TLS sessions for session resumption
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNTLSSESSIONCACHE_H
+#define HATNTLSSESSIONCACHE_H
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+
+#include <hatn/common/bytearray.h>
+#include <hatn/common/locker.h>
+
+#include <hatn/crypt/crypt.h>
+
+HATN_CRYPT_NAMESPACE_BEGIN
+
+/**
+ * @brief Thread-safe client side cache of TLS sessions.
+ *
+ * Sessions are kept in serialized form for each endpoint, endpoint is usually a name or name:port of the server.
+ * A session is kept for lifetime of its ticket limited by maxLifetime.
+ * TLS1.3 tickets are meant for single use, so a session is removed from the cache when it is taken for resumption.
+ *
+ * The same cache can be shared by a few TLS contexts.
+ */
+class HATN_CRYPT_EXPORT TlsSessionCache final
+{
+    public:
+
+        using Clock=std::chrono::steady_clock;
+        using TimePoint=Clock::time_point;
+
+        struct Config
+        {
+            std::chrono::seconds maxLifetime=std::chrono::seconds(7200);
+            size_t maxSessionsPerEndpoint=4;
+            size_t maxEndpoints=1024;
+        };
+
+        struct Stats
+        {
+            //! Number of sessions found in cache.
+            uint64_t hits=0;
+
+            //! Number of lookups when no valid session was found.
+            uint64_t misses=0;
+
+            //! Number of sessions put to cache.
+            uint64_t stored=0;
+
+            //! Number of sessions dropped because their lifetime expired.
+            uint64_t expired=0;
+
+            //! Number of handshakes where server accepted cached session.
+            uint64_t resumed=0;
+
+            //! Number of handshakes where server rejected cached session and full handshake was done.
+            uint64_t rejected=0;
+        };
+
+        explicit TlsSessionCache(Config config) : m_config(std::move(config))
+        {}
+
+        TlsSessionCache() : TlsSessionCache(Config{})
+        {}
+
+        /**
+         * @brief Put session to cache.
+         * @param endpoint Endpoint the session was established with.
+         * @param session Serialized session.
+         * @param lifetime Lifetime of session ticket.
+         * @param now Current time.
+         */
+        void store(
+            const lib::string_view& endpoint,
+            common::ByteArray session,
+            std::chrono::seconds lifetime,
+            TimePoint now=Clock::now()
+        );
+
+        /**
+         * @brief Take the most recent valid session from cache.
+         * @param endpoint Endpoint to connect to.
+         * @param session Serialized session.
+         * @param now Current time.
+         * @return True if session was found.
+         */
+        bool take(
+            const lib::string_view& endpoint,
+            common::ByteArray& session,
+            TimePoint now=Clock::now()
+        );
+
+        //! Report result of handshake with session taken from the cache.
+        void reportResumption(bool resumed);
+
+        //! Remove sessions of endpoint.
+        void remove(const lib::string_view& endpoint);
+
+        //! Remove all sessions.
+        void clear();
+
+        //! Get number of cached sessions.
+        size_t size() const;
+
+        //! Get counters.
+        Stats stats() const;
+
+        const Config& config() const noexcept
+        {
+            return m_config;
+        }
+
+    private:
+
+        struct Entry
+        {
+            common::ByteArray session;
+            TimePoint expireAt;
+        };
+
+        using Entries=std::deque<Entry>;
+
+        void dropExpired(Entries& entries, TimePoint now);
+        void evict(TimePoint now);
+
+        Config m_config;
+
+        mutable common::MutexLock m_mutex;
+        std::map<std::string,Entries,std::less<>> m_endpoints;
+        size_t m_size=0;
+        Stats m_stats;
+};
+
+HATN_CRYPT_NAMESPACE_END
+
+#endif // HATNTLSSESSIONCACHE_H
@@ -221,6 +221,11 @@ class HATN_OPENSSL_EXPORT OpenSslContext : public SecureStreamContext
         {
             doUpdateProtocolVersion();
         }
+        //! Update session cache in derived class
+        virtual void updateSessionCache() override
+        {
+            doUpdateSessionCache();
+        }
 
     private:
 
@@ -230,6 +235,8 @@ class HATN_OPENSSL_EXPORT OpenSslContext : public SecureStreamContext
         void doUpdateVerifyMode();
         //! Update protocol version in derived class
         void doUpdateProtocolVersion();
+        //! Update session cache in derived class
+        void doUpdateSessionCache();
 
         void updateSessionTicketEncCb();
 
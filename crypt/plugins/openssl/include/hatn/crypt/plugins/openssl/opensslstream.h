@@ -35,6 +35,7 @@ DECLARE_LOG_MODULE_EXPORT(opensslstream,HATN_OPENSSL_EXPORT)
 HATN_OPENSSL_NAMESPACE_BEGIN
 
 class OpenSslStream;
+struct OpenSslStreamBio;
 
 constexpr const uint8_t StreamDebugVerbosity=5;
 constexpr const uint8_t HandshakeDebugVerbosity=3;
@@ -212,11 +213,28 @@ class HATN_OPENSSL_EXPORT OpenSslStreamTraitsImpl
 
         void waitForRead(std::function<void (const Error&)> callback);
 
+        //! Set key of the endpoint in session cache of context
+        void setSessionCacheKey(std::string key)
+        {
+            m_sessionCacheKey=std::move(key);
+        }
+
+        //! Check if session was resumed in handshake
+        bool isSessionResumed() const noexcept
+        {
+            return ::SSL_session_reused(m_ssl)==1;
+        }
+
+        //! Put new session received from server to session cache of context
+        void storeSession(SSL_SESSION* session);
+
     private:
 
+        friend struct OpenSslStreamBio;
+
         void writeSslPipe(const char* data,size_t size);
         void checkNeedWriteNext();
-        void doWriteNext(size_t size,size_t offset=0);
+        void doWriteNext(size_t size);
 
         void readSslPipe();
         void doReadNext();
@@ -226,8 +244,13 @@ class HATN_OPENSSL_EXPORT OpenSslStreamTraitsImpl
         void doShutdown();
         void doHandshake();
 
+        void resumeSession();
+        void setDefaultSessionCacheKey(const X509Certificate::NameType& name);
+
         bool processSslResult(int ret, bool handshakingRead=false);
-        bool processBioResult(int ret);
+
+        size_t bioRead(char* data, size_t maxSize) noexcept;
+        size_t bioWrite(const char* data, size_t size) noexcept;
 
         void doneOp(const Error& ec=Error());
 
@@ -237,12 +260,14 @@ class HATN_OPENSSL_EXPORT OpenSslStreamTraitsImpl
 
         OpenSslContext* m_ctx;
         SSL* m_ssl;
-        BIO* m_bio;
 
         bool m_writingToNext;
         bool m_readingFromNext;
 
         common::ByteArray m_writeNextBuf;
+        size_t m_writeNextBufOffset;
+        size_t m_writeNextBufSize;
+        bool m_writeNextBlocked;
         const char* m_writeAppBuf;
         size_t m_writeAppSize;
         size_t m_writtenAppSize;
@@ -265,6 +290,9 @@ class HATN_OPENSSL_EXPORT OpenSslStreamTraitsImpl
         //! @todo Use timer on stack as part of context
         common::SharedPtr<common::AsioDeadlineTimer> m_shutdownTimer;
         bool m_stopped;
+
+        std::string m_sessionCacheKey;
+        bool m_sessionFromCache;
 };
 
 using OpenSslStreamTraits=common::StreamGatherTraits<OpenSslStreamTraitsImpl>;
@@ -591,6 +591,34 @@ void OpenSslContext::updateSessionTicketEncCb()
 
 #endif
 
+//---------------------------------------------------------------
+static int newSessionCb(SSL *s, SSL_SESSION *session)
+{
+    auto streamTraits=static_cast<OpenSslStreamTraitsImpl*>(::SSL_get_ex_data(s,OpenSslPlugin::sslCtxIdx()));
+    if (streamTraits)
+    {
+        streamTraits->storeSession(session);
+    }
+
+    // session is serialized by the stream, reference is not kept
+    return 0;
+}
+
+//---------------------------------------------------------------
+void OpenSslContext::doUpdateSessionCache()
+{
+    if (sessionCache())
+    {
+        ::SSL_CTX_set_session_cache_mode(m_sslCtx,SSL_SESS_CACHE_CLIENT|SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        ::SSL_CTX_sess_set_new_cb(m_sslCtx,newSessionCb);
+    }
+    else
+    {
+        ::SSL_CTX_set_session_cache_mode(m_sslCtx,SSL_SESS_CACHE_SERVER);
+        ::SSL_CTX_sess_set_new_cb(m_sslCtx,NULL);
+    }
+}
+
 //---------------------------------------------------------------
 void OpenSslContext::doUpdateProtocolVersion()
 {
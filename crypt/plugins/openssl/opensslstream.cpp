@@ -15,6 +15,9 @@
 
 /****************************************************************************/
 
+#include <algorithm>
+#include <cstring>
+
 #include <openssl/ssl.h>
 #include <openssl/x509v3.h>
 
@@ -34,6 +37,104 @@ INIT_LOG_MODULE(opensslstream,HATN_OPENSSL_EXPORT)
 
 HATN_OPENSSL_NAMESPACE_BEGIN
 
+/*********************** OpenSslStreamBio **************************/
+
+/**
+ * @brief BIO that connects SSL directly to the buffers of next stream in the chain.
+ *
+ * SSL reads encrypted records from the buffer that was filled by the next stream
+ * and writes encrypted records to the buffer that is sent to the next stream.
+ * Thus the intermediate copy to/from internal buffer of BIO pair is not needed.
+ */
+struct OpenSslStreamBio
+{
+    static OpenSslStreamTraitsImpl* traits(BIO* bio) noexcept
+    {
+        return static_cast<OpenSslStreamTraitsImpl*>(::BIO_get_data(bio));
+    }
+
+    static int create(BIO* bio)
+    {
+        ::BIO_set_init(bio,1);
+        return 1;
+    }
+
+    static int destroy(BIO* bio)
+    {
+        if (bio==nullptr)
+        {
+            return 0;
+        }
+        ::BIO_set_data(bio,nullptr);
+        ::BIO_set_init(bio,0);
+        return 1;
+    }
+
+    static int read(BIO* bio, char* data, size_t maxSize, size_t* readBytes)
+    {
+        ::BIO_clear_retry_flags(bio);
+        auto self=traits(bio);
+        *readBytes=self==nullptr?0:self->bioRead(data,maxSize);
+        if (*readBytes==0)
+        {
+            ::BIO_set_retry_read(bio);
+            return 0;
+        }
+        return 1;
+    }
+
+    static int write(BIO* bio, const char* data, size_t size, size_t* writtenBytes)
+    {
+        ::BIO_clear_retry_flags(bio);
+        auto self=traits(bio);
+        *writtenBytes=self==nullptr?0:self->bioWrite(data,size);
+        if (*writtenBytes==0)
+        {
+            ::BIO_set_retry_write(bio);
+            return 0;
+        }
+        return 1;
+    }
+
+    static long ctrl(BIO* bio, int cmd, long, void*)
+    {
+        auto self=traits(bio);
+        switch (cmd)
+        {
+            case(BIO_CTRL_FLUSH):
+                return 1;
+
+            case(BIO_CTRL_PENDING):
+                return self==nullptr?0:static_cast<long>(self->m_readNextBufSize);
+
+            case(BIO_CTRL_WPENDING):
+                return self==nullptr?0:static_cast<long>(self->m_writeNextBufSize-self->m_writeNextBufOffset);
+
+            default:
+                break;
+        }
+        return 0;
+    }
+
+    static BIO_METHOD* method()
+    {
+        static BIO_METHOD* meth=[]()
+        {
+            auto m=::BIO_meth_new(::BIO_get_new_index()|BIO_TYPE_SOURCE_SINK,"hatn stream");
+            if (m!=nullptr)
+            {
+                ::BIO_meth_set_create(m,create);
+                ::BIO_meth_set_destroy(m,destroy);
+                ::BIO_meth_set_read_ex(m,read);
+                ::BIO_meth_set_write_ex(m,write);
+                ::BIO_meth_set_ctrl(m,ctrl);
+            }
+            return m;
+        }();
+        return meth;
+    }
+};
+
 /*********************** OpenSslStreamTraits **************************/
 
 //---------------------------------------------------------------
@@ -41,9 +142,11 @@ OpenSslStreamTraitsImpl::OpenSslStreamTraitsImpl(OpenSslStream *stream, OpenSslC
     : m_stream(stream),
       m_ctx(context),
       m_ssl(::SSL_new(context->nativeContext())),
-      m_bio(nullptr),
       m_writingToNext(false),
       m_readingFromNext(false),
+      m_writeNextBufOffset(0),
+      m_writeNextBufSize(0),
+      m_writeNextBlocked(false),
       m_writeAppBuf(nullptr),
       m_writeAppSize(0),
       m_writtenAppSize(0),
@@ -55,7 +158,8 @@ OpenSslStreamTraitsImpl::OpenSslStreamTraitsImpl(OpenSslStream *stream, OpenSslC
       m_shutdowning(false),
       m_shutdownNotifying(false),
       m_shutdownTimer(common::makeShared<common::AsioDeadlineTimer>(thread)),
-      m_stopped(false)
+      m_stopped(false),
+      m_sessionFromCache(false)
 {
     if (!m_ssl)
     {
@@ -66,14 +170,19 @@ OpenSslStreamTraitsImpl::OpenSslStreamTraitsImpl(OpenSslStream *stream, OpenSslC
     ::SSL_set_mode(m_ssl, SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
     ::SSL_set_mode(m_ssl, SSL_MODE_RELEASE_BUFFERS);
 
-    BIO* internalBio = nullptr;
-    ::BIO_new_bio_pair(&internalBio,0,&m_bio,0);
-    if (!m_bio)
+    auto bioMethod=OpenSslStreamBio::method();
+    BIO* bio=nullptr;
+    if (bioMethod!=nullptr)
+    {
+        bio=::BIO_new(bioMethod);
+    }
+    if (!bio)
     {
         ::SSL_free(m_ssl);
         throw common::ErrorException(makeLastSslError(CryptError::GENERAL_FAIL));
     }
-    ::SSL_set_bio(m_ssl,internalBio,internalBio);
+    ::BIO_set_data(bio,this);
+    ::SSL_set_bio(m_ssl,bio,bio);
 
     m_readNextBuf.resize(BUF_SIZE);
     m_writeNextBuf.resize(BUF_SIZE);
@@ -88,12 +197,45 @@ OpenSslStreamTraitsImpl::~OpenSslStreamTraitsImpl()
     {
         ::SSL_free(m_ssl);
     }
-    if (m_bio)
+    m_ssl=nullptr;
+}
+
+//---------------------------------------------------------------
+size_t OpenSslStreamTraitsImpl::bioRead(char *data, size_t maxSize) noexcept
+{
+    auto size=(std::min)(maxSize,m_readNextBufSize);
+    if (size>0)
     {
-        ::BIO_vfree(m_bio);
+        memcpy(data,m_readNextBuf.data()+m_readNextBufOffset,size);
+        m_readNextBufOffset+=size;
+        m_readNextBufSize-=size;
     }
-    m_ssl=nullptr;
-    m_bio=nullptr;
+    return size;
+}
+
+//---------------------------------------------------------------
+size_t OpenSslStreamTraitsImpl::bioWrite(const char *data, size_t size) noexcept
+{
+    if (m_writeNextBufSize==m_writeNextBuf.size() && m_writeNextBufOffset>0 && !m_writingToNext)
+    {
+        // move unsent data to the beginning of buffer, data being sent must stay in place
+        auto pending=m_writeNextBufSize-m_writeNextBufOffset;
+        memmove(m_writeNextBuf.data(),m_writeNextBuf.data()+m_writeNextBufOffset,pending);
+        m_writeNextBufOffset=0;
+        m_writeNextBufSize=pending;
+    }
+
+    auto writtenSize=(std::min)(size,m_writeNextBuf.size()-m_writeNextBufSize);
+    if (writtenSize>0)
+    {
+        memcpy(m_writeNextBuf.data()+m_writeNextBufSize,data,writtenSize);
+        m_writeNextBufSize+=writtenSize;
+    }
+    else
+    {
+        m_writeNextBlocked=true;
+    }
+    return writtenSize;
 }
 
 //---------------------------------------------------------------
@@ -107,16 +249,10 @@ void OpenSslStreamTraitsImpl::checkNeedWriteNext()
         return;
     }
 
-    size_t readyBytes=0;
-    ::ERR_clear_error();
-    int ret=::BIO_read_ex(m_bio,m_writeNextBuf.data(),m_writeNextBuf.size(),&readyBytes);
+    size_t readyBytes=m_writeNextBufSize-m_writeNextBufOffset;
 
-    HATN_CTX_DEBUG_RECORDS_M(StreamDebugVerbosity,"read BIO",HLOG_MODULE(opensslstream),{"ret",ret},{"readyBytes",readyBytes})
+    HATN_CTX_DEBUG_RECORDS_M(StreamDebugVerbosity,"pending BIO",HLOG_MODULE(opensslstream),{"readyBytes",readyBytes})
 
-    if (!processBioResult(ret))
-    {
-        return;
-    }
     if (readyBytes>0)
     {
         doWriteNext(readyBytes);
@@ -128,13 +264,13 @@ void OpenSslStreamTraitsImpl::checkNeedWriteNext()
 }
 
 //---------------------------------------------------------------
-void OpenSslStreamTraitsImpl::doWriteNext(size_t size, size_t offset)
+void OpenSslStreamTraitsImpl::doWriteNext(size_t size)
 {
     HATN_CTX_SCOPE("doWriteNext")
 
-    HATN_CTX_DEBUG_RECORDS_M(StreamDebugVerbosity,"enter",HLOG_MODULE(opensslstream),{"size",size},{"offset",offset})
+    HATN_CTX_DEBUG_RECORDS_M(StreamDebugVerbosity,"enter",HLOG_MODULE(opensslstream),{"size",size},{"offset",m_writeNextBufOffset})
 
-    auto&& cb=[this,size,offset](const Error& ec,size_t doneSize)
+    auto&& cb=[this,size](const Error& ec,size_t doneSize)
     {
         HATN_CTX_SCOPE("doWriteNextCb")
 
@@ -156,11 +292,18 @@ void OpenSslStreamTraitsImpl::doWriteNext(size_t size, size_t offset)
         m_writingToNext=false;
         if (!ec)
         {
+            m_writeNextBufOffset+=doneSize;
+            if (m_writeNextBufOffset==m_writeNextBufSize)
+            {
+                m_writeNextBufOffset=0;
+                m_writeNextBufSize=0;
+            }
+
             if (doneSize<size)
             {
                 HATN_CTX_DEBUG(StreamDebugVerbosity,"write next part",HLOG_MODULE(opensslstream));
 
-                doWriteNext(size-doneSize,offset+doneSize);
+                doWriteNext(size-doneSize);
             }
             else
             {
@@ -198,6 +341,13 @@ void OpenSslStreamTraitsImpl::doWriteNext(size_t size, size_t offset)
                             writeCbTmp(Error(),std::exchange(m_writeAppSize,0));
                         }
                     }
+                    else if (std::exchange(m_writeNextBlocked,false) && !m_stream->isOpen())
+                    {
+                        HATN_CTX_DEBUG(StreamDebugVerbosity,"continue blocked handshake",HLOG_MODULE(opensslstream));
+
+                        doHandshake();
+                        return;
+                    }
                     else
                     {
                         HATN_CTX_DEBUG(StreamDebugVerbosity,"no write callback",HLOG_MODULE(opensslstream));
@@ -219,7 +369,7 @@ void OpenSslStreamTraitsImpl::doWriteNext(size_t size, size_t offset)
     {
         m_shutdownNotifying=true;
     }
-    m_stream->writeNext(m_writeNextBuf.data()+offset,size,cb);
+    m_stream->writeNext(m_writeNextBuf.data()+m_writeNextBufOffset,size,cb);
 }
 
 //---------------------------------------------------------------
@@ -289,17 +439,8 @@ void OpenSslStreamTraitsImpl::doReadNext()
                 return;
             }
 
-            size_t writtenBytes=0;
-            ::ERR_clear_error();
-            int ret=::BIO_write_ex(m_bio,m_readNextBuf.data()+m_readNextBufOffset,receivedBytes,&writtenBytes);
-            if (!processBioResult(ret))
-            {
-                HATN_CTX_DEBUG(StreamDebugVerbosity,"failed processBioResult",HLOG_MODULE(opensslstream));
-                return;
-            }
-
-            m_readNextBufSize=receivedBytes-writtenBytes;
-            m_readNextBufOffset+=writtenBytes;
+            // received data is consumed by SSL directly from the buffer
+            m_readNextBufSize+=receivedBytes;
 
             if (m_shutdowning)
             {
@@ -333,7 +474,7 @@ void OpenSslStreamTraitsImpl::doReadNext()
     m_readingFromNext=true;
     if (m_readNextBufSize>0)
     {
-        cb(Error(),m_readNextBufSize);
+        cb(Error(),0);
     }
     else
     {
@@ -399,7 +540,12 @@ void OpenSslStreamTraitsImpl::doHandshake()
     }
     if (ret==1)
     {
-        HATN_CTX_DEBUG(HandshakeDebugVerbosity,"done",HLOG_MODULE(opensslstream));
+        HATN_CTX_DEBUG_RECORDS_M(HandshakeDebugVerbosity,"done",HLOG_MODULE(opensslstream),{"resumed",isSessionResumed()});
+
+        if (std::exchange(m_sessionFromCache,false) && m_ctx->sessionCache())
+        {
+            m_ctx->sessionCache()->reportResumption(isSessionResumed());
+        }
 
         if (m_stream->errors().empty())
         {
@@ -616,23 +762,6 @@ bool OpenSslStreamTraitsImpl::processSslResult(int ret, bool handshakingRead)
     return true;
 }
 
-//---------------------------------------------------------------
-bool OpenSslStreamTraitsImpl::processBioResult(int ret)
-{
-    HATN_CTX_SCOPE("processBioResult")
-
-    if (ret<=0 && BIO_should_retry(m_bio)==0)
-    {
-        HATN_CTX_DEBUG_RECORDS_M(StreamDebugVerbosity,"failed",HLOG_MODULE(opensslstream),{"ret",ret});
-
-        fail(makeLastSslError());
-        return false;
-    }
-
-    HATN_CTX_DEBUG_RECORDS_M(StreamDebugVerbosity,"ok",HLOG_MODULE(opensslstream),{"ret",ret});
-    return true;
-}
-
 //---------------------------------------------------------------
 Error OpenSslStreamTraitsImpl::addPeerVerifyName(const X509Certificate::NameType &name)
 {
@@ -653,6 +782,7 @@ Error OpenSslStreamTraitsImpl::addPeerVerifyName(const X509Certificate::NameType
     {
         return makeLastSslError();
     }
+    setDefaultSessionCacheKey(name);
 
     return Error();
 }
@@ -677,6 +807,7 @@ Error OpenSslStreamTraitsImpl::setPeerVerifyName(const X509Certificate::NameType
     {
         return makeLastSslError();
     }
+    setDefaultSessionCacheKey(name);
 
     return Error();
 }
@@ -770,6 +901,8 @@ void OpenSslStreamTraitsImpl::prepare(std::function<void (const Error &)> callba
         ::SSL_set_connect_state(m_ssl);
 
         HATN_CTX_DEBUG(DoneDebugVerbosity,"client mode",HLOG_MODULE(opensslstream));
+
+        resumeSession();
     }
 
     if (
@@ -823,10 +956,93 @@ Error OpenSslStreamTraitsImpl::setupSniClient(const X509Certificate::NameType& n
     {
         return makeLastSslError();
     }
+    setDefaultSessionCacheKey(name);
 
     return Error();
 }
 
+//---------------------------------------------------------------
+void OpenSslStreamTraitsImpl::setDefaultSessionCacheKey(const X509Certificate::NameType& name)
+{
+    if (m_sessionCacheKey.empty())
+    {
+        m_sessionCacheKey=std::string{name.data(),name.size()};
+    }
+}
+
+//---------------------------------------------------------------
+void OpenSslStreamTraitsImpl::resumeSession()
+{
+    HATN_CTX_SCOPE("resumeSession")
+
+    const auto& cache=m_ctx->sessionCache();
+    if (!cache || m_sessionCacheKey.empty())
+    {
+        return;
+    }
+
+    common::ByteArray buf;
+    if (!cache->take(m_sessionCacheKey,buf))
+    {
+        HATN_CTX_DEBUG_RECORDS_M(HandshakeDebugVerbosity,"session not cached",HLOG_MODULE(opensslstream),{"endpoint",m_sessionCacheKey});
+        return;
+    }
+
+    ::ERR_clear_error();
+    auto data=reinterpret_cast<const unsigned char*>(buf.data());
+    SSL_SESSION* session=::d2i_SSL_SESSION(nullptr,&data,static_cast<long>(buf.size()));
+    if (session==nullptr)
+    {
+        HATN_CTX_DEBUG(HandshakeDebugVerbosity,"failed to parse cached session",HLOG_MODULE(opensslstream));
+        ::ERR_clear_error();
+        return;
+    }
+    if (::SSL_set_session(m_ssl,session)==1)
+    {
+        HATN_CTX_DEBUG_RECORDS_M(HandshakeDebugVerbosity,"resume cached session",HLOG_MODULE(opensslstream),{"endpoint",m_sessionCacheKey});
+        m_sessionFromCache=true;
+    }
+    else
+    {
+        ::ERR_clear_error();
+    }
+    ::SSL_SESSION_free(session);
+}
+
+//---------------------------------------------------------------
+void OpenSslStreamTraitsImpl::storeSession(SSL_SESSION* session)
+{
+    HATN_CTX_SCOPE("storeSession")
+
+    const auto& cache=m_ctx->sessionCache();
+    if (!cache || m_sessionCacheKey.empty() || ::SSL_SESSION_is_resumable(session)!=1)
+    {
+        return;
+    }
+
+    auto size=::i2d_SSL_SESSION(session,nullptr);
+    if (size<=0)
+    {
+        ::ERR_clear_error();
+        return;
+    }
+    common::ByteArray buf;
+    buf.resize(static_cast<size_t>(size));
+    auto data=reinterpret_cast<unsigned char*>(buf.data());
+    ::i2d_SSL_SESSION(session,&data);
+
+    // TLS1.3 tickets have their own lifetime, otherwise use session timeout
+    uint64_t lifetime=::SSL_SESSION_get_ticket_lifetime_hint(session);
+    if (lifetime==0)
+    {
+        lifetime=static_cast<uint64_t>(::SSL_SESSION_get_timeout(session));
+    }
+
+    HATN_CTX_DEBUG_RECORDS_M(HandshakeDebugVerbosity,"store session",HLOG_MODULE(opensslstream),{"endpoint",m_sessionCacheKey},{"lifetime",lifetime});
+
+    cache->store(m_sessionCacheKey,std::move(buf),std::chrono::seconds(lifetime));
+}
+
 void OpenSslStreamTraitsImpl::waitForRead(std::function<void (const Error&)> callback)
 {
     m_stream->waitForReadNext(std::move(callback));
@@ -0,0 +1,209 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/** @file crypt/tlssessioncache.cpp
+  *
+  *   Client side cache of TLS sessions for session resumption
+  *
+  */
+
+/****************************************************************************/
+
+#include <algorithm>
+
+#include <hatn/crypt/tlssessioncache.h>
+
+HATN_CRYPT_NAMESPACE_BEGIN
+
+using namespace common;
+
+/*********************** TlsSessionCache **************************/
+
+//---------------------------------------------------------------
+void TlsSessionCache::store(
+        const lib::string_view& endpoint,
+        common::ByteArray session,
+        std::chrono::seconds lifetime,
+        TimePoint now
+    )
+{
+    if (endpoint.empty() || session.isEmpty())
+    {
+        return;
+    }
+    lifetime=(std::min)(lifetime,m_config.maxLifetime);
+    if (lifetime.count()<=0)
+    {
+        return;
+    }
+
+    MutexScopedLock l{m_mutex};
+
+    auto it=m_endpoints.find(endpoint);
+    if (it==m_endpoints.end())
+    {
+        if (m_endpoints.size()>=m_config.maxEndpoints)
+        {
+            evict(now);
+        }
+        it=m_endpoints.emplace(std::string{endpoint},Entries{}).first;
+    }
+    auto& entries=it->second;
+
+    dropExpired(entries,now);
+    while (!entries.empty() && entries.size()>=m_config.maxSessionsPerEndpoint)
+    {
+        entries.pop_front();
+        --m_size;
+    }
+
+    Entry entry;
+    entry.session=std::move(session);
+    entry.expireAt=now+lifetime;
+    entries.push_back(std::move(entry));
+    ++m_size;
+    ++m_stats.stored;
+}
+
+//---------------------------------------------------------------
+bool TlsSessionCache::take(
+        const lib::string_view& endpoint,
+        common::ByteArray& session,
+        TimePoint now
+    )
+{
+    MutexScopedLock l{m_mutex};
+
+    auto it=m_endpoints.find(endpoint);
+    if (it==m_endpoints.end())
+    {
+        ++m_stats.misses;
+        return false;
+    }
+
+    auto& entries=it->second;
+    dropExpired(entries,now);
+    if (entries.empty())
+    {
+        m_endpoints.erase(it);
+        ++m_stats.misses;
+        return false;
+    }
+
+    // the most recent session is the last one
+    session=std::move(entries.back().session);
+    entries.pop_back();
+    --m_size;
+    if (entries.empty())
+    {
+        m_endpoints.erase(it);
+    }
+
+    ++m_stats.hits;
+    return true;
+}
+
+//---------------------------------------------------------------
+void TlsSessionCache::reportResumption(bool resumed)
+{
+    MutexScopedLock l{m_mutex};
+    if (resumed)
+    {
+        ++m_stats.resumed;
+    }
+    else
+    {
+        ++m_stats.rejected;
+    }
+}
+
+//---------------------------------------------------------------
+void TlsSessionCache::dropExpired(Entries& entries, TimePoint now)
+{
+    for (auto it=entries.begin();it!=entries.end();)
+    {
+        if (now>=it->expireAt)
+        {
+            it=entries.erase(it);
+            --m_size;
+            ++m_stats.expired;
+            continue;
+        }
+        ++it;
+    }
+}
+
+//---------------------------------------------------------------
+void TlsSessionCache::evict(TimePoint now)
+{
+    // drop expired sessions and remember endpoint which sessions expire first
+    auto oldest=m_endpoints.end();
+    TimePoint oldestExpireAt;
+    for (auto it=m_endpoints.begin();it!=m_endpoints.end();)
+    {
+        dropExpired(it->second,now);
+        if (it->second.empty())
+        {
+            it=m_endpoints.erase(it);
+            continue;
+        }
+        auto expireAt=it->second.back().expireAt;
+        if (oldest==m_endpoints.end() || expireAt<oldestExpireAt)
+        {
+            oldest=it;
+            oldestExpireAt=expireAt;
+        }
+        ++it;
+    }
+
+    // if still full then drop endpoint with the oldest sessions
+    if (m_endpoints.size()>=m_config.maxEndpoints && oldest!=m_endpoints.end())
+    {
+        m_size-=oldest->second.size();
+        m_endpoints.erase(oldest);
+    }
+}
+
+//---------------------------------------------------------------
+void TlsSessionCache::remove(const lib::string_view& endpoint)
+{
+    MutexScopedLock l{m_mutex};
+    auto it=m_endpoints.find(endpoint);
+    if (it!=m_endpoints.end())
+    {
+        m_size-=it->second.size();
+        m_endpoints.erase(it);
+    }
+}
+
+//---------------------------------------------------------------
+void TlsSessionCache::clear()
+{
+    MutexScopedLock l{m_mutex};
+    m_endpoints.clear();
+    m_size=0;
+}
+
+//---------------------------------------------------------------
+size_t TlsSessionCache::size() const
+{
+    MutexScopedLock l{m_mutex};
+    return m_size;
+}
+
+//---------------------------------------------------------------
+TlsSessionCache::Stats TlsSessionCache::stats() const
+{
+    MutexScopedLock l{m_mutex};
+    return m_stats;
+}
+
+//---------------------------------------------------------------
+
+HATN_CRYPT_NAMESPACE_END
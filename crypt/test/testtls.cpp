@@ -8,6 +8,8 @@
 
 /****************************************************************************/
 
+#include <chrono>
+
 #include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -30,6 +32,7 @@
 #include <hatn/crypt/securestream.h>
 #include <hatn/crypt/securestreamcontext.h>
 #include <hatn/crypt/dh.h>
+#include <hatn/crypt/tlssessioncache.h>
 
 #include <hatn/crypt/ciphersuite.h>
 
@@ -123,6 +126,8 @@ struct TlsConfig
     Thread* thread=nullptr;
 
     bool autoDH=false;
+
+    std::shared_ptr<TlsSessionCache> clientSessionCache;
 };
 
 struct TestContextStorage
@@ -528,6 +533,11 @@ void tlsContext(
         }
         BOOST_CHECK(!ec);
     }
+    if (config.clientSessionCache)
+    {
+        clientContext->setSessionCache(config.clientSessionCache);
+        BOOST_CHECK(clientContext->sessionCache()==config.clientSessionCache);
+    }
 }
 
 void checkHandshake(
@@ -2102,6 +2112,214 @@ BOOST_FIXTURE_TEST_CASE(CheckTlsReadWriteUniDir,Env)
     checkAlg(algHandler);
 }
 
+BOOST_FIXTURE_TEST_CASE(CheckTlsThroughput,Env)
+{
+    auto algHandler=[this](std::shared_ptr<CryptPlugin>& plugin,const std::string& algName,const std::string& pathPrefix)
+    {
+        ByteArray serverRd;
+        serverRd.resize(rdBufSize);
+        ByteArray clientRd;
+        clientRd.resize(rdBufSize);
+
+        ByteArray clientWriteBuf;
+        auto ec=plugin->randContainer(clientWriteBuf,testBufSize);
+        HATN_REQUIRE(!ec);
+
+        SharedPtr<SecureStreamV> clientStream;
+        ByteArray serverRecvBuf;
+
+        size_t doneCount=0;
+        std::chrono::steady_clock::time_point started;
+
+        auto doneCb=[this,&clientStream,&doneCount,&serverRecvBuf,&clientWriteBuf,&started,&algName]()
+        {
+            if (++doneCount==2)
+            {
+                auto elapsedUs=std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-started).count();
+                BOOST_TEST_MESSAGE(fmt::format("{}: transferred {} bytes in {} us, {:.2f} MB/s",
+                                               algName,testBufSize,elapsedUs,
+                                               elapsedUs==0?0.0:static_cast<double>(testBufSize)/static_cast<double>(elapsedUs)));
+                BOOST_CHECK(serverRecvBuf==clientWriteBuf);
+
+                if (clientStream)
+                {
+                    clientStream->close(
+                        [this](const Error& ec)
+                        {
+                            G_DEBUG(fmt::format("client shutdown done ({}): {}",ec.value(),ec.message()));
+                            quit();
+                        }
+                    );
+                }
+                else
+                {
+                    BOOST_CHECK(false);
+                    quit();
+                }
+            }
+        };
+
+        auto streamDoneCb=[doneCb](const Error& ec,SharedPtr<SecureStreamV> stream)
+        {
+            G_DEBUG(fmt::format("{} operation done ({}): {}",stream->id(),ec.value(),ec.message()));
+            BOOST_CHECK(!ec);
+            doneCb();
+        };
+
+        auto clientCb=[streamDoneCb,&clientStream,&clientRd,&clientWriteBuf,&started](const Error& ec,const SharedPtr<SecureStreamV>& stream)
+        {
+            HATN_REQUIRE(stream);
+            BOOST_CHECK(!ec);
+            clientStream=stream;
+
+            stream->read(clientRd.data(),clientRd.size(),
+                [](const common::Error& ec1,size_t size)
+                {
+                    G_DEBUG(fmt::format("Client readCb size={}, status={} ({})",size,ec1.value(),ec1.message()));
+                }
+            );
+
+            // write all data at once to let the stream fill TLS records of maximum size
+            started=std::chrono::steady_clock::now();
+            stream->write(clientWriteBuf.data(),clientWriteBuf.size(),
+                [stream,streamDoneCb,&clientWriteBuf](const common::Error& ec1,size_t size)
+                {
+                    BOOST_CHECK_EQUAL(size,clientWriteBuf.size());
+                    streamDoneCb(ec1,stream);
+                }
+            );
+        };
+        auto serverCb=[streamDoneCb,&serverRd,&serverRecvBuf](const Error& ec,const SharedPtr<SecureStreamV>& stream)
+        {
+            HATN_REQUIRE(stream);
+            BOOST_CHECK(!ec);
+
+            stream->read(serverRd.data(),serverRd.size(),
+                [&serverRd,stream,streamDoneCb,&serverRecvBuf](const common::Error& ec1,size_t size)
+                {
+                    readNext(ec1,size,stream,serverRd,serverRecvBuf,streamDoneCb,testBufSize);
+                }
+            );
+        };
+        checkHandshake(this,plugin,algName,pathPrefix,std::function<void (TlsConfig&)>(),false,clientCb,false,serverCb,30);
+
+        BOOST_CHECK_EQUAL(doneCount,2);
+    };
+    checkAlg(algHandler);
+}
+
+BOOST_AUTO_TEST_CASE(CheckTlsSessionCache)
+{
+    TlsSessionCache::Config config;
+    config.maxLifetime=std::chrono::seconds(100);
+    config.maxSessionsPerEndpoint=2;
+    config.maxEndpoints=2;
+    TlsSessionCache cache{config};
+
+    auto now=TlsSessionCache::Clock::now();
+    ByteArray session;
+
+    // miss
+    BOOST_CHECK(!cache.take("host1",session,now));
+    BOOST_CHECK_EQUAL(cache.stats().misses,1u);
+
+    // sessions are taken from the most recent one and only once
+    cache.store("host1",ByteArray("session1"),std::chrono::seconds(10),now);
+    cache.store("host1",ByteArray("session2"),std::chrono::seconds(10),now);
+    cache.store("host1",ByteArray("session3"),std::chrono::seconds(10),now);
+    BOOST_CHECK_EQUAL(cache.size(),2u);
+    BOOST_CHECK(cache.take("host1",session,now));
+    BOOST_CHECK_EQUAL(std::string(session.data(),session.size()),std::string("session3"));
+    BOOST_CHECK(cache.take("host1",session,now));
+    BOOST_CHECK_EQUAL(std::string(session.data(),session.size()),std::string("session2"));
+    BOOST_CHECK(!cache.take("host1",session,now));
+    BOOST_CHECK_EQUAL(cache.stats().hits,2u);
+    BOOST_CHECK_EQUAL(cache.stats().stored,3u);
+
+    // lifetime of ticket is limited by maxLifetime
+    cache.store("host1",ByteArray("session4"),std::chrono::seconds(10),now);
+    cache.store("host2",ByteArray("session5"),std::chrono::seconds(1000),now);
+    BOOST_CHECK(!cache.take("host1",session,now+std::chrono::seconds(10)));
+    BOOST_CHECK(!cache.take("host2",session,now+std::chrono::seconds(100)));
+    BOOST_CHECK_EQUAL(cache.stats().expired,2u);
+    BOOST_CHECK_EQUAL(cache.size(),0u);
+
+    // endpoint with the oldest sessions is evicted
+    cache.store("host1",ByteArray("session6"),std::chrono::seconds(10),now);
+    cache.store("host2",ByteArray("session7"),std::chrono::seconds(20),now);
+    cache.store("host3",ByteArray("session8"),std::chrono::seconds(20),now);
+    BOOST_CHECK_EQUAL(cache.size(),2u);
+    BOOST_CHECK(!cache.take("host1",session,now));
+    BOOST_CHECK(cache.take("host2",session,now));
+    BOOST_CHECK(cache.take("host3",session,now));
+
+    cache.reportResumption(true);
+    cache.reportResumption(false);
+    BOOST_CHECK_EQUAL(cache.stats().resumed,1u);
+    BOOST_CHECK_EQUAL(cache.stats().rejected,1u);
+}
+
+BOOST_FIXTURE_TEST_CASE(CheckTlsSessionResumption,Env)
+{
+    auto algHandler=[this](std::shared_ptr<CryptPlugin>& plugin,const std::string& algName,const std::string& pathPrefix)
+    {
+        auto cache=std::make_shared<TlsSessionCache>();
+        auto setupCfg=[cache](TlsConfig& cfg)
+        {
+            cfg.clientSessionCache=cache;
+        };
+
+        ByteArray clientRd;
+        clientRd.resize(rdBufSize);
+        const std::string msg{"hello"};
+
+        auto clientCb=[this,&clientRd,&msg](const Error& ec,SharedPtr<SecureStreamV> stream)
+        {
+            HATN_REQUIRE(stream);
+            BOOST_CHECK(!ec);
+
+            // session tickets are received by client after handshake together with application data
+            stream->read(clientRd.data(),clientRd.size(),
+                [this,stream,&clientRd,&msg](const common::Error& ec1,size_t size)
+                {
+                    BOOST_CHECK(!ec1);
+                    BOOST_CHECK_EQUAL(std::string(clientRd.data(),size),msg);
+                    quit();
+                }
+            );
+        };
+        auto serverCb=[&msg](const Error& ec,SharedPtr<SecureStreamV> stream)
+        {
+            HATN_REQUIRE(stream);
+            BOOST_CHECK(!ec);
+            stream->write(msg.data(),msg.size(),
+                [stream](const common::Error& ec1,size_t)
+                {
+                    BOOST_CHECK(!ec1);
+                }
+            );
+        };
+
+        // full handshake, session is stored
+        checkHandshake(this,plugin,algName,pathPrefix,setupCfg,false,clientCb,false,serverCb,3);
+        auto stats=cache->stats();
+        BOOST_CHECK_EQUAL(stats.misses,1u);
+        BOOST_CHECK_EQUAL(stats.hits,0u);
+        BOOST_CHECK_GE(stats.stored,1u);
+        auto cachedCount=cache->size();
+        BOOST_CHECK_GE(cachedCount,1u);
+
+        // cached session is used in the next handshake,
+        // server context is recreated with new ticket key so it falls back to full handshake
+        checkHandshake(this,plugin,algName,pathPrefix,setupCfg,false,clientCb,false,serverCb,3);
+        stats=cache->stats();
+        BOOST_CHECK_EQUAL(stats.misses,1u);
+        BOOST_CHECK_EQUAL(stats.hits,1u);
+        BOOST_CHECK_EQUAL(stats.resumed+stats.rejected,1u);
+    };
+    checkAlg(algHandler);
+}
+
 BOOST_FIXTURE_TEST_CASE(CheckTlsReadWriteShutdown,Env)
 {
     auto algHandler=[this](std::shared_ptr<CryptPlugin>& plugin,const std::string& algName,const std::string& pathPrefix)
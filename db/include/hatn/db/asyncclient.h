@@ -384,6 +384,28 @@ class HATN_DB_EXPORT AsyncClient : public common::WithMappedThreads,
             );
         }
 
+        template <typename ModelT, typename ContextT, typename CallbackT, typename ObjectsT>
+        void createMany(
+            common::SharedPtr<ContextT> ctx,
+            CallbackT cb,
+            Topic topic,
+            const std::shared_ptr<ModelT>& model,
+            ObjectsT objects,
+            std::vector<Error>* objectErrors=nullptr,
+            Transaction* tx=nullptr
+            )
+        {
+            common::postAsyncTask(
+                threads()->thread(topic.topic()),
+                ctx,
+                [ctx,this,self{shared_from_this()},topic,&model,objects{std::move(objects)},objectErrors,tx](auto, auto cb)
+                {
+                    cb(std::move(ctx),m_client->createMany(topic,model,objects,objectErrors,tx));
+                },
+                std::move(cb)
+            );
+        }
+
         template <typename ModelT, typename ContextT, typename CallbackT>
         void read(
             common::SharedPtr<ContextT> ctx,
@@ -589,6 +611,59 @@ class HATN_DB_EXPORT AsyncClient : public common::WithMappedThreads,
             );
         }
 
+        /**
+         * @brief Open cursor for reading results of find query page by page.
+         *
+         * @see Client::openFindCursor().
+         */
+        template <typename ModelT, typename ContextT, typename CallbackT, typename QueryT>
+        void openFindCursor(
+            common::SharedPtr<ContextT> ctx,
+            CallbackT cb,
+            const std::shared_ptr<ModelT>& model,
+            QueryT query,
+            Topic topic={}
+            )
+        {
+            common::postAsyncTask(
+                topicOrRandomThread(topic),
+                ctx,
+                [ctx,this,self{shared_from_this()},&model,query{std::move(query)}](auto, auto cb)
+                {
+                    cb(std::move(ctx),m_client->openFindCursor(model,query));
+                },
+                std::move(cb)
+            );
+        }
+
+        /**
+         * @brief Fetch next page of objects with cursor.
+         *
+         * Each page is fetched in a separate task, so other tasks of the database thread can run between pages.
+         *
+         * @see Client::fetchCursor().
+         */
+        template <typename ModelT, typename ContextT, typename CallbackT>
+        void fetchCursor(
+            common::SharedPtr<ContextT> ctx,
+            CallbackT cb,
+            const std::shared_ptr<ModelT>& model,
+            std::shared_ptr<FindCursor> cursor,
+            size_t pageSize=0,
+            Topic topic={}
+            )
+        {
+            common::postAsyncTask(
+                topicOrRandomThread(topic),
+                ctx,
+                [ctx,this,self{shared_from_this()},&model,cursor{std::move(cursor)},pageSize](auto, auto cb)
+                {
+                    cb(std::move(ctx),m_client->fetchCursor(model,*cursor,pageSize));
+                },
+                std::move(cb)
+            );
+        }
+
         template <typename ModelT, typename ContextT, typename CallbackT, typename QueryT>
         void findOne(
             common::SharedPtr<ContextT> ctx,
@@ -40,6 +40,7 @@
 #include <hatn/db/indexquery.h>
 #include <hatn/db/update.h>
 #include <hatn/db/find.h>
+#include <hatn/db/findcursor.h>
 #include <hatn/db/transaction.h>
 #include <hatn/db/encryptionmanager.h>
 
@@ -359,6 +360,51 @@ class HATN_DB_EXPORT Client : public common::WithID
             return dbError(DbError::DB_NOT_OPEN);
         }
 
+        /**
+         * @brief Create many objects in a single transaction.
+         * @param topic Topic.
+         * @param model Model.
+         * @param objects Container of objects, elements can be units, pointers or shared pointers to units.
+         * @param objectErrors If not null then failed objects are skipped and their errors are put to this vector
+         *        in the order of objects, otherwise the first error cancels creating of all objects.
+         * @param tx Transaction.
+         * @return Number of created objects or error.
+         */
+        template <typename ModelT, typename ObjectsT>
+        Result<size_t> createMany(Topic topic,
+                                  const std::shared_ptr<ModelT>& model,
+                                  const ObjectsT& objects,
+                                  std::vector<Error>* objectErrors=nullptr,
+                                  Transaction* tx=nullptr
+                                  )
+        {
+            HATN_CTX_SCOPE("db::createmany")
+            if (m_open)
+            {
+                std::vector<const dataunit::Unit*> units;
+                units.reserve(objects.size());
+                for (const auto& object: objects)
+                {
+                    using type=std::decay_t<decltype(object)>;
+                    if constexpr (std::is_pointer<type>::value)
+                    {
+                        units.push_back(object);
+                    }
+                    else if constexpr (std::is_base_of<dataunit::Unit,type>::value)
+                    {
+                        units.push_back(&object);
+                    }
+                    else
+                    {
+                        units.push_back(object.get());
+                    }
+                }
+                return doCreateMany(topic,*model->info,units,objectErrors,tx);
+            }
+            HATN_CTX_SCOPE_LOCK()
+            return dbError(DbError::DB_NOT_OPEN);
+        }
+
         template <typename ModelT>
         Result<DbObjectT<typename ModelT::ManagedType>> read(Topic topic,
                                                 const std::shared_ptr<ModelT>& model,
@@ -622,6 +668,65 @@ class HATN_DB_EXPORT Client : public common::WithID
             return dbError(DbError::DB_NOT_OPEN);
         }
 
+        /**
+         * @brief Open cursor for reading results of find query page by page.
+         * @param model Model.
+         * @param query Wrapper returning query, e.g. result of wrapQuery() or wrapQueryBuilder(). The wrapper is kept by cursor.
+         * @return Cursor to use in fetchCursor().
+         *
+         * Cursor holds a snapshot of the database until all objects are fetched or the cursor is closed.
+         */
+        template <typename ModelT, typename QueryT>
+        Result<std::shared_ptr<FindCursor>> openFindCursor(
+                const std::shared_ptr<ModelT>& model,
+                QueryT query
+            )
+        {
+            HATN_CTX_SCOPE("db::openfindcursor")
+            if (m_open)
+            {
+                auto holder=std::make_shared<FindCursorQueryHolder<QueryT>>(std::move(query));
+                const auto& modelIndexId=model->model.indexId(holder->query.indexT());
+                FindCursor::QueryFn queryFn{
+                    [holder]() -> const IndexQuery&
+                    {
+                        return holder->query;
+                    }
+                };
+                return doOpenFindCursor(*model->info,std::move(queryFn),modelIndexId);
+            }
+
+            HATN_CTX_SCOPE_LOCK()
+            return dbError(DbError::DB_NOT_OPEN);
+        }
+
+        /**
+         * @brief Fetch next page of objects with cursor.
+         * @param model Model.
+         * @param cursor Cursor opened with openFindCursor().
+         * @param pageSize Max number of objects in the page, if zero then default query limit is used.
+         * @return Objects of the page.
+         *
+         * Page can contain less objects than requested if some objects expired. Check cursor's isFinished() to figure out
+         * if there are more objects to fetch.
+         */
+        template <typename ModelT>
+        Result<HATN_COMMON_NAMESPACE::pmr::vector<DbObject>> fetchCursor(
+                const std::shared_ptr<ModelT>& model,
+                FindCursor& cursor,
+                size_t pageSize=0
+            )
+        {
+            HATN_CTX_SCOPE("db::fetchcursor")
+            if (m_open)
+            {
+                return doFetchCursor(*model->info,cursor,pageSize);
+            }
+
+            HATN_CTX_SCOPE_LOCK()
+            return dbError(DbError::DB_NOT_OPEN);
+        }
+
         template <typename ModelT, typename IndexT>
         Result<DbObjectT<typename ModelT::ManagedType>> findOne(
             const std::shared_ptr<ModelT>& model,
@@ -846,8 +951,6 @@ class HATN_DB_EXPORT Client : public common::WithID
             return dbError(DbError::DB_NOT_OPEN);
         }
 
-        //! @todo Test list model topics
-
         template <typename ModelT>
         Result<std::pmr::set<Topic>>
         listModelTopics(
@@ -921,6 +1024,12 @@ class HATN_DB_EXPORT Client : public common::WithID
 
         virtual Error doCreate(Topic topic, const ModelInfo& model, const dataunit::Unit* object, Transaction* tx)=0;
 
+        virtual Result<size_t> doCreateMany(Topic topic,
+                                            const ModelInfo& model,
+                                            const std::vector<const dataunit::Unit*>& objects,
+                                            std::vector<Error>* objectErrors,
+                                            Transaction* tx)=0;
+
         virtual Result<DbObject> doRead(Topic topic,
                                                                  const ModelInfo& model,
                                                                  const ObjectId& id,
@@ -987,6 +1096,18 @@ class HATN_DB_EXPORT Client : public common::WithID
             bool forUpdate
         ) =0;
 
+        virtual Result<std::shared_ptr<FindCursor>> doOpenFindCursor(
+            const ModelInfo& model,
+            FindCursor::QueryFn query,
+            const std::string& modelIndexId
+        ) =0;
+
+        virtual Result<HATN_COMMON_NAMESPACE::pmr::vector<DbObject>> doFetchCursor(
+            const ModelInfo& model,
+            FindCursor& cursor,
+            size_t pageSize
+        ) =0;
+
         virtual Result<DbObject> doFindOne(
             const ModelInfo& model,
             const ModelIndexQuery& query
@@ -68,6 +68,7 @@
     Do(DbError,DB_FLUSH_FAILED,_TR("failed to flush database","db")) \
     Do(DbError,UPDATE_FIELD_NOT_FOUND,_TR("update path does not match object schema","db")) \
     Do(DbError,UPDATE_INVALID_SUBUNIT,_TR("invalid subunit value in update request","db")) \
+    Do(DbError,MODEL_TOPIC_RELATION_REBUILD,_TR("failed to rebuild model-topic relations","db")) \
 
 HATN_DB_NAMESPACE_BEGIN
 
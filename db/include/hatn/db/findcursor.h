@@ -0,0 +1,145 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/*
+
+*/
+/** @file db/findcursor.h
+  *
+  *  Defines cursor for paged iteration over results of find query.
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNDBFINDCURSOR_H
+#define HATNDBFINDCURSOR_H
+
+#include <functional>
+#include <string>
+#include <type_traits>
+
+#include <hatn/db/db.h>
+#include <hatn/db/indexquery.h>
+
+HATN_DB_NAMESPACE_BEGIN
+
+/**
+ * @brief Cursor for reading results of find query page by page.
+ *
+ * Cursor keeps the query, the continuation key of the last fetched page and a lease of
+ * a database snapshot, so all pages are read from the same state of the database.
+ * Only one page is kept in memory and the database thread is free between pages.
+ *
+ * The limit of the query bounds the total number of objects fetched by the cursor,
+ * set it to zero to walk all objects. The offset of the query is applied to the first page only.
+ *
+ * Cursors that are still open when the database is closed are closed by the database
+ * and return no more objects.
+ */
+class HATN_DB_EXPORT FindCursor
+{
+    public:
+
+        using QueryFn=std::function<const IndexQuery& ()>;
+
+        FindCursor(
+                QueryFn query,
+                std::string modelIndexId
+            ) : m_query(std::move(query)),
+                m_modelIndexId(std::move(modelIndexId)),
+                m_fetchedCount(0),
+                m_finished(false)
+        {}
+
+        virtual ~FindCursor()=default;
+
+        FindCursor(const FindCursor&)=delete;
+        FindCursor(FindCursor&&)=delete;
+        FindCursor& operator=(const FindCursor&)=delete;
+        FindCursor& operator=(FindCursor&&)=delete;
+
+        ModelIndexQuery modelIndexQuery() const
+        {
+            return ModelIndexQuery{m_query(),m_modelIndexId};
+        }
+
+        const IndexQuery& query() const
+        {
+            return m_query();
+        }
+
+        const std::string& modelIndexId() const noexcept
+        {
+            return m_modelIndexId;
+        }
+
+        /**
+         * @brief Check if all objects were fetched.
+         */
+        bool isFinished() const noexcept
+        {
+            return m_finished;
+        }
+
+        /**
+         * @brief Get number of index keys fetched so far.
+         */
+        size_t fetchedCount() const noexcept
+        {
+            return m_fetchedCount;
+        }
+
+        /**
+         * @brief Release snapshot lease and mark cursor as finished.
+         */
+        void close()
+        {
+            m_finished=true;
+            doClose();
+        }
+
+    protected:
+
+        void addFetchedCount(size_t count) noexcept
+        {
+            m_fetchedCount+=count;
+        }
+
+        virtual void doClose()
+        {}
+
+    private:
+
+        QueryFn m_query;
+        std::string m_modelIndexId;
+        size_t m_fetchedCount;
+        bool m_finished;
+};
+
+/**
+ * @brief Holder of query wrapper and query built by the wrapper, it is kept by cursor for the cursor's lifetime.
+ */
+template <typename QueryT>
+struct FindCursorQueryHolder
+{
+    using QueryType=std::decay_t<decltype(std::declval<const QueryT&>()())>;
+
+    explicit FindCursorQueryHolder(QueryT wrapper)
+        : wrapper(std::move(wrapper)),
+          query(this->wrapper())
+    {}
+
+    QueryT wrapper;
+    QueryType query;
+};
+
+HATN_DB_NAMESPACE_END
+
+#endif // HATNDBFINDCURSOR_H
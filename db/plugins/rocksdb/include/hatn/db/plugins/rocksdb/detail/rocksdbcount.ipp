@@ -19,6 +19,8 @@
 #ifndef HATNROCKSDBCOUNT_IPP
 #define HATNROCKSDBCOUNT_IPP
 
+#include <hatn/db/plugins/rocksdb/modeltopics.h>
+
 #include <hatn/db/plugins/rocksdb/detail/findmany.ipp>
 
 HATN_ROCKSDB_NAMESPACE_BEGIN
@@ -32,6 +34,17 @@ struct CountT
         const ModelIndexQuery& query,
         const AllocatorFactory* allocatorFactory
     ) const;
+
+    /**
+     * @brief Check if query counts all objects of the topics so that pre-aggregated counters of model-topic relations can be used.
+     *
+     * Counters are not decremented when objects expire by TTL, so models with TTL indexes are always counted by scan.
+     */
+    template <typename ModelT>
+    static bool allObjectsQuery(
+        const ModelT& model,
+        const ModelIndexQuery& query
+    );
 };
 constexpr CountT Count{};
 
@@ -44,22 +57,56 @@ Result<size_t> CountT::operator ()(
     ) const
 {
     size_t count=0;
-    auto keyCallback=[&count,&idxQuery](RocksdbPartition*,
+
+    // unfiltered count is a sum of pre-aggregated counters
+    if (allObjectsQuery(model,idxQuery))
+    {
+        index_key_search::Partitions partitions;
+        index_key_search::queryPartitions(partitions,model,handler,idxQuery);
+        for (const auto& partition: partitions)
+        {
+            if (idxQuery.query.topics().empty())
+            {
+                auto r=ModelTopics::count(model.modelIdStr(),Topic{},handler,partition.get());
+                HATN_CHECK_RESULT(r)
+                count+=r.value();
+            }
+            else
+            {
+                for (const auto& topic: idxQuery.query.topics())
+                {
+                    auto r=ModelTopics::count(model.modelIdStr(),topic,handler,partition.get());
+                    HATN_CHECK_RESULT(r)
+                    count+=r.value();
+                }
+            }
+        }
+
+        if (idxQuery.query.limit()!=0)
+        {
+            count=(std::min)(count,idxQuery.query.limit()+idxQuery.query.offset());
+        }
+    }
+    else
+    {
+        auto keyCallback=[&count,&idxQuery](RocksdbPartition*,
                                                       const lib::string_view&,
                                                       ROCKSDB_NAMESPACE::Slice*,
                                                       ROCKSDB_NAMESPACE::Slice*,
                                                       Error&
                                                       )
-    {
-        count++;
-        if (idxQuery.query.limit()!=0 && (count==(idxQuery.query.limit()+idxQuery.query.offset())))
         {
-            return false;
-        }
-        return true;
-    };
-    auto ec=FindMany(model,handler,idxQuery,allocatorFactory,keyCallback);
-    HATN_CHECK_EC(ec)
+            count++;
+            if (idxQuery.query.limit()!=0 && (count==(idxQuery.query.limit()+idxQuery.query.offset())))
+            {
+                return false;
+            }
+            return true;
+        };
+        auto ec=FindMany(model,handler,idxQuery,allocatorFactory,keyCallback);
+        HATN_CHECK_EC(ec)
+    }
+
     if (count>idxQuery.query.offset())
     {
         count-=idxQuery.query.offset();
@@ -71,6 +118,37 @@ Result<size_t> CountT::operator ()(
     return count;
 }
 
+template <typename ModelT>
+bool CountT::allObjectsQuery(
+        const ModelT&,
+        const ModelIndexQuery& idxQuery
+    )
+{
+    if constexpr (decltype(ModelT::isTtlEnabled())::value)
+    {
+        return false;
+    }
+    else
+    {
+        // indexes are compared by name because static index objects defined in headers
+        // can have separate instances in different shared libraries
+        const auto& q=idxQuery.query;
+        if (q.index()->name()!=oidIdx().name()
+            || q.fields().size()!=1
+            || !q.partitions().isNull()
+            || !q.getFilterTimePoints().isNull()
+           )
+        {
+            return false;
+        }
+
+        const auto& field=q.field(0);
+        return (field.op==query::Operator::gte && field.value.isFirst())
+               ||
+               (field.op==query::Operator::lte && field.value.isLast());
+    }
+}
+
 HATN_ROCKSDB_NAMESPACE_END
 
 #endif // HATNROCKSDBCOUNT_IPP
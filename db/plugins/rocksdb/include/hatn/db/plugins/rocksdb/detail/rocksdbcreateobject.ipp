@@ -19,6 +19,8 @@
 #ifndef HATNROCKSDBCREATEOBJECT_IPP
 #define HATNROCKSDBCREATEOBJECT_IPP
 
+#include <vector>
+
 #include <hatn/common/pmr/allocatorfactory.h>
 
 #include <hatn/logcontext/contextlogger.h>
@@ -130,6 +132,10 @@ Error CreateObjectT::operator ()(
         ttlIndexesT::saveTtlIndexWithMark(ttlMark,ec,model,obj,buf,rdbTx,partition.get(),objectIdS,allocatorFactory);
         HATN_CHECK_EC(ec)
 
+        // save model-topic relation
+        ec=ModelTopics::update(model.modelIdStr(),topic,handler,partition.get(),ModelTopics::Operator::Add,rdbTx);
+        HATN_CHECK_EC(ec)
+
         // done
         return Error{OK};
     };
@@ -138,15 +144,101 @@ Error CreateObjectT::operator ()(
     ec=handler.transaction(transactionFn,tx,true);
     HATN_CHECK_EC(ec)
 
-    // save model-topic relation
-    ec=ModelTopics::update(model.modelIdStr(),topic,handler,partition.get(),ModelTopics::Operator::Add);
-    if (ec)
+    // done
+    return OK;
+}
+
+struct CreateManyT
+{
+    template <typename ModelT, typename CastFnT>
+    Result<size_t> operator ()(const ModelT& model,
+                               RocksdbHandler& handler,
+                               Topic topic,
+                               const std::vector<const dataunit::Unit*>& objects,
+                               const CastFnT& castFn,
+                               std::vector<Error>* objectErrors,
+                               const AllocatorFactory* allocatorFactory,
+                               Transaction* tx
+                               ) const;
+};
+constexpr CreateManyT CreateMany{};
+
+template <typename ModelT, typename CastFnT>
+Result<size_t> CreateManyT::operator ()(
+                               const ModelT& model,
+                               RocksdbHandler& handler,
+                               Topic topic,
+                               const std::vector<const dataunit::Unit*>& objects,
+                               const CastFnT& castFn,
+                               std::vector<Error>* objectErrors,
+                               const AllocatorFactory* allocatorFactory,
+                               Transaction* tx
+                              ) const
+{
+    HATN_CTX_SCOPE("createmany")
+    HATN_CTX_SCOPE_PUSH("coll",model.collection())
+    HATN_CTX_SCOPE_PUSH("topic",topic.topic())
+
+    if (handler.readOnly())
     {
-        HATN_CTX_ERROR(ec,"failed to save model-topic relation")
+        return dbError(DbError::DB_READ_ONLY);
     }
 
+    size_t count=0;
+
+    // all objects are written in the same transaction and committed with a single write batch
+    auto transactionFn=[&](Transaction* tx)
+    {
+        count=0;
+        if (objectErrors!=nullptr)
+        {
+            objectErrors->clear();
+            objectErrors->resize(objects.size());
+        }
+
+        auto rdbTx=RocksdbTransaction::native(tx);
+        for (size_t i=0;i<objects.size();i++)
+        {
+            // each object is saved after savepoint so that only the failed object is rolled back
+            if (objectErrors!=nullptr)
+            {
+                rdbTx->SetSavePoint();
+            }
+
+            auto ec=CreateObject(model,handler,topic,castFn(objects[i]),allocatorFactory,tx);
+            if (ec)
+            {
+                if (objectErrors==nullptr)
+                {
+                    return ec;
+                }
+
+                auto status=rdbTx->RollbackToSavePoint();
+                if (!status.ok())
+                {
+                    return makeError(DbError::TX_ROLLBACK_FAILED,status);
+                }
+                HATN_CTX_DEBUG_RECORDS(1,"failed to create object",{"idx",static_cast<uint64_t>(i)});
+                (*objectErrors)[i]=std::move(ec);
+                continue;
+            }
+
+            if (objectErrors!=nullptr)
+            {
+                rdbTx->PopSavePoint();
+            }
+            count++;
+        }
+
+        return Error{OK};
+    };
+
+    // invoke transaction
+    auto ec=handler.transaction(transactionFn,tx,true);
+    HATN_CHECK_EC(ec)
+
     // done
-    return OK;
+    return count;
 }
 
 HATN_ROCKSDB_NAMESPACE_END
@@ -119,11 +119,8 @@ struct DeleteObjectT
         }
 
         // update model-topic relation
-        ec=ModelTopics::update(model.modelIdStr(),topic,handler,partition,ModelTopics::Operator::Del);
-        if (ec)
-        {
-            HATN_CTX_ERROR(ec,"failed to save model-topic relation")
-        }
+        ec=ModelTopics::update(model.modelIdStr(),topic,handler,partition,ModelTopics::Operator::Del,rdbTx);
+        HATN_CHECK_EC(ec)
 
         // done
         return OK;
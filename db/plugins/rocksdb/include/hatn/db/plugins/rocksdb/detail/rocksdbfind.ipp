@@ -19,6 +19,9 @@
 #ifndef HATNROCKSDBFIND_IPP
 #define HATNROCKSDBFIND_IPP
 
+#include <vector>
+#include <algorithm>
+
 #include <hatn/logcontext/contextlogger.h>
 
 #include <hatn/common/runonscopeexit.h>
@@ -44,6 +47,8 @@ HATN_ROCKSDB_NAMESPACE_BEGIN
 
 struct FindT
 {
+    constexpr static const size_t MultiGetBatchSize=256;
+
     template <typename ModelT>
     Result<common::pmr::vector<DbObject>> operator ()(
         const ModelT& model,
@@ -52,6 +57,19 @@ struct FindT
         bool single,
         const AllocatorFactory* allocatorFactory
     ) const;
+
+    /**
+     * @brief Read objects of found index keys keeping order of the keys.
+     */
+    template <typename ModelT>
+    Result<common::pmr::vector<DbObject>> readObjects(
+        const ModelT& model,
+        RocksdbHandler& handler,
+        const IndexQuery& query,
+        const index_key_search::IndexKeys& indexKeys,
+        const ROCKSDB_NAMESPACE::Snapshot* snapshot,
+        const AllocatorFactory* allocatorFactory
+    ) const;
 };
 constexpr FindT Find{};
 
@@ -91,11 +109,26 @@ Result<common::pmr::vector<DbObject>> FindT::operator ()(
                                               );
     HATN_CHECK_RESULT(indexKeys)
 
+    return readObjects(model,handler,idxQuery.query,indexKeys.value(),snapshot,allocatorFactory);
+}
+
+//---------------------------------------------------------------
+
+template <typename ModelT>
+Result<common::pmr::vector<DbObject>> FindT::readObjects(
+        const ModelT& model,
+        RocksdbHandler& handler,
+        const IndexQuery& query,
+        const index_key_search::IndexKeys& indexKeys,
+        const ROCKSDB_NAMESPACE::Snapshot* snapshot,
+        const AllocatorFactory* allocatorFactory
+    ) const
+{
     // prepare result
     common::pmr::vector<DbObject> objects{allocatorFactory->dataAllocator<DbObject>()};
 
     // if keys not found then return empty result
-    if (indexKeys->empty())
+    if (indexKeys.empty())
     {
         return objects;
     }
@@ -108,85 +141,172 @@ Result<common::pmr::vector<DbObject>> FindT::operator ()(
         dataunit::WireBufSolid buf;
         ROCKSDB_NAMESPACE::ReadOptions readOptions=handler.p()->readOptions;
         readOptions.snapshot=snapshot;
-        objects.reserve(indexKeys->size());
-        for (auto&& key: indexKeys.value())
-        {
-            // get object from rocksdb            
-            auto k=Keys::objectKeyFromIndexValue(key.value.data(),key.value.size());
+        readOptions.async_io=handler.p()->multiGetAsyncIo;
+        objects.reserve(indexKeys.size());
 
-//! @maybe Log debug
-#if 0
-            std::cout<<"Find: index key "<< logKey(key.key)<<" object key " << logKey(k) << std::endl;
-#endif
-            auto pushLogKey=[&k,&key]()
+        // read objects in batches keeping order of index keys
+        const size_t batchSize=(std::min)(indexKeys.size(),MultiGetBatchSize);
+        std::vector<const index_key_search::IndexKey*> batchKeys;
+        std::vector<ROCKSDB_NAMESPACE::Slice> objectKeys;
+        std::vector<ROCKSDB_NAMESPACE::PinnableSlice> values(batchSize);
+        std::vector<ROCKSDB_NAMESPACE::Status> statuses(batchSize);
+        std::vector<size_t> order;
+        batchKeys.reserve(batchSize);
+        objectKeys.reserve(batchSize);
+        order.reserve(batchSize);
+
+        auto readBatch=[&]()
+        {
+            // group keys by partition, MultiGet sorts keys within column family
+            order.resize(batchKeys.size());
+            for (size_t i=0;i<order.size();i++)
             {
-                HATN_CTX_SCOPE_PUSH("obj_key",lib::toStringView(logKey(k)))
-                HATN_CTX_SCOPE_PUSH("idx_key",lib::toStringView(logKey(key.key)))
-                if (!key.partition->range.isNull())
+                order[i]=i;
+            }
+            std::stable_sort(order.begin(),order.end(),
+                [&batchKeys](size_t l, size_t r)
                 {
-                    HATN_CTX_SCOPE_PUSH("db_partition",key.partition->range)
+                    return batchKeys[l]->partition<batchKeys[r]->partition;
                 }
-            };
+            );
+            objectKeys.clear();
+            for (auto&& idx: order)
+            {
+                const auto* key=batchKeys[idx];
+                objectKeys.push_back(Keys::objectKeyFromIndexValue(key->value.data(),key->value.size()));
+            }
 
-            ROCKSDB_NAMESPACE::PinnableSlice value;
-            auto status=handler.p()->db->Get(readOptions,key.partition->dataCf(model.isBlob()),k,&value);
-            if (!status.ok())
+            // invoke MultiGet for each partition
+            size_t groupStart=0;
+            while (groupStart<order.size())
             {
-                pushLogKey();
-                if (status.code()!=ROCKSDB_NAMESPACE::Status::Code::kNotFound)
+                auto* partition=batchKeys[order[groupStart]]->partition;
+                size_t groupEnd=groupStart+1;
+                while (groupEnd<order.size() && batchKeys[order[groupEnd]]->partition==partition)
                 {
-                    HATN_CTX_SCOPE_ERROR("get-object")
-                    return makeError(DbError::READ_FAILED,status);
+                    groupEnd++;
                 }
-                HATN_CTX_WARN("missing object in rocksdb")
-                HATN_CTX_SCOPE_POP()
-                HATN_CTX_SCOPE_POP()
-                if (!key.partition->range.isNull())
-                {
-                    HATN_CTX_SCOPE_POP()
-                }
-                continue;
+
+                handler.p()->db->MultiGet(readOptions,
+                                          partition->dataCf(model.isBlob()),
+                                          groupEnd-groupStart,
+                                          &objectKeys[groupStart],
+                                          &values[groupStart],
+                                          &statuses[groupStart]
+                                          );
+                groupStart=groupEnd;
             }
-            if (TtlMark::isExpired(value))
+
+            // restore order of index keys
+            std::vector<size_t> positions(order.size());
+            for (size_t i=0;i<order.size();i++)
             {
-                pushLogKey();
-                HATN_CTX_DEBUG(1,"object expired in rocksdb")
-                HATN_CTX_SCOPE_POP()
-                HATN_CTX_SCOPE_POP()
-                if (!key.partition->range.isNull())
-                {
-                    HATN_CTX_SCOPE_POP()
-                }
-                continue;
+                positions[order[i]]=i;
             }
 
-            auto addToResult=[&](auto&& sharedUnit)
+            for (size_t i=0;i<batchKeys.size();i++)
             {
-                // deserialize object
-                auto objSlice=TtlMark::stripTtlMark(value);
-                buf.loadInline(objSlice.data(),objSlice.size());
-                dataunit::io::deserialize(*sharedUnit,buf,ec);
-                if (ec)
+                const auto& key=*batchKeys[i];
+                auto pos=positions[i];
+                const auto& k=objectKeys[pos];
+                auto& value=values[pos];
+                const auto& status=statuses[pos];
+
+//! @maybe Log debug
+#if 0
+                std::cout<<"Find: index key "<< logKey(key.key)<<" object key " << logKey(k) << std::endl;
+#endif
+                auto pushLogKey=[&k,&key]()
+                {
+                    HATN_CTX_SCOPE_PUSH("obj_key",lib::toStringView(logKey(k)))
+                    HATN_CTX_SCOPE_PUSH("idx_key",lib::toStringView(logKey(key.key)))
+                    if (!key.partition->range.isNull())
+                    {
+                        HATN_CTX_SCOPE_PUSH("db_partition",key.partition->range)
+                    }
+                };
+
+                if (!status.ok())
                 {
                     pushLogKey();
-                    HATN_CTX_SCOPE_ERROR("deserialize-object")
-                    return ec;
+                    if (status.code()!=ROCKSDB_NAMESPACE::Status::Code::kNotFound)
+                    {
+                        HATN_CTX_SCOPE_ERROR("get-object")
+                        return makeError(DbError::READ_FAILED,status);
+                    }
+                    HATN_CTX_WARN("missing object in rocksdb")
+                    HATN_CTX_SCOPE_POP()
+                    HATN_CTX_SCOPE_POP()
+                    if (!key.partition->range.isNull())
+                    {
+                        HATN_CTX_SCOPE_POP()
+                    }
+                    continue;
                 }
+                if (TtlMark::isExpired(value))
+                {
+                    pushLogKey();
+                    HATN_CTX_DEBUG(1,"object expired in rocksdb")
+                    HATN_CTX_SCOPE_POP()
+                    HATN_CTX_SCOPE_POP()
+                    if (!key.partition->range.isNull())
+                    {
+                        HATN_CTX_SCOPE_POP()
+                    }
+                    continue;
+                }
+
+                auto addToResult=[&](auto&& sharedUnit)
+                {
+                    // deserialize object
+                    auto objSlice=TtlMark::stripTtlMark(value);
+                    buf.loadInline(objSlice.data(),objSlice.size());
+                    dataunit::io::deserialize(*sharedUnit,buf,ec);
+                    if (ec)
+                    {
+                        pushLogKey();
+                        HATN_CTX_SCOPE_ERROR("deserialize-object")
+                        return ec;
+                    }
 
 //! @maybe Log debug
 #if 0
-                std::cout<<"Find: object appended to result, topic: " << key.topic().topic() << std::endl;
+                    std::cout<<"Find: object appended to result, topic: " << key.topic().topic() << std::endl;
 #endif
-                // emplace wrapped unit to result vector
-                objects.emplace_back(std::move(sharedUnit),key.topic());
+                    // emplace wrapped unit to result vector
+                    objects.emplace_back(std::move(sharedUnit),key.topic());
+
+                    return Error{};
+                };
+
+                // create unit
+                auto sharedUnit=allocatorFactory->createObject<typename ModelT::ManagedType>(allocatorFactory);
+                sharedUnit->setParseToSharedArrays(query.isParseToSharedArrays(),allocatorFactory);
+                ec=addToResult(std::move(sharedUnit));
+                HATN_CHECK_EC(ec)
+            }
 
-                return Error{};
-            };
+            // release pinned values before next batch
+            for (size_t i=0;i<batchKeys.size();i++)
+            {
+                values[i].Reset();
+            }
+            batchKeys.clear();
+            return Error{};
+        };
 
-            // create unit
-            auto sharedUnit=allocatorFactory->createObject<typename ModelT::ManagedType>(allocatorFactory);
-            sharedUnit->setParseToSharedArrays(idxQuery.query.isParseToSharedArrays(),allocatorFactory);
-            ec=addToResult(std::move(sharedUnit));
+        for (auto&& key: indexKeys)
+        {
+            batchKeys.push_back(&key);
+            if (batchKeys.size()==batchSize)
+            {
+                ec=readBatch();
+                HATN_CHECK_EC(ec)
+            }
+        }
+        if (!batchKeys.empty())
+        {
+            ec=readBatch();
             HATN_CHECK_EC(ec)
         }
     }
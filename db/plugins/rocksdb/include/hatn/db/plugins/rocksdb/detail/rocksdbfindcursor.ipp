@@ -0,0 +1,220 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+
+/** @file db/plugins/rocksdb/detail/rocksdbfindcursor.ipp
+  *
+  *   RocksDB database template for finding objects page by page with cursor.
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNROCKSDBFINDCURSOR_IPP
+#define HATNROCKSDBFINDCURSOR_IPP
+
+#include <memory>
+#include <algorithm>
+
+#include "rocksdb/snapshot.h"
+
+#include <hatn/logcontext/contextlogger.h>
+
+#include <hatn/db/dberror.h>
+#include <hatn/db/index.h>
+#include <hatn/db/model.h>
+#include <hatn/db/indexquery.h>
+#include <hatn/db/findcursor.h>
+
+#include <hatn/db/plugins/rocksdb/rocksdberror.h>
+#include <hatn/db/plugins/rocksdb/rocksdbhandler.h>
+#include <hatn/db/plugins/rocksdb/ttlmark.h>
+#include <hatn/db/plugins/rocksdb/indexkeysearch.h>
+
+#include <hatn/db/plugins/rocksdb/detail/rocksdbhandler.ipp>
+#include <hatn/db/plugins/rocksdb/detail/querypartitions.ipp>
+#include <hatn/db/plugins/rocksdb/detail/rocksdbfind.ipp>
+
+HATN_ROCKSDB_NAMESPACE_BEGIN
+
+/**
+ * @brief RocksDB cursor keeping snapshot, partitions and continuation key of the last page.
+ */
+class RocksdbFindCursor : public FindCursor
+{
+    public:
+
+        RocksdbFindCursor(
+                QueryFn query,
+                std::string modelIndexId,
+                RocksdbHandler& handler
+            ) : FindCursor(std::move(query),std::move(modelIndexId)),
+                withPartitionQuery(false),
+                snapshot(std::make_unique<ROCKSDB_NAMESPACE::ManagedSnapshot>(handler.p()->db)),
+                hasLastKey(false)
+        {}
+
+        const index_key_search::IndexKey* continuationKey() const noexcept
+        {
+            return hasLastKey ? &lastKey : nullptr;
+        }
+
+        /**
+         * @brief Keep the last key of fetched page as continuation key or close the cursor if the page is not full.
+         */
+        void pageFetched(const index_key_search::IndexKeys& keys, size_t limit)
+        {
+            addFetchedCount(keys.size());
+            if (keys.size()<limit)
+            {
+                close();
+                return;
+            }
+
+            lastKey=*keys.rbegin();
+            // topic of the key can refer to the data of the page, it is not used in comparison
+            lastKey.keyTopic=Topic{};
+            hasLastKey=true;
+        }
+
+        index_key_search::Partitions partitions;
+        bool withPartitionQuery;
+        std::unique_ptr<ROCKSDB_NAMESPACE::ManagedSnapshot> snapshot;
+
+    protected:
+
+        void doClose() override
+        {
+            snapshot.reset();
+            partitions.clear();
+        }
+
+    private:
+
+        index_key_search::IndexKey lastKey;
+        bool hasLastKey;
+};
+
+struct OpenFindCursorT
+{
+    template <typename ModelT>
+    Result<std::shared_ptr<FindCursor>> operator ()(
+        const ModelT& model,
+        RocksdbHandler& handler,
+        FindCursor::QueryFn query,
+        const std::string& modelIndexId
+    ) const;
+};
+constexpr OpenFindCursorT OpenFindCursor{};
+
+template <typename ModelT>
+Result<std::shared_ptr<FindCursor>> OpenFindCursorT::operator ()(
+        const ModelT& model,
+        RocksdbHandler& handler,
+        FindCursor::QueryFn query,
+        const std::string& modelIndexId
+    ) const
+{
+    HATN_CTX_SCOPE("openfindcursor")
+    HATN_CTX_SCOPE_PUSH("coll",model.collection())
+
+    // make cursor with snapshot lease
+    auto cursor=std::make_shared<RocksdbFindCursor>(std::move(query),modelIndexId,handler);
+
+    // collect partitions once for all pages
+    auto idxQuery=cursor->modelIndexQuery();
+    cursor->withPartitionQuery=index_key_search::queryPartitions(cursor->partitions,model,handler,idxQuery);
+
+    // register cursor in handler to close it and release the snapshot when database is closed
+    std::shared_ptr<FindCursor> result{std::move(cursor)};
+    handler.p()->addCursor(result);
+    return result;
+}
+
+struct FetchCursorT
+{
+    template <typename ModelT>
+    Result<common::pmr::vector<DbObject>> operator ()(
+        const ModelT& model,
+        RocksdbHandler& handler,
+        FindCursor& cursor,
+        size_t pageSize,
+        const AllocatorFactory* allocatorFactory
+    ) const;
+};
+constexpr FetchCursorT FetchCursor{};
+
+template <typename ModelT>
+Result<common::pmr::vector<DbObject>> FetchCursorT::operator ()(
+        const ModelT& model,
+        RocksdbHandler& handler,
+        FindCursor& findCursor,
+        size_t pageSize,
+        const AllocatorFactory* allocatorFactory
+    ) const
+{
+    HATN_CTX_SCOPE("fetchcursor")
+    HATN_CTX_SCOPE_PUSH("coll",model.collection())
+
+    auto& cursor=static_cast<RocksdbFindCursor&>(findCursor);
+    if (cursor.isFinished())
+    {
+        return common::pmr::vector<DbObject>{allocatorFactory->dataAllocator<DbObject>()};
+    }
+
+    // figure out limit of the page
+    const auto& query=cursor.query();
+    size_t limit=(pageSize==0) ? IndexQuery::DefaultLimit : pageSize;
+    if (query.limit()!=0)
+    {
+        auto fetched=(std::min)(query.limit(),cursor.fetchedCount());
+        limit=(std::min)(limit,query.limit()-fetched);
+        if (limit==0)
+        {
+            cursor.close();
+            return common::pmr::vector<DbObject>{allocatorFactory->dataAllocator<DbObject>()};
+        }
+    }
+
+    // query of the page, offset is applied only to the first page, next pages start after the continuation key
+    IndexQuery pageQuery{query};
+    pageQuery.setLimit(limit);
+    const auto* after=cursor.continuationKey();
+    if (after!=nullptr)
+    {
+        pageQuery.setOffset(0);
+    }
+    ModelIndexQuery idxQuery{pageQuery,cursor.modelIndexId()};
+
+    // collect index keys of the page
+    const auto* snapshot=cursor.snapshot->snapshot();
+    TtlMark::refreshCurrentTimepoint();
+    auto indexKeys=index_key_search::indexKeys(snapshot,
+                                                 handler,
+                                                 model.modelIdStr(),
+                                                 idxQuery,
+                                                 cursor.partitions,
+                                                 allocatorFactory,
+                                                 false,
+                                                 cursor.withPartitionQuery,
+                                                 after
+                                                 );
+    HATN_CHECK_RESULT(indexKeys)
+
+    // read objects of the page
+    auto objects=Find.readObjects(model,handler,pageQuery,indexKeys.value(),snapshot,allocatorFactory);
+    HATN_CHECK_RESULT(objects)
+
+    cursor.pageFetched(indexKeys.value(),limit);
+    return objects;
+}
+
+HATN_ROCKSDB_NAMESPACE_END
+
+#endif // HATNROCKSDBFINDCURSOR_IPP
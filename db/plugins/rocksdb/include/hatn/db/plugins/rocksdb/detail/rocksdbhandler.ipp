@@ -21,6 +21,9 @@
 
 #include <map>
 #include <map>
+#include <mutex>
+#include <vector>
+#include <memory>
 
 #include <rocksdb/db.h>
 #include <rocksdb/utilities/transaction_db.h>
@@ -30,9 +33,11 @@
 #include <hatn/common/daterange.h>
 #include <hatn/common/stdwrappers.h>
 #include <hatn/common/flatmap.h>
+#include <hatn/common/threadpoolwithqueues.h>
 
 #include <hatn/db/dberror.h>
 #include <hatn/db/transaction.h>
+#include <hatn/db/findcursor.h>
 
 #include <hatn/db/plugins/rocksdb/rocksdbschemadef.h>
 #include <hatn/db/plugins/rocksdb/rocksdbschema.h>
@@ -196,6 +201,25 @@ class HATN_ROCKSDB_SCHEMA_EXPORT RocksdbHandler_p
 
 
         bool blobEnabled;
+        bool multiGetAsyncIo;
+
+        //! Write updates that do not touch indexed fields as merge operands instead of read-modify-write
+        bool mergeUpdate;
+
+        //! Pool for parallel scanning of partitions and topics in index queries, null if disabled
+        std::unique_ptr<common::ThreadPoolWithQueues<common::Task>> searchPool;
+
+        /**
+         * @brief Register open find cursor.
+         *
+         * Cursors keep snapshots of the database, so they are closed before the database is closed.
+         */
+        void addCursor(const std::shared_ptr<FindCursor>& cursor);
+
+        /**
+         * @brief Close all open find cursors and release their snapshots.
+         */
+        void closeCursors();
 
         Result<std::shared_ptr<RocksdbPartition>> partition(uint32_t partitionKey) const noexcept
         {
@@ -208,6 +232,11 @@ class HATN_ROCKSDB_SCHEMA_EXPORT RocksdbHandler_p
             }
             return *it;
         }
+
+    private:
+
+        std::mutex m_cursorsMutex;
+        std::vector<std::weak_ptr<FindCursor>> m_cursors;
 };
 
 //---------------------------------------------------------------
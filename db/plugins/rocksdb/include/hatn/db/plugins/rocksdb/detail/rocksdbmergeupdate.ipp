@@ -0,0 +1,264 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+
+/** @file db/plugins/rocksdb/detail/rocksdbmergeupdate.ipp
+  *
+  *   RocksDB database template for updating object with merge operands.
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNROCKSDBMERGEUPDATE_IPP
+#define HATNROCKSDBMERGEUPDATE_IPP
+
+#include <hatn/logcontext/contextlogger.h>
+
+#include <hatn/dataunit/visitors.h>
+#include <hatn/dataunit/wirebufsolid.h>
+
+#include <hatn/db/dberror.h>
+#include <hatn/db/topic.h>
+#include <hatn/db/update.h>
+#include <hatn/db/updateserialization.h>
+#include <hatn/db/ipp/updateunit.ipp>
+#include <hatn/db/ipp/updateserialization.ipp>
+
+#include <hatn/db/plugins/rocksdb/rocksdberror.h>
+#include <hatn/db/plugins/rocksdb/rocksdbhandler.h>
+#include <hatn/db/plugins/rocksdb/ttlmark.h>
+#include <hatn/db/plugins/rocksdb/mergeobject.h>
+
+#include <hatn/db/plugins/rocksdb/detail/rocksdbhandler.ipp>
+#include <hatn/db/plugins/rocksdb/detail/rocksdbkeys.ipp>
+#include <hatn/db/plugins/rocksdb/detail/objectpartition.ipp>
+#include <hatn/db/plugins/rocksdb/detail/rocksdbtransaction.ipp>
+#include <hatn/db/plugins/rocksdb/rocksdbmodelt.h>
+#include <hatn/db/plugins/rocksdb/ipp/rocksdbmodelt.ipp>
+
+HATN_ROCKSDB_NAMESPACE_BEGIN
+
+/**
+ * @brief Write update request of object as merge operand.
+ *
+ * Returns false if the request can not be merged and must be applied with read-modify-write.
+ * Existence of the object is not checked, merge without existing object results in expired object
+ * that is dropped on compaction.
+ */
+struct MergeUpdateObjectT
+{
+    template <typename ModelT, typename DateT>
+    Result<bool> operator ()(const ModelT& model,
+                             RocksdbHandler& handler,
+                             Topic topic,
+                             const ObjectId& objectId,
+                             const update::Request& request,
+                             const DateT& date,
+                             const AllocatorFactory* allocatorFactory,
+                             Transaction* tx
+                             ) const;
+};
+constexpr MergeUpdateObjectT MergeUpdateObject{};
+
+template <typename ModelT, typename DateT>
+Result<bool> MergeUpdateObjectT::operator ()(
+        const ModelT& model,
+        RocksdbHandler& handler,
+        Topic topic,
+        const ObjectId& objectId,
+        const update::Request& request,
+        const DateT& date,
+        const AllocatorFactory* factory,
+        Transaction* intx
+    ) const
+{
+    using modelType=std::decay_t<ModelT>;
+
+    if (!handler.p()->mergeUpdate || model.isBlob() || !RocksdbModelT<modelType>::checkMergeable(request))
+    {
+        return false;
+    }
+
+    HATN_CTX_SCOPE("mergeupdateobject")
+    HATN_CTX_SCOPE_PUSH("coll",model.collection())
+    HATN_CTX_SCOPE_PUSH("topic",topic.topic())
+    auto idData=objectId.toArray();
+    auto idDataStr=lib::string_view{idData.data(),idData.size()};
+    HATN_CTX_SCOPE_PUSH("oid",idDataStr)
+
+    // eval partition
+    const auto partition=objectPartition(handler,model,objectId,date);
+    if (!partition)
+    {
+        return dbError(DbError::PARTITION_NOT_FOUND);
+    }
+    if (!partition->range.isNull())
+    {
+        HATN_CTX_SCOPE_PUSH("partition",partition->range)
+    }
+
+    // construct key
+    Keys keys{factory};
+    ROCKSDB_NAMESPACE::Slice objectIdS{idData.data(),idData.size()};
+    auto objKeyVal=keys.makeObjectKeyValue(model.modelIdStr(),topic.topic(),objectIdS);
+    auto key=keys.objectKeySolid(objKeyVal);
+
+    HATN_CTX_DEBUG_RECORDS(50,"merge update", {"objectkey",logKey(key)});
+
+    // validate request on empty object because merge operator can not report errors
+    {
+        auto obj=factory->createObject<typename modelType::ManagedType>(factory);
+        auto ec=update::ApplyRequest(obj.get(),request);
+        HATN_CHECK_EC(ec)
+    }
+
+    // serialize operand
+    std::string operand;
+    auto ec=MergeObject::serializeOperand(request,common::DateTime::currentUtc(),operand);
+    if (ec)
+    {
+        HATN_CTX_SCOPE_ERROR("serialize-operand")
+        return ec;
+    }
+
+    // write operand
+    ROCKSDB_NAMESPACE::Status status;
+    if (intx!=nullptr)
+    {
+        status=RocksdbTransaction::native(intx)->Merge(partition->dataCf(),key,operand);
+    }
+    else
+    {
+        status=handler.p()->db->Merge(handler.p()->writeOptions,partition->dataCf(),key,operand);
+    }
+    if (!status.ok())
+    {
+        HATN_CTX_SCOPE_ERROR("merge")
+        return makeError(DbError::WRITE_OBJECT_FAILED,status);
+    }
+
+    // done
+    return true;
+}
+
+/**
+ * @brief Apply merge operands of update requests to serialized object.
+ *
+ * Invoked by MergeObject on read and compaction. Operands that can not be parsed or applied are skipped.
+ * Returns false if the existing object can not be parsed or serialized, then merge of MergeObject fails with corruption.
+ */
+struct MergeUpdateT
+{
+    template <typename ModelT>
+    bool operator ()(const ModelT& model,
+                     const ROCKSDB_NAMESPACE::Slice* existingValue,
+                     const std::vector<ROCKSDB_NAMESPACE::Slice>& operands,
+                     std::string* newValue,
+                     const AllocatorFactory* allocatorFactory
+                    ) const;
+};
+constexpr MergeUpdateT MergeUpdate{};
+
+template <typename ModelT>
+bool MergeUpdateT::operator ()(
+        const ModelT&,
+        const ROCKSDB_NAMESPACE::Slice* existingValue,
+        const std::vector<ROCKSDB_NAMESPACE::Slice>& operands,
+        std::string* newValue,
+        const AllocatorFactory* factory
+    ) const
+{
+    using modelType=std::decay_t<ModelT>;
+
+    // object was deleted or never existed, keep it as expired to be dropped on compaction
+    if (existingValue==nullptr)
+    {
+        MergeObject::missingObjectValue(newValue);
+        return true;
+    }
+
+    // expired object is not updated
+    if (TtlMark::isExpired(*existingValue,TtlMark::nowTimepoint()))
+    {
+        newValue->assign(existingValue->data(),existingValue->size());
+        return true;
+    }
+
+    // deserialize object
+    Error ec;
+    auto obj=factory->createObject<typename modelType::ManagedType>(factory);
+    auto objSlice=TtlMark::stripTtlMark(*existingValue);
+    auto ttlMarkSlice=TtlMark::ttlMark(*existingValue);
+    {
+        dataunit::WireBufSolid buf{objSlice.data(),objSlice.size(),true};
+        if (!dataunit::io::deserialize(*obj,buf,ec))
+        {
+            return false;
+        }
+    }
+
+    // apply operands in order of writing
+    common::DateTime updatedAt;
+    bool applied=false;
+    for (auto&& operand: operands)
+    {
+        ROCKSDB_NAMESPACE::Slice msgSlice;
+        common::DateTime operandUpdatedAt;
+        if (!MergeObject::parseOperand(operand,msgSlice,operandUpdatedAt))
+        {
+            continue;
+        }
+
+        update::message::type msg;
+        dataunit::WireBufSolid msgBuf{msgSlice.data(),msgSlice.size(),true};
+        if (!dataunit::io::deserialize(msg,msgBuf,ec))
+        {
+            continue;
+        }
+
+        update::Request request;
+        common::pmr::vector<update::serialization::VectorsHolder> vectorsHolder;
+        ec=update::deserialize(msg,request,vectorsHolder,factory);
+        if (ec)
+        {
+            continue;
+        }
+
+        ec=update::ApplyRequest(obj.get(),request);
+        if (ec)
+        {
+            continue;
+        }
+        updatedAt=operandUpdatedAt;
+        applied=true;
+    }
+    if (applied)
+    {
+        obj->field(object::updated_at).set(updatedAt);
+    }
+
+    // serialize object keeping TTL mark
+    dataunit::WireBufSolid buf{factory};
+    auto size=dataunit::io::serialize(*obj,buf,ec);
+    if (ec || size<0)
+    {
+        return false;
+    }
+    newValue->reserve(buf.mainContainer()->size()+ttlMarkSlice.size());
+    newValue->assign(buf.mainContainer()->data(),buf.mainContainer()->size());
+    newValue->append(ttlMarkSlice.data(),ttlMarkSlice.size());
+
+    // done
+    return true;
+}
+
+HATN_ROCKSDB_NAMESPACE_END
+
+#endif // HATNROCKSDBMERGEUPDATE_IPP
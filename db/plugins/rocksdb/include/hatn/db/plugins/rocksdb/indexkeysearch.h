@@ -20,9 +20,13 @@
 #define HATNROCKSDBINDEXKEYSEARCH_H
 
 #include <cstddef>
+#include <array>
+#include <vector>
+#include <memory>
 
 #include "rocksdb/comparator.h"
 #include "rocksdb/snapshot.h"
+#include "rocksdb/iterator.h"
 
 #include <hatn/logcontext/contextlogger.h>
 
@@ -58,7 +62,7 @@ using KeyHandlerFn=std::function< bool (RocksdbPartition* partition,
 struct HATN_ROCKSDB_SCHEMA_EXPORT IndexKey
 {
     constexpr static const size_t FieldsOffset=2*sizeof(SeparatorCharC)+common::Crc32HexLength;
-    constexpr static const size_t KeyPartsMax=8;
+    constexpr static const size_t KeyPartsMax=16;
 
     IndexKey();
 
@@ -75,7 +79,42 @@ struct HATN_ROCKSDB_SCHEMA_EXPORT IndexKey
     KeyBuf value;
     RocksdbPartition* partition;
     size_t topicLength;
-    common::VectorOnStackT<ROCKSDB_NAMESPACE::Slice,KeyPartsMax> keyParts;
+
+    struct KeyPart
+    {
+        size_t offset=0;
+        size_t size=0;
+    };
+
+    //! Offsets and sizes of key parts in the key, offsets are used instead of slices so that keys can be copied and reused
+    std::array<KeyPart,KeyPartsMax> keyParts;
+    //! Key parts beyond KeyPartsMax
+    std::vector<KeyPart> extraKeyParts;
+    size_t keyPartsCount;
+
+    size_t keyPartsSize() const noexcept
+    {
+        return keyPartsCount;
+    }
+
+    ROCKSDB_NAMESPACE::Slice keyPart(size_t pos) const noexcept
+    {
+        const auto& part=(pos<KeyPartsMax) ? keyParts[pos] : extraKeyParts[pos-KeyPartsMax];
+        return ROCKSDB_NAMESPACE::Slice{key.data()+part.offset,part.size};
+    }
+
+    /**
+     * @brief Reset key with new data keeping allocated memory.
+     *
+     * Used to recycle nodes of bounded key sets instead of allocating new ones.
+     */
+    void reset(
+        ROCKSDB_NAMESPACE::Slice* k,
+        ROCKSDB_NAMESPACE::Slice* v,
+        const Topic& topic,
+        RocksdbPartition* p,
+        bool unique
+    );
 
     static lib::string_view keyPrefix(const lib::string_view& key, const lib::string_view& topic, size_t pos) noexcept;
 
@@ -108,14 +147,14 @@ struct IndexKeyCompare
         // compare key parts according to ordering of query fields
         for (size_t i=0;i<idxQuery->query.fields().size();i++)
         {
-            if (i>=l.keyParts.size() || i>=r.keyParts.size())
+            if (i>=l.keyPartsSize() || i>=r.keyPartsSize())
             {
                 return false;
             }
 
             const auto& field=idxQuery->query.field(i);
-            const auto& leftPart=l.keyParts[i];
-            const auto& rightPart=r.keyParts[i];
+            auto leftPart=l.keyPart(i);
+            auto rightPart=r.keyPart(i);
             int cmp{0};
             if (field.order==query::Order::Desc)
             {
@@ -140,6 +179,12 @@ struct IndexKeyCompare
 
 using IndexKeys=common::pmr::set<IndexKey,IndexKeyCompare>;
 
+/**
+ * @brief Collect sorted index keys matching the query.
+ *
+ * If the after key is set then only keys following that key in the order of the query are collected,
+ * it is used as continuation key of paged cursors. Iterators seek to the after key, so keys before it are not scanned.
+ */
 Result<IndexKeys> HATN_ROCKSDB_SCHEMA_EXPORT indexKeys(
     const ROCKSDB_NAMESPACE::Snapshot* snapshot,
     RocksdbHandler& handler,
@@ -148,9 +193,46 @@ Result<IndexKeys> HATN_ROCKSDB_SCHEMA_EXPORT indexKeys(
     const Partitions& partitions,
     const AllocatorFactory* allocatorFactory,
     bool single,
-    bool firstFieldPartitioned
+    bool firstFieldPartitioned,
+    const IndexKey* after=nullptr
 );
 
+/**
+ * @brief Iterator of cursor reused for all seeks at the same position of index fields.
+ *
+ * Bounds of the iterator point to the buffers of the slot, so the bounds can be replaced
+ * in the buffers before the next seek instead of creating a new iterator.
+ */
+struct CursorIterator
+{
+    std::unique_ptr<ROCKSDB_NAMESPACE::Iterator> it;
+
+    KeyBuf lowerBuf;
+    KeyBuf upperBuf;
+    ROCKSDB_NAMESPACE::Slice lower;
+    ROCKSDB_NAMESPACE::Slice upper;
+
+    void setLowerBound(const ROCKSDB_NAMESPACE::Slice& from)
+    {
+        lowerBuf.clear();
+        lowerBuf.append(from.data(),from.size());
+        lower=ROCKSDB_NAMESPACE::Slice{lowerBuf.data(),lowerBuf.size()};
+    }
+
+    void setUpperBound(const ROCKSDB_NAMESPACE::Slice& to)
+    {
+        upperBuf.clear();
+        upperBuf.append(to.data(),to.size());
+        upper=ROCKSDB_NAMESPACE::Slice{upperBuf.data(),upperBuf.size()};
+    }
+
+    void setBounds(const ROCKSDB_NAMESPACE::Slice& from, const ROCKSDB_NAMESPACE::Slice& to)
+    {
+        setLowerBound(from);
+        setUpperBound(to);
+    }
+};
+
 struct Cursor
 {
     Cursor(
@@ -163,7 +245,9 @@ struct Cursor
             pos(0),
             indexId(indexId),
             topic(std::move(topic)),
-            partition(partition)
+            partition(partition),
+            continuationKey(nullptr),
+            continuationPos(0)
     {
         keyPrefix.append(this->topic.topic());
         keyPrefix.append(SeparatorCharStr);
@@ -222,6 +306,29 @@ struct Cursor
     Topic topic;
 
     RocksdbPartition* partition;
+
+    //! Continuation key of paged cursor, iterators seek to this key instead of scanning keys before it
+    const IndexKey* continuationKey;
+
+    //! Number of leading fields of current key prefix that are equal to fields of continuation key
+    size_t continuationPos;
+
+    //! Iterators for each position of index fields
+    std::vector<std::unique_ptr<CursorIterator>> iterators;
+
+    CursorIterator* iterator(size_t fieldPos)
+    {
+        if (iterators.size()<=fieldPos)
+        {
+            iterators.resize(fieldPos+1);
+        }
+        auto& iterator=iterators[fieldPos];
+        if (!iterator)
+        {
+            iterator=std::make_unique<CursorIterator>();
+        }
+        return iterator.get();
+    }
 };
 
 Error HATN_ROCKSDB_SCHEMA_EXPORT nextKeyField(
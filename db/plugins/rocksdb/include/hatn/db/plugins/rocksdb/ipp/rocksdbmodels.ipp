@@ -29,10 +29,12 @@
 #include <hatn/db/plugins/rocksdb/detail/rocksdbreadobject.ipp>
 #include <hatn/db/plugins/rocksdb/detail/rocksdbfind.ipp>
 #include <hatn/db/plugins/rocksdb/detail/rocksdbfindcb.ipp>
+#include <hatn/db/plugins/rocksdb/detail/rocksdbfindcursor.ipp>
 #include <hatn/db/plugins/rocksdb/detail/rocksdbdelete.ipp>
 #include <hatn/db/plugins/rocksdb/detail/rocksdbdeletemany.ipp>
 #include <hatn/db/plugins/rocksdb/detail/rocksdbupdate.ipp>
 #include <hatn/db/plugins/rocksdb/detail/rocksdbupdatemany.ipp>
+#include <hatn/db/plugins/rocksdb/detail/rocksdbmergeupdate.ipp>
 #include <hatn/db/plugins/rocksdb/detail/rocksdbcount.ipp>
 
 #include <hatn/db/plugins/rocksdb/rocksdbmodelt.h>
@@ -45,6 +47,7 @@ HATN_ROCKSDB_NAMESPACE_BEGIN
 template <typename ModelT>
 void RocksdbModels::unregisterModel(std::shared_ptr<ModelWithInfo<ModelT>> model)
 {
+    common::lib::unique_lock<common::lib::shared_mutex> l{m_mutex};
     m_models.erase(model->info->modelId());
 }
 
@@ -55,9 +58,12 @@ void RocksdbModels::registerModel(std::shared_ptr<ModelWithInfo<ModelT>> model,
 #if 0
     Assert(m_models.find(model->info->modelId())==m_models.end(),"Failed to register duplicate model");
 #else
-    if (m_models.find(model->info->modelId())!=m_models.end())
     {
-        return;
+        common::lib::shared_lock<common::lib::shared_mutex> l{m_mutex};
+        if (m_models.find(model->info->modelId())!=m_models.end())
+        {
+            return;
+        }
     }
 #endif
 
@@ -75,6 +81,16 @@ void RocksdbModels::registerModel(std::shared_ptr<ModelWithInfo<ModelT>> model,
         return CreateObject(model->model,handler,topic,obj,allocatorFactory,tx);
     };
 
+    rdbModel->createMany=[model,allocatorFactory]
+        (RocksdbHandler& handler, Topic topic, const std::vector<const dataunit::Unit*>& objects, std::vector<Error>* objectErrors, Transaction* tx)
+    {
+        auto castFn=[](const dataunit::Unit* object)
+        {
+            return sample.castToUnit(object);
+        };
+        return CreateMany(model->model,handler,topic,objects,castFn,objectErrors,allocatorFactory,tx);
+    };
+
     rdbModel->readObject=[model,allocatorFactory]
         (
             RocksdbHandler& handler,
@@ -132,6 +148,26 @@ void RocksdbModels::registerModel(std::shared_ptr<ModelWithInfo<ModelT>> model,
         return FindCbOp(model->model,handler,query,cb,allocatorFactory,tx,forUpdate);
     };
 
+    rdbModel->openFindCursor=[model]
+        (
+            RocksdbHandler& handler,
+            FindCursor::QueryFn query,
+            const std::string& modelIndexId
+        )
+    {
+        return OpenFindCursor(model->model,handler,std::move(query),modelIndexId);
+    };
+
+    rdbModel->fetchCursor=[model,allocatorFactory]
+        (
+            RocksdbHandler& handler,
+            FindCursor& cursor,
+            size_t pageSize
+        )
+    {
+        return FetchCursor(model->model,handler,cursor,pageSize,allocatorFactory);
+    };
+
     rdbModel->deleteObject=[model,allocatorFactory]
         (
             RocksdbHandler& handler,
@@ -193,6 +229,41 @@ void RocksdbModels::registerModel(std::shared_ptr<ModelWithInfo<ModelT>> model,
         return UpdateObject(model->model,handler,topic,objectId,request,hana::false_c,modifyReturn,allocatorFactory,tx);
     };
 
+    rdbModel->mergeUpdateObjectWithDate=[model,allocatorFactory]
+        (
+             RocksdbHandler& handler,
+             Topic topic,
+             const ObjectId& objectId,
+             const update::Request& request,
+             const HATN_COMMON_NAMESPACE::Date& date,
+             Transaction* tx
+        )
+    {
+        return MergeUpdateObject(model->model,handler,topic,objectId,request,date,allocatorFactory,tx);
+    };
+
+    rdbModel->mergeUpdateObject=[model,allocatorFactory]
+        (
+            RocksdbHandler& handler,
+            Topic topic,
+            const ObjectId& objectId,
+            const update::Request& request,
+            Transaction* tx
+            )
+    {
+        return MergeUpdateObject(model->model,handler,topic,objectId,request,hana::false_c,allocatorFactory,tx);
+    };
+
+    rdbModel->mergeUpdate=[model,allocatorFactory]
+        (
+            const ROCKSDB_NAMESPACE::Slice* existingValue,
+            const std::vector<ROCKSDB_NAMESPACE::Slice>& operands,
+            std::string* newValue
+        )
+    {
+        return MergeUpdate(model->model,existingValue,operands,newValue,allocatorFactory);
+    };
+
     rdbModel->updateMany=[model,allocatorFactory]
         (
            RocksdbHandler& handler,
@@ -270,7 +341,9 @@ void RocksdbModels::registerModel(std::shared_ptr<ModelWithInfo<ModelT>> model,
     using mType=std::decay_t<decltype(model->model)>;
     RocksdbModelT<mType>::init(model->model);
 
-    m_models[model->info->modelId()]=std::move(rdbModel);
+    // models are read by merge operators in threads of RocksDB
+    common::lib::unique_lock<common::lib::shared_mutex> l{m_mutex};
+    m_models.emplace(model->info->modelId(),std::move(rdbModel));
 }
 
 HATN_ROCKSDB_NAMESPACE_END
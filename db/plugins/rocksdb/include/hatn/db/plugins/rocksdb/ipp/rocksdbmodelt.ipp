@@ -130,4 +130,82 @@ bool RocksdbModelT<ModelT>::checkTtlFieldUpdated(const update::Request& request)
 
 //---------------------------------------------------------------
 
+template <typename ModelT>
+bool RocksdbModelT<ModelT>::isMergeableValueType(update::ValueType valueType) noexcept
+{
+    switch (valueType)
+    {
+        case (update::ValueType::Bool): HATN_FALLTHROUGH
+        case (update::ValueType::Int8_t): HATN_FALLTHROUGH
+        case (update::ValueType::Int16_t): HATN_FALLTHROUGH
+        case (update::ValueType::Int32_t): HATN_FALLTHROUGH
+        case (update::ValueType::Int64_t): HATN_FALLTHROUGH
+        case (update::ValueType::Uint8_t): HATN_FALLTHROUGH
+        case (update::ValueType::Uint16_t): HATN_FALLTHROUGH
+        case (update::ValueType::Uint32_t): HATN_FALLTHROUGH
+        case (update::ValueType::Uint64_t): HATN_FALLTHROUGH
+        case (update::ValueType::Float): HATN_FALLTHROUGH
+        case (update::ValueType::Double): HATN_FALLTHROUGH
+        case (update::ValueType::String): HATN_FALLTHROUGH
+        case (update::ValueType::DateTime): HATN_FALLTHROUGH
+        case (update::ValueType::Date): HATN_FALLTHROUGH
+        case (update::ValueType::Time): HATN_FALLTHROUGH
+        case (update::ValueType::DateRange): HATN_FALLTHROUGH
+        case (update::ValueType::ObjectId):
+            return true;
+
+        default:
+            break;
+    }
+
+    // vectors and subunits are not supported
+    return false;
+}
+
+//---------------------------------------------------------------
+
+template <typename ModelT>
+bool RocksdbModelT<ModelT>::checkMergeable(const update::Request& request) noexcept
+{
+    static FieldPath pathOfUpdatedAt{makePath(object::updated_at)};
+
+    // updated_at is set on merge, if it is a field of TTL index then TTL mark and all index keys must be rewritten,
+    // index keys of updated_at in not TTL indexes are not updated neither with read-modify-write
+    if (ttlFields.find(pathOfUpdatedAt)!=ttlFields.end())
+    {
+        return false;
+    }
+
+    for (auto&& field : request)
+    {
+        switch (field.op)
+        {
+            case (update::Operator::unset):
+                break;
+
+            case (update::Operator::set): HATN_FALLTHROUGH
+            case (update::Operator::inc):
+            {
+                if (!isMergeableValueType(field.value.typeId()))
+                {
+                    return false;
+                }
+            }
+            break;
+
+            default:
+                return false;
+        }
+
+        // comparison of field paths matches parent and nested fields of indexes too, TTL indexes are also covered by this check
+        if (updateIndexKeyExtractors.find(field.path)!=updateIndexKeyExtractors.end())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+//---------------------------------------------------------------
+
 HATN_ROCKSDB_NAMESPACE_END
@@ -0,0 +1,60 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+
+/** @file db/plugins/rocksdb/keyprefixtransform.h
+  *
+  *   RocksDB prefix extractor of object and index keys.
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNROCKSDBKEYPREFIXTRANSFORM_H
+#define HATNROCKSDBKEYPREFIXTRANSFORM_H
+
+#include <rocksdb/slice_transform.h>
+
+#include <hatn/db/plugins/rocksdb/rocksdbdriver.h>
+#include <hatn/db/plugins/rocksdb/rocksdbschemadef.h>
+
+HATN_ROCKSDB_NAMESPACE_BEGIN
+
+/**
+ * @brief Prefix extractor of keys in collection and index column families.
+ *
+ * Object keys are in format topic|model_id|object_id and index keys are in format topic|index_id|fields...,
+ * so the prefix is the topic and the model or index ID including both separators.
+ * Both IDs are fixed size hex strings, thus the same extractor fits all models and indexes of any schema.
+ * Keys of model-topic relations also fall into the domain with a single common prefix.
+ */
+class HATN_ROCKSDB_EXPORT KeyPrefixTransform : public ROCKSDB_NAMESPACE::SliceTransform
+{
+    public:
+
+        const char* Name() const override
+        {
+            return "hatn.KeyPrefixTransform.1";
+        }
+
+        ROCKSDB_NAMESPACE::Slice Transform(const ROCKSDB_NAMESPACE::Slice& key) const override;
+
+        bool InDomain(const ROCKSDB_NAMESPACE::Slice& key) const override;
+
+        /**
+         * @brief Find size of key prefix.
+         * @param key Key.
+         * @return Size of prefix including the second separator or 0 if key is not in domain.
+         */
+        static size_t prefixSize(const ROCKSDB_NAMESPACE::Slice& key) noexcept;
+};
+
+HATN_ROCKSDB_NAMESPACE_END
+
+#endif // HATNROCKSDBKEYPREFIXTRANSFORM_H
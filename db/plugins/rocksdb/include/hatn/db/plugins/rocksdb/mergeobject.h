@@ -0,0 +1,115 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+
+/** @file db/plugins/rocksdb/mergeobject.h
+  *
+  *   RocksDB merge operator of collection column family.
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNROCKSDBMERGEOBJECT_H
+#define HATNROCKSDBMERGEOBJECT_H
+
+#include <rocksdb/merge_operator.h>
+
+#include <hatn/common/datetime.h>
+
+#include <hatn/db/update.h>
+
+#include <hatn/db/plugins/rocksdb/rocksdbschemadef.h>
+#include <hatn/db/plugins/rocksdb/modeltopics.h>
+
+HATN_ROCKSDB_NAMESPACE_BEGIN
+
+/**
+ * @brief Merge operator of collection column family.
+ *
+ * Merge operands of model-topic relations are merged by MergeModelTopic.
+ * Merge operands of objects are serialized update requests that are applied to the object
+ * lazily on read and compaction, see RocksdbModel::mergeUpdate.
+ * If operands of object can not be applied then the failure is logged and merge fails,
+ * so that reads and compactions of the object report corruption and operands are not lost.
+ *
+ * Operand of object is in format: version (1 byte) | updated_at in milliseconds (8 bytes LE) | serialized update::message.
+ */
+class HATN_ROCKSDB_SCHEMA_EXPORT MergeObject : public MergeModelTopic
+{
+    public:
+
+        constexpr static const uint8_t OperandVersion=1;
+        constexpr static const size_t OperandHeaderSize=sizeof(uint8_t)+sizeof(int64_t);
+
+        //! Timepoint of TTL mark of object merged without existing value, such object is always expired.
+        constexpr static const uint32_t MissingObjectExpireAt=0x1000;
+
+        virtual bool FullMergeV2(const MergeOperationInput& merge_in,
+                                 MergeOperationOutput* merge_out) const override;
+
+        virtual bool PartialMergeMulti(const ROCKSDB_NAMESPACE::Slice& key,
+                                       const std::deque<ROCKSDB_NAMESPACE::Slice>& operand_list,
+                                       std::string* new_value, ROCKSDB_NAMESPACE::Logger* logger) const override;
+
+        virtual const char* Name() const override
+        {
+            return "MergeObject";
+        }
+
+        /**
+         * @brief Serialize update request to merge operand.
+         * @param request Update request.
+         * @param updatedAt Time of update.
+         * @param operand Result operand.
+         * @return Operation status.
+         */
+        static Error serializeOperand(
+            const update::Request& request,
+            const common::DateTime& updatedAt,
+            std::string& operand
+        );
+
+        /**
+         * @brief Parse header of merge operand.
+         * @param operand Operand.
+         * @param message Slice of serialized update::message.
+         * @param updatedAt Time of update.
+         * @return True if operand is valid.
+         */
+        static bool parseOperand(
+            const ROCKSDB_NAMESPACE::Slice& operand,
+            ROCKSDB_NAMESPACE::Slice& message,
+            common::DateTime& updatedAt
+        );
+
+        /**
+         * @brief Make value of object merged without existing value, such object is always expired.
+         * @param value Result value.
+         */
+        static void missingObjectValue(std::string* value);
+
+        /**
+         * @brief Extract model ID from object key.
+         * @param key Object key in format topic|model_id|object_id.
+         * @param modelId Model ID.
+         * @return False if key is not an object key.
+         */
+        static bool objectKeyModelId(const ROCKSDB_NAMESPACE::Slice& key, uint32_t& modelId) noexcept;
+
+        static bool isRelationKey(const ROCKSDB_NAMESPACE::Slice& key) noexcept
+        {
+            return key.size()>=ModelTopics::RelationKeyPrefix.size()
+                   && memcmp(key.data(),ModelTopics::RelationKeyPrefix.data(),ModelTopics::RelationKeyPrefix.size())==0;
+        }
+};
+
+HATN_ROCKSDB_NAMESPACE_END
+
+#endif // HATNROCKSDBMERGEOBJECT_H
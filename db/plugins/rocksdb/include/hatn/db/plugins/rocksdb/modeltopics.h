@@ -20,6 +20,7 @@
 #define HATNROCKSDBMODELTOPICS_H
 
 #include <rocksdb/merge_operator.h>
+#include <rocksdb/utilities/transaction.h>
 
 #include <hatn/common/allocatoronstack.h>
 #include <hatn/common/pmr/allocatorfactory.h>
@@ -67,14 +68,40 @@ class HATN_ROCKSDB_SCHEMA_EXPORT ModelTopics
 
         constexpr static const size_t MaxOperationSize=sizeof(Operator)+TtlMark::Size;
 
+        /**
+         * @brief Update model-topic relation.
+         * @param modelId Model ID.
+         * @param topic Topic.
+         * @param handler Database handler.
+         * @param partition Partition.
+         * @param action Operation to merge into relation.
+         * @param tx Transaction to put the merge operand to, if null then merge is written to database directly.
+         * @return Operation status.
+         *
+         * Merge operand is put to transaction untracked so that concurrent transactions in the same topic
+         * do not conflict on the relation key.
+         */
         static Error update(
             const std::string& modelId,
             Topic topic,
             RocksdbHandler& handler,
             RocksdbPartition* partition,
-            Operator action
+            Operator action,
+            ROCKSDB_NAMESPACE::Transaction* tx=nullptr
         );
 
+        /**
+         * @brief List topics of model.
+         * @param modelId Model ID.
+         * @param handler Database handler.
+         * @param partition Partition, if null then all partitions are used.
+         * @param onlyDefaultPartition Use only default partition.
+         * @param factory Allocator factory.
+         * @return Set of topics that have at least one object of the model.
+         *
+         * Only relation keys are iterated, so the cost depends on number of topics and not on number of objects.
+         * Relations with zero count that are waiting for compaction are skipped.
+         */
         static Result<common::pmr::set<Topic>> modelTopics(
             const std::string& modelId,
             RocksdbHandler& handler,
@@ -112,6 +139,33 @@ class HATN_ROCKSDB_SCHEMA_EXPORT ModelTopics
             RocksdbHandler& handler
         );
 
+        /**
+         * @brief Count objects of model in a partition using pre-aggregated counters of model-topic relations.
+         * @param modelId Model ID.
+         * @param topic Topic, if empty then objects of all topics are counted.
+         * @param handler Database handler.
+         * @param partition Partition.
+         * @return Number of objects.
+         */
+        static Result<size_t> count(
+            const std::string& modelId,
+            Topic topic,
+            RocksdbHandler& handler,
+            RocksdbPartition* partition
+        );
+
+        /**
+         * @brief Rebuild model-topic relations by scanning objects of all models in all partitions.
+         * @param handler Database handler.
+         * @return Operation status.
+         *
+         * Use it to migrate databases where relations are missing or inconsistent.
+         * The scan is slow for large databases and must not run concurrently with writes.
+         */
+        static Error rebuildRelations(
+            RocksdbHandler& handler
+        );
+
         static bool deserializeRelation(const char* data, size_t size, Relation& rel);
         static void serializeRelation(const Relation& rel, std::string* value);
 
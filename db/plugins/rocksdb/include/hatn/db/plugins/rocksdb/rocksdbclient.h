@@ -79,6 +79,12 @@ class HATN_ROCKSDB_EXPORT RocksdbClient : public Client
 
         Error doCreate(Topic topic, const ModelInfo& model, const dataunit::Unit* object, Transaction* tx) override;
 
+        Result<size_t> doCreateMany(Topic topic,
+                                    const ModelInfo& model,
+                                    const std::vector<const dataunit::Unit*>& objects,
+                                    std::vector<Error>* objectErrors,
+                                    Transaction* tx) override;
+
         Result<DbObject> doRead(Topic topic,
                                                          const ModelInfo& model,
                                                          const ObjectId& id,
@@ -106,6 +112,18 @@ class HATN_ROCKSDB_EXPORT RocksdbClient : public Client
             bool forUpdate
         ) override;
 
+        Result<std::shared_ptr<FindCursor>> doOpenFindCursor(
+            const ModelInfo& model,
+            FindCursor::QueryFn query,
+            const std::string& modelIndexId
+        ) override;
+
+        Result<HATN_COMMON_NAMESPACE::pmr::vector<DbObject>> doFetchCursor(
+            const ModelInfo& model,
+            FindCursor& cursor,
+            size_t pageSize
+        ) override;
+
         virtual Result<size_t> doCount(
             const ModelInfo& model,
             const ModelIndexQuery& query
@@ -21,6 +21,10 @@
 
 #include <memory>
 #include <functional>
+#include <vector>
+#include <string>
+
+#include <rocksdb/slice.h>
 
 #include <hatn/common/pmr/allocatorfactory.h>
 
@@ -32,6 +36,7 @@
 #include <hatn/db/transaction.h>
 #include <hatn/db/update.h>
 #include <hatn/db/find.h>
+#include <hatn/db/findcursor.h>
 
 #include <hatn/db/plugins/rocksdb/rocksdbschemadef.h>
 
@@ -59,6 +64,14 @@ class HATN_ROCKSDB_SCHEMA_EXPORT RocksdbModel : public common::pmr::WithFactory
             Transaction* tx
             )> createObject;
 
+        std::function<Result<size_t> (
+            RocksdbHandler& handler,
+            Topic topic,
+            const std::vector<const dataunit::Unit*>& objects,
+            std::vector<Error>* objectErrors,
+            Transaction* tx
+            )> createMany;
+
         std::function<Result<DbObject> (
             RocksdbHandler& handler,
             Topic topic,
@@ -122,6 +135,29 @@ class HATN_ROCKSDB_SCHEMA_EXPORT RocksdbModel : public common::pmr::WithFactory
             Transaction* tx
             )> updateObject;
 
+        std::function<Result<bool> (
+             RocksdbHandler& handler,
+             Topic topic,
+             const ObjectId& objectId,
+             const update::Request& request,
+             const HATN_COMMON_NAMESPACE::Date& date,
+             Transaction* tx
+            )> mergeUpdateObjectWithDate;
+
+        std::function<Result<bool> (
+            RocksdbHandler& handler,
+            Topic topic,
+            const ObjectId& objectId,
+            const update::Request& request,
+            Transaction* tx
+            )> mergeUpdateObject;
+
+        std::function<bool (
+            const ROCKSDB_NAMESPACE::Slice* existingValue,
+            const std::vector<ROCKSDB_NAMESPACE::Slice>& operands,
+            std::string* newValue
+            )> mergeUpdate;
+
         std::function<Result<size_t> (
             RocksdbHandler& handler,
             const ModelIndexQuery& query,
@@ -152,6 +188,18 @@ class HATN_ROCKSDB_SCHEMA_EXPORT RocksdbModel : public common::pmr::WithFactory
                 bool forUpdate
             )> findCb;
 
+        std::function<Result<std::shared_ptr<FindCursor>> (
+                RocksdbHandler& handler,
+                FindCursor::QueryFn query,
+                const std::string& modelIndexId
+            )> openFindCursor;
+
+        std::function<Result<HATN_COMMON_NAMESPACE::pmr::vector<DbObject>> (
+                RocksdbHandler& handler,
+                FindCursor& cursor,
+                size_t pageSize
+            )> fetchCursor;
+
     private:
 
         std::shared_ptr<ModelInfo> m_modelInfo;
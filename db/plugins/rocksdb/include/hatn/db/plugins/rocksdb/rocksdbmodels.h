@@ -49,9 +49,10 @@ class HATN_ROCKSDB_SCHEMA_EXPORT RocksdbModels : public common::Singleton
         template <typename ModelT>
         void unregisterModel(std::shared_ptr<ModelWithInfo<ModelT>> model);
 
-        std::shared_ptr<RocksdbModel> model(const ModelInfo& info) const
+        std::shared_ptr<RocksdbModel> model(uint32_t modelId) const
         {
-            auto it=m_models.find(info.modelId());
+            common::lib::shared_lock<common::lib::shared_mutex> l{m_mutex};
+            auto it=m_models.find(modelId);
             if (it==m_models.end())
             {
                 return std::shared_ptr<RocksdbModel>{};
@@ -59,6 +60,11 @@ class HATN_ROCKSDB_SCHEMA_EXPORT RocksdbModels : public common::Singleton
             return it->second;
         }
 
+        std::shared_ptr<RocksdbModel> model(const ModelInfo& info) const
+        {
+            return model(info.modelId());
+        }
+
         std::shared_ptr<RocksdbModel> model(const std::shared_ptr<ModelInfo>& info) const
         {
             return model(*info);
@@ -68,6 +74,7 @@ class HATN_ROCKSDB_SCHEMA_EXPORT RocksdbModels : public common::Singleton
 
         RocksdbModels();
         std::map<uint32_t,std::shared_ptr<RocksdbModel>> m_models;
+        mutable common::lib::shared_mutex m_mutex;
 };
 
 HATN_ROCKSDB_NAMESPACE_END
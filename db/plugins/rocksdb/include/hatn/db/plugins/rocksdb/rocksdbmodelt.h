@@ -108,8 +108,17 @@ class RocksdbModelT
 
         static bool checkTtlFieldUpdated(const update::Request& request) noexcept;
 
+        /**
+         * @brief Check if update request can be written as merge operand without reading the object.
+         * @param request Update request.
+         * @return True if request sets, unsets or increments only scalar fields that are not indexed.
+         */
+        static bool checkMergeable(const update::Request& request) noexcept;
+
     private:
 
+        static bool isMergeableValueType(update::ValueType valueType) noexcept;
+
         static std::multimap<FieldPath,UpdateIndexKeyExtractor<ObjectT>,FieldPathCompare> updateIndexKeyExtractors;
         static common::FlatSet<FieldPath,FieldPathCompare> ttlFields;
 };
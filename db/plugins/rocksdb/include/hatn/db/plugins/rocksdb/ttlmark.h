@@ -164,6 +164,8 @@ class HATN_ROCKSDB_SCHEMA_EXPORT TtlMark
 
         static uint32_t refreshCurrentTimepoint();
 
+        static void setCurrentTimepoint(uint32_t tp) noexcept;
+
         static bool isExpired(uint32_t tp, uint32_t currentTp=0) noexcept;
 
         static bool isExpired(const char *data, size_t size, uint32_t currentTp=0) noexcept;
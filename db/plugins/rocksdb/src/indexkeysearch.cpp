@@ -20,6 +20,12 @@
 #define _GLIBCXX_DEBUG
 #endif
 
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+
 #include "rocksdb/comparator.h"
 
 #include <hatn/common/pmr/pmrtypes.h>
@@ -55,7 +61,7 @@ HATN_ROCKSDB_NAMESPACE_BEGIN
 namespace index_key_search
 {
 
-IndexKey::IndexKey():partition(nullptr)
+IndexKey::IndexKey():partition(nullptr),topicLength(0),keyPartsCount(0)
 {}
 
 IndexKey::IndexKey(
@@ -68,9 +74,32 @@ IndexKey::IndexKey(
         key(k->data(),k->size()),
         value(v->data(),v->size()),
         partition(p),
-        topicLength(keyTopic.topic().size())
+        topicLength(keyTopic.topic().size()),
+        keyPartsCount(0)
 {
-    keyParts.reserve(KeyPartsMax);
+    fillKeyParts(keyTopic.topic(),unique);
+}
+
+void IndexKey::reset(
+        ROCKSDB_NAMESPACE::Slice* k,
+        ROCKSDB_NAMESPACE::Slice* v,
+        const Topic& topic,
+        RocksdbPartition* p,
+        bool unique
+    )
+{
+    if (keyTopic.topic()!=topic.topic())
+    {
+        keyTopic=topic;
+    }
+    key.clear();
+    key.append(k->data(),k->size());
+    value.clear();
+    value.append(v->data(),v->size());
+    partition=p;
+    topicLength=keyTopic.topic().size();
+    keyPartsCount=0;
+    extraKeyParts.clear();
     fillKeyParts(keyTopic.topic(),unique);
 }
 
@@ -82,10 +111,16 @@ void IndexKey::fillKeyParts(const lib::string_view& topic, bool unique)
     {
         if (key[i]==SeparatorCharC)
         {
-            auto* k=key.data();
-            auto* ptr=k+offset;
-            auto count=i-offset;
-            keyParts.emplace_back(ptr,count);
+            KeyPart part{offset,i-offset};
+            if (keyPartsCount<KeyPartsMax)
+            {
+                keyParts[keyPartsCount]=part;
+            }
+            else
+            {
+                extraKeyParts.push_back(part);
+            }
+            keyPartsCount++;
             offset=i;
         }
     }
@@ -129,6 +164,19 @@ static bool filterIndex(const ModelIndexQuery& idxQuery,
     return false;
 }
 
+/**
+ * @brief Get fields of index key up to the given field position, topic and index ID are skipped.
+ */
+static lib::string_view keyFields(const lib::string_view& key, size_t topicLength, size_t pos) noexcept
+{
+    auto prefix=IndexKey::keyPrefix(key,lib::string_view{key.data(),topicLength},pos);
+    if (prefix.size()<IndexKey::FieldsOffset+topicLength)
+    {
+        return lib::string_view{};
+    }
+    return prefix.substr(IndexKey::FieldsOffset+topicLength);
+}
+
 Error iterateFieldVariant(
     Cursor& cursor,
     RocksdbHandler& handler,
@@ -325,17 +373,57 @@ Error iterateFieldVariant(
         break;
     }
 
+    // if current key prefix matches continuation key then seek to the continuation key
+    lib::string_view continuationFields;
+    KeyBuf continuationBuf;
+    ROCKSDB_NAMESPACE::Slice continuationS;
+    if (cursor.continuationKey!=nullptr && cursor.continuationPos+1==pos)
+    {
+        const auto& continuationKey=*cursor.continuationKey;
+        continuationFields=keyFields(lib::string_view{continuationKey.key.data(),continuationKey.key.size()},continuationKey.topicLength,pos);
+    }
+    if (!continuationFields.empty())
+    {
+        continuationBuf.append(cursor.indexRangeFromSlice());
+        continuationBuf.append(continuationFields);
+        if (field.order==query::Order::Desc)
+        {
+            continuationBuf.append(SeparatorCharPlusStr);
+            continuationS=ROCKSDB_NAMESPACE::Slice{continuationBuf.data(),continuationBuf.size()};
+            if (continuationS.compare(*readOptions.iterate_upper_bound)<0)
+            {
+                readOptions.iterate_upper_bound=&continuationS;
+            }
+        }
+        else
+        {
+            continuationS=ROCKSDB_NAMESPACE::Slice{continuationBuf.data(),continuationBuf.size()};
+            if (continuationS.compare(*readOptions.iterate_lower_bound)>0)
+            {
+                readOptions.iterate_lower_bound=&continuationS;
+            }
+        }
+    }
+
 //! @maybe Log debug
 #if 0
     std::cout<<"Search from "<<logKey(*readOptions.iterate_lower_bound) << " to "<<logKey(*readOptions.iterate_upper_bound)<<std::endl;
 #endif
 
+    // iterator is created once per cursor and field position and then reused with new bounds
+    auto* cursorIt=cursor.iterator(pos);
+    cursorIt->setBounds(*readOptions.iterate_lower_bound,*readOptions.iterate_upper_bound);
+    if (!cursorIt->it)
+    {
+        readOptions.iterate_lower_bound=&cursorIt->lower;
+        readOptions.iterate_upper_bound=&cursorIt->upper;
+        cursorIt->it.reset(handler.p()->db->NewIterator(readOptions,cursor.partition->indexCf.get()));
+    }
+    auto& it=cursorIt->it;
+
     auto offset=cursor.keyPrefix.size();
     while (!lastKey)
     {
-        // create iterator
-        std::unique_ptr<ROCKSDB_NAMESPACE::Iterator> it{handler.p()->db->NewIterator(readOptions,cursor.partition->indexCf.get())};
-
         // set start position of the iterator
         if (iterateForward)
         {
@@ -356,6 +444,17 @@ Error iterateFieldVariant(
             // check if key must be filtered
             //! @todo optimization: Check if filter would drop all the next keys and, thus, break iteration immediately
             bool keyFiltered=TtlMark::isExpired(keyValue) || filterIndex(idxQuery,pos,key,keyValue);
+
+            // keys with the same fields as continuation key are ordered by the whole key, drop keys up to continuation key
+            bool onContinuation=!keyFiltered
+                                  && !continuationFields.empty()
+                                  && keyFields(lib::toStringView(key),cursor.topic.size(),pos)==continuationFields;
+            if (onContinuation && lastField)
+            {
+                IndexKey foundKey{&key,&keyValue,cursor.topic,cursor.partition,idxQuery.query.index()->unique()};
+                keyFiltered=!IndexKeyCompare{idxQuery}(*cursor.continuationKey,foundKey);
+            }
+
             if (!keyFiltered)
             {
                 // construct key prefix
@@ -375,8 +474,16 @@ Error iterateFieldVariant(
                 }
                 else
                 {
-                    // process next field
+                    // process next field, next fields seek to continuation key only if current field is equal to continuation field
+                    if (onContinuation)
+                    {
+                        cursor.continuationPos=pos;
+                    }
                     ec=nextKeyField(cursor,handler,idxQuery,keyCallback,snapshot,allocatorFactory,fromS,toS);
+                    if (onContinuation)
+                    {
+                        cursor.continuationPos=pos-1;
+                    }
 
                     // if exact prefix then no more iteration needed
                     lastKey=seekExactPrefix;
@@ -413,7 +520,7 @@ Error iterateFieldVariant(
                             fromBuf.append(cursor.keyPrefix);
                             fromBuf.append(SeparatorCharPlusStr);
                             fromS=ROCKSDB_NAMESPACE::Slice{fromBuf.data(),fromBuf.size()};
-                            readOptions.iterate_lower_bound=&fromS;
+                            cursorIt->setLowerBound(fromS);
                         }
                         else
                         {
@@ -421,7 +528,7 @@ Error iterateFieldVariant(
                             toBuf.append(cursor.keyPrefix);
                             toBuf.append(SeparatorCharStr);
                             toS=ROCKSDB_NAMESPACE::Slice{toBuf.data(),toBuf.size()};
-                            readOptions.iterate_upper_bound=&toS;
+                            cursorIt->setUpperBound(toS);
                         }
 
                         // restore key prefix in cursor
@@ -848,6 +955,216 @@ Error HATN_ROCKSDB_SCHEMA_EXPORT nextKeyField(
     return OK;
 }
 
+namespace {
+
+enum class InsertStatus : uint8_t
+{
+    Inserted,
+    Duplicate,
+    BehindTail
+};
+
+/**
+ * @brief Insert key to the set bounded by maxSize.
+ * @return Status of insertion, BehindTail if the set is full and the key is behind its tail.
+ *
+ * When the set is full the node of the tail key is extracted and reused for the new key,
+ * so a scan with limit does not allocate memory per found key.
+ * If the set already contains the same object then the tail is put back and the set is not changed.
+ */
+InsertStatus insertBounded(
+        IndexKeys& keys,
+        IndexKey& scratchKey,
+        size_t maxSize,
+        ROCKSDB_NAMESPACE::Slice* key,
+        ROCKSDB_NAMESPACE::Slice* keyValue,
+        const Topic& topic,
+        RocksdbPartition* partition,
+        bool unique
+    )
+{
+    if (maxSize==0 || keys.size()<maxSize)
+    {
+        auto inserted=keys.emplace(key,keyValue,topic,partition,unique);
+        return inserted.second ? InsertStatus::Inserted : InsertStatus::Duplicate;
+    }
+
+    scratchKey.reset(key,keyValue,topic,partition,unique);
+    auto last=--keys.end();
+    if (!keys.key_comp()(scratchKey,*last))
+    {
+        return InsertStatus::BehindTail;
+    }
+
+    auto node=keys.extract(last);
+    std::swap(node.value(),scratchKey);
+    auto inserted=keys.insert(std::move(node));
+    if (!inserted.inserted)
+    {
+        // restore the tail
+        std::swap(inserted.node.value(),scratchKey);
+        keys.insert(keys.end(),std::move(inserted.node));
+        return InsertStatus::Duplicate;
+    }
+    return InsertStatus::Inserted;
+}
+
+/**
+ * @brief Cursor of parallel search.
+ *
+ * Keys of the cursor are filled in a thread of search pool, so they are allocated with default memory resource
+ * because allocator factory of the query is not required to be thread safe.
+ */
+struct ParallelCursor
+{
+    ParallelCursor(
+            Topic topic,
+            std::shared_ptr<RocksdbPartition> partition,
+            const ModelIndexQuery& idxQuery
+        ) : topic(std::move(topic)),
+            partition(std::move(partition)),
+            keys(IndexKeyCompare{idxQuery},common::pmr::polymorphic_allocator<IndexKey>{common::pmr::get_default_resource()})
+    {}
+
+    Topic topic;
+    std::shared_ptr<RocksdbPartition> partition;
+    IndexKeys keys;
+    Error ec;
+};
+
+/**
+ * @brief Scan partitions and topics concurrently in search pool and k-way merge the results.
+ *
+ * Each cursor collects at most offset+limit sorted keys, then the heads of per-cursor sets are merged
+ * into the resulting set until offset+limit keys are taken. Keys are moved to the resulting set
+ * that uses allocator of the caller.
+ */
+Error parallelIndexKeys(
+        IndexKeys& keys,
+        std::vector<ParallelCursor>& cursors,
+        const ROCKSDB_NAMESPACE::Snapshot* snapshot,
+        RocksdbHandler& handler,
+        const ModelIndexQuery& idxQuery,
+        size_t limit,
+        const IndexKey* after
+    )
+{
+    auto cursorLimit = (limit==0) ? 0 : (idxQuery.query.offset() + limit);
+    bool unique=idxQuery.query.index()->unique();
+    std::atomic<bool> failed{false};
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t pending=cursors.size();
+
+    // TTL of keys must be checked against the same timepoint as in caller thread
+    auto currentTp=TtlMark::currentTimepoint();
+
+    for (auto& parallelCursor: cursors)
+    {
+        handler.p()->searchPool->postTask(common::Task(
+            [&parallelCursor,&failed,&mutex,&cond,&pending,cursorLimit,unique,snapshot,&handler,&idxQuery,after,currentTp]()
+            {
+                TtlMark::setCurrentTimepoint(currentTp);
+
+                auto& localKeys=parallelCursor.keys;
+                IndexKey scratchKey;
+                auto cb=[&localKeys,&scratchKey,&failed,&parallelCursor,cursorLimit,unique]
+                    (RocksdbPartition* partition,
+                     const lib::string_view&,
+                     ROCKSDB_NAMESPACE::Slice* key,
+                     ROCKSDB_NAMESPACE::Slice* keyValue,
+                     Error&
+                     )
+                {
+                    if (failed.load(std::memory_order_relaxed))
+                    {
+                        return false;
+                    }
+
+                    // keys behind offset+limit of this cursor can not get into the result
+                    return insertBounded(localKeys,scratchKey,cursorLimit,key,keyValue,parallelCursor.topic,partition,unique)!=InsertStatus::BehindTail;
+                };
+
+                // allocator factory of the query must not be used in worker thread,
+                // key iteration does not allocate with it and found keys are allocated by the cursor
+                Cursor cursor(idxQuery.modelIndexId,parallelCursor.topic,parallelCursor.partition.get());
+                cursor.continuationKey=after;
+                parallelCursor.ec=nextKeyField(cursor,handler,idxQuery,cb,snapshot,nullptr,
+                                                 cursor.indexRangeFromSlice(),
+                                                 cursor.indexRangeToSlice()
+                                                 );
+                if (parallelCursor.ec)
+                {
+                    failed.store(true,std::memory_order_relaxed);
+                }
+
+                std::lock_guard<std::mutex> l{mutex};
+                if (--pending==0)
+                {
+                    cond.notify_one();
+                }
+            }
+        ));
+    }
+
+    // wait for all cursors
+    {
+        std::unique_lock<std::mutex> l{mutex};
+        cond.wait(l,[&pending](){return pending==0;});
+    }
+
+    for (const auto& parallelCursor: cursors)
+    {
+        if (parallelCursor.ec)
+        {
+            HATN_CTX_SCOPE_PUSH("topic",parallelCursor.topic.topic())
+            if (!parallelCursor.partition->range.isNull())
+            {
+                HATN_CTX_SCOPE_PUSH("partition",parallelCursor.partition->range)
+            }
+            return parallelCursor.ec;
+        }
+    }
+
+    // k-way merge of per-cursor sets
+    using Head=std::pair<IndexKeys::iterator,IndexKeys*>;
+    IndexKeyCompare comp{idxQuery};
+    auto headComp=[&comp](const Head& l, const Head& r)
+    {
+        return comp(*r.first,*l.first);
+    };
+    std::vector<Head> heads;
+    heads.reserve(cursors.size());
+    for (auto& parallelCursor: cursors)
+    {
+        if (!parallelCursor.keys.empty())
+        {
+            heads.emplace_back(parallelCursor.keys.begin(),&parallelCursor.keys);
+        }
+    }
+    std::make_heap(heads.begin(),heads.end(),headComp);
+    while (!heads.empty() && (cursorLimit==0 || keys.size()<cursorLimit))
+    {
+        std::pop_heap(heads.begin(),heads.end(),headComp);
+        auto& head=heads.back();
+        auto node=head.second->extract(head.first++);
+        keys.emplace_hint(keys.end(),std::move(node.value()));
+        if (head.first==head.second->end())
+        {
+            heads.pop_back();
+        }
+        else
+        {
+            std::push_heap(heads.begin(),heads.end(),headComp);
+        }
+    }
+
+    return OK;
+}
+
+}
+
 Result<IndexKeys> HATN_ROCKSDB_SCHEMA_EXPORT indexKeys(
         const ROCKSDB_NAMESPACE::Snapshot* snapshot,
         RocksdbHandler& handler,
@@ -856,7 +1173,8 @@ Result<IndexKeys> HATN_ROCKSDB_SCHEMA_EXPORT indexKeys(
         const Partitions& partitions,
         const AllocatorFactory* allocatorFactory,
         bool single,
-        bool withPartitionQuery
+        bool withPartitionQuery,
+        const IndexKey* after
     )
 {
     HATN_CTX_SCOPE("indexkeys")
@@ -867,11 +1185,57 @@ Result<IndexKeys> HATN_ROCKSDB_SCHEMA_EXPORT indexKeys(
 
     IndexKeys keys{IndexKeyCompare{idxQuery},allocatorFactory->dataAllocator<IndexKey>()};
 
-    auto keyCallback=[&limit,&keys,&idxQuery,
-        &partitionCount,partitionLimit,skipBeforeOffset
+    // scan partitions and topics in parallel if search pool is enabled,
+    // presorted partitions of partition query are scanned sequentially to break on limit as early as possible
+    auto& searchPool=handler.p()->searchPool;
+    if (searchPool && !withPartitionQuery && !searchPool->containsCurrentThread())
+    {
+        std::vector<ParallelCursor> cursors;
+        for (const auto& partition: partitions)
+        {
+            if (idxQuery.query.topics().empty())
+            {
+                auto topics=ModelTopics::modelTopics(modelId,handler,partition.get());
+                HATN_CHECK_RESULT(topics)
+                for (const auto& topic: topics.value())
+                {
+                    cursors.emplace_back(topic,partition,idxQuery);
+                }
+            }
+            else
+            {
+                for (const auto& topic: idxQuery.query.topics())
+                {
+                    cursors.emplace_back(topic,partition,idxQuery);
+                }
+            }
+        }
+
+        if (cursors.size()>1)
+        {
+            auto ec=parallelIndexKeys(keys,cursors,snapshot,handler,idxQuery,limit,after);
+            HATN_CHECK_EC(ec)
+
+            // cut the keys up to the offset
+            size_t offset=idxQuery.query.offset();
+            for (size_t i=0;i<offset && !keys.empty();i++)
+            {
+                keys.erase(keys.begin());
+            }
+            return keys;
+        }
+    }
+
+    // keys set is bounded by offset+limit, the tail node is recycled for the next key when the set is full
+    size_t keysLimit = (limit==0) ? 0 : partitionLimit;
+    bool unique=idxQuery.query.index()->unique();
+    IndexKey scratchKey;
+
+    auto keyCallback=[&keys,&idxQuery,&scratchKey,
+        &partitionCount,partitionLimit,skipBeforeOffset,keysLimit,unique
         ]
         (RocksdbPartition* partition,
-         Topic topic,
+         const Topic& topic,
          ROCKSDB_NAMESPACE::Slice* key,
          ROCKSDB_NAMESPACE::Slice* keyValue
         )
@@ -891,25 +1255,20 @@ Result<IndexKeys> HATN_ROCKSDB_SCHEMA_EXPORT indexKeys(
             }
         }
 
-        // insert found key
-        auto it=keys.emplace(key,keyValue,std::move(topic),partition,idxQuery.query.index()->unique());
-        if (idxQuery.query.offset()==0)
+        // insert found key,
+        // if the key is behind the tail of full set then break current iteration because keys are pre-sorted
+        // and all next keys will be dropped anyway
+        auto inserted=insertBounded(keys,scratchKey,keysLimit,key,keyValue,topic,partition,unique);
+        if (inserted==InsertStatus::BehindTail)
         {
-            // cut keys number to limit
-            if (limit!=0 && keys.size()>limit)
-            {
-                // if inserted key is over the limit then break current iteration because keys are pre-sorted
-                // and all next keys will be dropped anyway
-                auto last=--keys.end();
-                if (it.first==last)
-                {
-                    keys.erase(last);
-                    return false;
-                }
-                keys.erase(last);
-            }
+            return false;
         }
-        else
+        if (inserted==InsertStatus::Duplicate)
+        {
+            return true;
+        }
+
+        if (idxQuery.query.offset()!=0)
         {
             // collect offset+limit for each partition*topic to truncate from the head up to the offset later
             partitionCount++;
@@ -930,6 +1289,7 @@ Result<IndexKeys> HATN_ROCKSDB_SCHEMA_EXPORT indexKeys(
         partitionCount=0;
 
         Cursor cursor(idxQuery.modelIndexId,topic,partition.get());
+        cursor.continuationKey=after;
 
         auto cb=[&keyCallback,topic]
             (RocksdbPartition* partition,
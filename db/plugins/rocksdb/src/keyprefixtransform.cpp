@@ -0,0 +1,59 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/** @file db/plugins/rocksdb/src/keyprefixtransform.cpp
+  *
+  *   RocksDB prefix extractor of object and index keys.
+  *
+  */
+
+/****************************************************************************/
+
+#include <cstring>
+
+#include <hatn/db/plugins/rocksdb/keyprefixtransform.h>
+
+HATN_ROCKSDB_NAMESPACE_BEGIN
+
+//---------------------------------------------------------------
+
+size_t KeyPrefixTransform::prefixSize(const ROCKSDB_NAMESPACE::Slice& key) noexcept
+{
+    const auto* first=static_cast<const char*>(memchr(key.data(),SeparatorCharC,key.size()));
+    if (first==nullptr)
+    {
+        return 0;
+    }
+    auto offset=static_cast<size_t>(first-key.data())+1;
+
+    const auto* second=static_cast<const char*>(memchr(key.data()+offset,SeparatorCharC,key.size()-offset));
+    if (second==nullptr)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(second-key.data())+1;
+}
+
+//---------------------------------------------------------------
+
+ROCKSDB_NAMESPACE::Slice KeyPrefixTransform::Transform(const ROCKSDB_NAMESPACE::Slice& key) const
+{
+    return ROCKSDB_NAMESPACE::Slice{key.data(),prefixSize(key)};
+}
+
+//---------------------------------------------------------------
+
+bool KeyPrefixTransform::InDomain(const ROCKSDB_NAMESPACE::Slice& key) const
+{
+    return prefixSize(key)!=0;
+}
+
+//---------------------------------------------------------------
+
+HATN_ROCKSDB_NAMESPACE_END
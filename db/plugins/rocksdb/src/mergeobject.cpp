@@ -0,0 +1,205 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+
+/** @file db/plugins/rocksdb/mergeobject.cpp
+  *
+  *   RocksDB merge operator of collection column family.
+  *
+  */
+
+/****************************************************************************/
+
+#include <boost/endian/conversion.hpp>
+
+#include <rocksdb/env.h>
+
+#include <hatn/common/crc32.h>
+
+#include <hatn/dataunit/wirebufsolid.h>
+#include <hatn/dataunit/visitors.h>
+#include <hatn/dataunit/ipp/syntax.ipp>
+
+#include <hatn/db/objectid.h>
+#include <hatn/db/updateserialization.h>
+#include <hatn/db/ipp/updateserialization.ipp>
+
+#include <hatn/db/plugins/rocksdb/ttlmark.h>
+#include <hatn/db/plugins/rocksdb/mergeobject.h>
+#include <hatn/db/plugins/rocksdb/rocksdbmodels.h>
+
+HATN_ROCKSDB_NAMESPACE_BEGIN
+
+namespace {
+
+/**
+ * @brief Log failure of object merge.
+ *
+ * Operands are not dropped, failed merge is reported by RocksDB as corruption of the object.
+ */
+void logMergeFailure(
+        const ROCKSDB_NAMESPACE::MergeOperator::MergeOperationInput &merge_in,
+        const char* reason
+    )
+{
+    ROCKSDB_NAMESPACE::Error(merge_in.logger,"MergeObject: %s, %zu operand(s) not applied for key %s",
+                             reason,merge_in.operand_list.size(),merge_in.key.ToString(true).c_str());
+}
+
+}
+
+//---------------------------------------------------------------
+
+void MergeObject::missingObjectValue(std::string* value)
+{
+    TtlMark ttlMark;
+    ttlMark.fillExpireAt(MissingObjectExpireAt);
+    value->assign(ttlMark.slice().data(),ttlMark.slice().size());
+}
+
+//---------------------------------------------------------------
+
+Error MergeObject::serializeOperand(
+        const update::Request& request,
+        const common::DateTime& updatedAt,
+        std::string& operand
+    )
+{
+    update::message::type msg;
+    auto ec=update::serialize(request,msg);
+    HATN_CHECK_EC(ec)
+
+    dataunit::WireBufSolid buf;
+    auto size=dataunit::io::serialize(msg,buf,ec);
+    HATN_CHECK_EC(ec)
+    if (size<0)
+    {
+        return dataunit::unitError(dataunit::UnitError::SERIALIZE_ERROR);
+    }
+
+    operand.resize(OperandHeaderSize+buf.mainContainer()->size());
+    operand[0]=static_cast<char>(OperandVersion);
+    int64_t ms=boost::endian::native_to_little(updatedAt.toEpochMs());
+    memcpy(operand.data()+sizeof(uint8_t),&ms,sizeof(ms));
+    memcpy(operand.data()+OperandHeaderSize,buf.mainContainer()->data(),buf.mainContainer()->size());
+
+    return OK;
+}
+
+//---------------------------------------------------------------
+
+bool MergeObject::parseOperand(
+        const ROCKSDB_NAMESPACE::Slice& operand,
+        ROCKSDB_NAMESPACE::Slice& message,
+        common::DateTime& updatedAt
+    )
+{
+    if (operand.size()<OperandHeaderSize || static_cast<uint8_t>(operand[0])!=OperandVersion)
+    {
+        return false;
+    }
+
+    int64_t ms=0;
+    memcpy(&ms,operand.data()+sizeof(uint8_t),sizeof(ms));
+    updatedAt=common::DateTime::fromEpochMs(boost::endian::little_to_native(ms));
+    message=ROCKSDB_NAMESPACE::Slice{operand.data()+OperandHeaderSize,operand.size()-OperandHeaderSize};
+
+    return true;
+}
+
+//---------------------------------------------------------------
+
+bool MergeObject::objectKeyModelId(const ROCKSDB_NAMESPACE::Slice& key, uint32_t& modelId) noexcept
+{
+    // key ends with separator|model_id|separator|object_id
+    constexpr static const size_t ModelIdOffset=ObjectId::Length+SeparatorCharStr.size()+common::Crc32HexLength;
+    if (key.size()<ModelIdOffset+SeparatorCharStr.size())
+    {
+        return false;
+    }
+    const char* modelIdPtr=key.data()+key.size()-ModelIdOffset;
+    if (*(modelIdPtr-1)!=SeparatorCharC || *(modelIdPtr+common::Crc32HexLength)!=SeparatorCharC)
+    {
+        return false;
+    }
+
+    modelId=0;
+    for (size_t i=0;i<common::Crc32HexLength;i++)
+    {
+        auto ch=modelIdPtr[i];
+        uint32_t digit=0;
+        if (ch>='0' && ch<='9')
+        {
+            digit=static_cast<uint32_t>(ch-'0');
+        }
+        else if (ch>='a' && ch<='f')
+        {
+            digit=static_cast<uint32_t>(ch-'a'+10);
+        }
+        else
+        {
+            return false;
+        }
+        modelId=(modelId<<4)|digit;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------
+
+bool MergeObject::FullMergeV2(
+        const MergeOperationInput &merge_in,
+        MergeOperationOutput *merge_out
+    ) const
+{
+    if (isRelationKey(merge_in.key))
+    {
+        return MergeModelTopic::FullMergeV2(merge_in,merge_out);
+    }
+
+    uint32_t modelId=0;
+    if (!objectKeyModelId(merge_in.key,modelId))
+    {
+        logMergeFailure(merge_in,"invalid object key");
+        return false;
+    }
+    auto model=RocksdbModels::instance().model(modelId);
+    if (!model || !model->mergeUpdate)
+    {
+        logMergeFailure(merge_in,"model is not registered");
+        return false;
+    }
+
+    if (!model->mergeUpdate(merge_in.existing_value,merge_in.operand_list,&merge_out->new_value))
+    {
+        logMergeFailure(merge_in,"failed to merge object");
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------
+
+bool MergeObject::PartialMergeMulti(const ROCKSDB_NAMESPACE::Slice& key,
+                       const std::deque<ROCKSDB_NAMESPACE::Slice>& operand_list,
+                       std::string* new_value, ROCKSDB_NAMESPACE::Logger* logger) const
+{
+    if (isRelationKey(key))
+    {
+        return MergeModelTopic::PartialMergeMulti(key,operand_list,new_value,logger);
+    }
+
+    // operands of objects are kept until full merge
+    return false;
+}
+
+//---------------------------------------------------------------
+
+HATN_ROCKSDB_NAMESPACE_END
@@ -16,9 +16,12 @@
 
 /****************************************************************************/
 
+#include <map>
+
 #include <boost/endian/conversion.hpp>
 
 #include <rocksdb/db.h>
+#include <rocksdb/utilities/transaction_db.h>
 
 #include <hatn/logcontext/contextlogger.h>
 
@@ -38,7 +41,8 @@ Error ModelTopics::update(
         Topic topic,
         RocksdbHandler &handler,
         RocksdbPartition* partition,
-        Operator action
+        Operator action,
+        ROCKSDB_NAMESPACE::Transaction* tx
     )
 {
     std::array<char,MaxOperationSize> op;
@@ -57,12 +61,24 @@ Error ModelTopics::update(
     std::cout << "MergeModelTopic::upate op=" << static_cast<int>(op[0]) << " key=" << logKey(key)
               << " size=" << size << std::endl;
 #endif
-    auto status=handler.p()->db->Merge(
-            handler.p()->writeOptions,
-            partition->dataCf(),
-            ks,
-            ops
-        );
+    ROCKSDB_NAMESPACE::Status status;
+    if (tx!=nullptr)
+    {
+        status=tx->MergeUntracked(
+                partition->dataCf(),
+                ks,
+                ops
+            );
+    }
+    else
+    {
+        status=handler.p()->db->Merge(
+                handler.p()->writeOptions,
+                partition->dataCf(),
+                ks,
+                ops
+            );
+    }
     if (!status.ok())
     {
         return makeError(DbError::MODEL_TOPIC_RELATION_SAVE,status);
@@ -164,10 +180,10 @@ void ModelTopics::fillModelKeyPrefix(const std::string& modelId, KeyBuf& key, bo
 //---------------------------------------------------------------
 
 Result<size_t> ModelTopics::count(
-        const ModelInfo& model,
+        const std::string& modelId,
         Topic topic,
-        const common::Date &date,
-        RocksdbHandler &handler
+        RocksdbHandler &handler,
+        RocksdbPartition* partition
     )
 {
     // construct keys
@@ -179,14 +195,14 @@ Result<size_t> ModelTopics::count(
     bool multipleTopics=topic.topic().empty();
     if (!multipleTopics)
     {
-        fillRelationKey(model.modelIdStr(),topic,key);
+        fillRelationKey(modelId,topic,key);
         ks=Slice{key.data(),key.size()};
     }
     else
     {
-        fillModelKeyPrefix(model.modelIdStr(),key);
+        fillModelKeyPrefix(modelId,key);
         ks=Slice{key.data(),key.size()};
-        fillModelKeyPrefix(model.modelIdStr(),keyTo,true);
+        fillModelKeyPrefix(modelId,keyTo,true);
         ksTo=Slice{keyTo.data(),keyTo.size()};
         rdOpts.iterate_lower_bound=&ks;
         rdOpts.iterate_upper_bound=&ksTo;
@@ -215,57 +231,73 @@ Result<size_t> ModelTopics::count(
         return Error{OK};
     };
 
-    auto eachPartition=[multipleTopics,&eachTopic,&handler,&ks,&rdOpts](std::shared_ptr<RocksdbPartition>& partition)
+    if (multipleTopics)
     {
-        if (multipleTopics)
-        {
 //! @maybe Log debug
 #if 0
-            std::cout << "ModelTopics from " << logKey(ks)
-                      << " to " << logKey(ksTo)
-                      << std::endl;
+        std::cout << "ModelTopics from " << logKey(ks)
+                  << " to " << logKey(ksTo)
+                  << std::endl;
 #endif
-            std::unique_ptr<ROCKSDB_NAMESPACE::Iterator> it{handler.p()->db->NewIterator(rdOpts,partition->dataCf())};
-            it->SeekToFirst();
-            auto hasKey=it->Valid();
-            while (hasKey)
-            {
-                auto relSl=it->value();
-                auto ec=eachTopic(relSl);
-                HATN_CHECK_EC(ec)
+        std::unique_ptr<ROCKSDB_NAMESPACE::Iterator> it{handler.p()->db->NewIterator(rdOpts,partition->dataCf())};
+        it->SeekToFirst();
+        auto hasKey=it->Valid();
+        while (hasKey)
+        {
+            auto relSl=it->value();
+            auto ec=eachTopic(relSl);
+            HATN_CHECK_EC(ec)
 
-                it->Next();
-                hasKey=it->Valid();
-            }
-            if (!it->status().ok())
+            it->Next();
+            hasKey=it->Valid();
+        }
+        if (!it->status().ok())
+        {
+            if (it->status().code()==ROCKSDB_NAMESPACE::Status::kNotFound)
             {
-                if (it->status().code()==ROCKSDB_NAMESPACE::Status::kNotFound)
-                {
-                    return Error{OK};
-                }
-                return makeError(DbError::MODEL_TOPIC_RELATION_READ,it->status());
+                return count;
             }
+            return makeError(DbError::MODEL_TOPIC_RELATION_READ,it->status());
         }
-        else
-        {
+    }
+    else
+    {
 //! @maybe Log debug
 #if 0
-            std::cout << "Single topic from " << logKey(ks) << std::endl;
+        std::cout << "Single topic from " << logKey(ks) << std::endl;
 #endif
-            ROCKSDB_NAMESPACE::PinnableSlice readSl;
-            auto status=handler.p()->db->Get(rdOpts,partition->dataCf(),ks,&readSl);
-            if (!status.ok())
+        ROCKSDB_NAMESPACE::PinnableSlice readSl;
+        auto status=handler.p()->db->Get(rdOpts,partition->dataCf(),ks,&readSl);
+        if (!status.ok())
+        {
+            if (status.code()==ROCKSDB_NAMESPACE::Status::kNotFound)
             {
-                if (status.code()==ROCKSDB_NAMESPACE::Status::kNotFound)
-                {
-                    return Error{OK};
-                }
-                return makeError(DbError::MODEL_TOPIC_RELATION_READ,status);
+                return count;
             }
-            auto ec=eachTopic(readSl);
-            HATN_CHECK_EC(ec)
+            return makeError(DbError::MODEL_TOPIC_RELATION_READ,status);
         }
+        auto ec=eachTopic(readSl);
+        HATN_CHECK_EC(ec)
+    }
 
+    return count;
+}
+
+//---------------------------------------------------------------
+
+Result<size_t> ModelTopics::count(
+        const ModelInfo& model,
+        Topic topic,
+        const common::Date &date,
+        RocksdbHandler &handler
+    )
+{
+    size_t count=0;
+    auto eachPartition=[&count,&model,&topic,&handler](const std::shared_ptr<RocksdbPartition>& partition)
+    {
+        auto r=ModelTopics::count(model.modelIdStr(),topic,handler,partition.get());
+        HATN_CHECK_RESULT(r)
+        count+=r.value();
         return Error{OK};
     };
 
@@ -382,12 +414,22 @@ Result<common::pmr::set<Topic>>
         auto hasKey=it->Valid();
         while (hasKey)
         {
-            auto topic=topicFromKey(it->key());
-            if (topics.find(topic)==topics.end())
+            // skip relations without objects that are waiting for compaction
+            Relation rel;
+            auto relSl=it->value();
+            if (!deserializeRelation(relSl.data(),relSl.size(),rel))
             {
-                Topic t;
-                t.load(topic);
-                topics.emplace(std::move(t));
+                return dbError(DbError::MODEL_TOPIC_RELATION_DESER);
+            }
+            if (rel.count!=0)
+            {
+                auto topic=topicFromKey(it->key());
+                if (topics.find(topic)==topics.end())
+                {
+                    Topic t;
+                    t.load(topic);
+                    topics.emplace(std::move(t));
+                }
             }
 
 //! @maybe Log debug
@@ -478,6 +520,153 @@ Error ModelTopics::deleteTopic(
 
 //---------------------------------------------------------------
 
+Error ModelTopics::rebuildRelations(
+        RocksdbHandler &handler
+    )
+{
+    HATN_CTX_SCOPE("modeltopicsrebuild")
+
+    if (handler.readOnly())
+    {
+        return dbError(DbError::DB_READ_ONLY);
+    }
+
+    auto schema=handler.schema();
+    if (!schema)
+    {
+        return dbError(DbError::SCHEMA_NOT_FOUND);
+    }
+    const auto& models=schema->dbSchema()->models();
+
+    // object keys are in format topic|model_id|object_id, relation keys are the last keys in column family
+    KeyBuf objectsTo;
+    objectsTo.append(RelationKeyPrefix.data(),RelationKeyPrefix.size());
+    Slice objectsToS{objectsTo.data(),objectsTo.size()};
+
+    auto rdOpts=handler.p()->readOptions;
+    rdOpts.iterate_upper_bound=&objectsToS;
+
+    auto eachPartition=[&](RocksdbPartition* partition)
+    {
+        std::map<std::pair<std::string,std::string>,uint64_t> counts;
+        TtlMark::refreshCurrentTimepoint();
+
+        auto eachCf=[&](ROCKSDB_NAMESPACE::ColumnFamilyHandle* cf)
+        {
+            std::unique_ptr<ROCKSDB_NAMESPACE::Iterator> it{handler.p()->db->NewIterator(rdOpts,cf)};
+            for (it->SeekToFirst();it->Valid();it->Next())
+            {
+                if (TtlMark::isExpired(it->value()))
+                {
+                    continue;
+                }
+
+                auto key=sliceView(it->key());
+                auto topicEnd=key.find(SeparatorCharC);
+                if (topicEnd==lib::string_view::npos)
+                {
+                    continue;
+                }
+                auto modelIdPos=topicEnd+1;
+                auto modelIdEnd=key.find(SeparatorCharC,modelIdPos);
+                if (modelIdEnd==lib::string_view::npos)
+                {
+                    continue;
+                }
+
+                auto modelId=key.substr(modelIdPos,modelIdEnd-modelIdPos);
+                auto topic=key.substr(0,topicEnd);
+                counts[std::make_pair(std::string{modelId},std::string{topic})]++;
+            }
+            if (!it->status().ok())
+            {
+                return makeError(DbError::MODEL_TOPIC_RELATION_READ,it->status());
+            }
+            return Error{OK};
+        };
+
+        auto ec=eachCf(partition->dataCf());
+        HATN_CHECK_EC(ec)
+        if (partition->blobCf)
+        {
+            ec=eachCf(partition->dataCf(true));
+            HATN_CHECK_EC(ec)
+        }
+
+        // replace all relations of schema models in one batch
+        ROCKSDB_NAMESPACE::WriteBatch batch;
+        for (auto&& it: models)
+        {
+            const auto& modelId=it.second->modelIdStr();
+            KeyBuf from;
+            fillModelKeyPrefix(modelId,from);
+            KeyBuf to;
+            fillModelKeyPrefix(modelId,to,true);
+            auto status=batch.DeleteRange(partition->dataCf(),Slice{from.data(),from.size()},Slice{to.data(),to.size()});
+            if (!status.ok())
+            {
+                return makeError(DbError::MODEL_TOPIC_RELATION_DEL,status);
+            }
+        }
+        for (auto&& it: counts)
+        {
+            KeyBuf key;
+            fillRelationKey(it.first.first,Topic{it.first.second},key);
+            Relation rel;
+            rel.count=it.second;
+            std::string value;
+            serializeRelation(rel,&value);
+            auto status=batch.Put(partition->dataCf(),Slice{key.data(),key.size()},value);
+            if (!status.ok())
+            {
+                return makeError(DbError::MODEL_TOPIC_RELATION_SAVE,status);
+            }
+        }
+
+        ROCKSDB_NAMESPACE::TransactionDBWriteOptimizations txOpts;
+        txOpts.skip_concurrency_control=true;
+        txOpts.skip_duplicate_key_check=true;
+        auto status=handler.p()->transactionDb->Write(handler.p()->writeOptions,txOpts,&batch);
+        if (!status.ok())
+        {
+            return makeError(DbError::MODEL_TOPIC_RELATION_REBUILD,status);
+        }
+
+        HATN_CTX_DEBUG_RECORDS(1,"rebuilt model-topic relations",{"count",static_cast<uint64_t>(counts.size())})
+        return Error{OK};
+    };
+
+    for (auto&& range: handler.partitionRanges())
+    {
+        std::shared_ptr<RocksdbPartition> partition;
+        if (range.isNull())
+        {
+            partition=handler.defaultPartition();
+        }
+        else
+        {
+            partition=handler.partition(range);
+        }
+        if (partition)
+        {
+            if (!range.isNull())
+            {
+                HATN_CTX_SCOPE_PUSH("partition",range)
+            }
+            auto ec=eachPartition(partition.get());
+            if (!range.isNull())
+            {
+                HATN_CTX_SCOPE_POP()
+            }
+            HATN_CHECK_EC(ec)
+        }
+    }
+
+    return OK;
+}
+
+//---------------------------------------------------------------
+
 static void mergeRelOp(ModelTopics::Relation &rel, const ModelTopics::Operation& op)
 {
     if (op.op==ModelTopics::Operator::Del)
@@ -24,6 +24,9 @@
 #include <rocksdb/db.h>
 #include <rocksdb/version.h>
 #include <rocksdb/utilities/transaction_db.h>
+#include <rocksdb/table.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/cache.h>
 
 #include <hatn/common/utils.h>
 #include <hatn/common/filesystem.h>
@@ -41,6 +44,8 @@
 #include <hatn/db/plugins/rocksdb/detail/rocksdbhandler.ipp>
 #include <hatn/db/plugins/rocksdb/ttlcompactionfilter.h>
 #include <hatn/db/plugins/rocksdb/modeltopics.h>
+#include <hatn/db/plugins/rocksdb/mergeobject.h>
+#include <hatn/db/plugins/rocksdb/keyprefixtransform.h>
 #include <hatn/db/plugins/rocksdb/rocksdbencryption.h>
 #include <hatn/db/plugins/rocksdb/rocksdbmodels.h>
 
@@ -95,6 +100,24 @@ HDU_UNIT(rocksdb_options,
          HDU_FIELD(avoid_flush_during_recovery,TYPE_BOOL,12)
          HDU_FIELD(max_background_jobs,TYPE_INT32,13)
 
+         // Read objects found by index queries with asynchronous IO in MultiGet.
+         HDU_FIELD(multiget_async_io,TYPE_BOOL,14)
+
+         // Number of threads to scan partitions and topics of index queries in parallel, 0 or 1 to scan sequentially.
+         HDU_FIELD(parallel_search_threads,TYPE_UINT32,15)
+
+         // Write updates of non-indexed scalar fields as merge operands applied lazily on read and compaction.
+         // Update of missing object is not reported as not found when enabled.
+         HDU_FIELD(merge_update,TYPE_BOOL,16)
+
+         // Table tuning of collection and index column families.
+         // Bits per key of prefix bloom filters built on topic|model_id and topic|index_id key prefixes, 0 to disable prefix filtering.
+         HDU_FIELD(bloom_bits_per_key,TYPE_UINT32,17,false,10)
+         // Size of block cache shared by all column families, if not set then each column family uses its own default cache.
+         HDU_FIELD(block_cache_size,TYPE_UINT64,18)
+         // Use partitioned index and filter blocks that are loaded to block cache on demand, useful for large databases.
+         HDU_FIELD(partition_index_filters,TYPE_BOOL,19)
+
          HDU_FIELD(blob_min_size,TYPE_UINT32,30,false,0x4000)
          HDU_FIELD(blob_max_size,TYPE_UINT32,31)
          HDU_FIELD(blob_write_buffer_size,TYPE_UINT32,32)
@@ -325,23 +348,59 @@ void RocksdbClient::invokeOpenDb(const ClientConfig &config, Error &ec, base::co
 #ifdef BUILD_DEBUG
     txOptions.transaction_lock_timeout=10000;
 #endif
+    // table options, block cache is shared by all column families
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions ttlTableOptions;
+    if (d->opt.config().field(rocksdb_options::block_cache_size).isSet())
+    {
+        ttlTableOptions.block_cache=ROCKSDB_NAMESPACE::NewLRUCache(d->opt.config().fieldValue(rocksdb_options::block_cache_size));
+    }
+    auto keysTableOptions=ttlTableOptions;
+    auto bloomBitsPerKey=d->opt.config().fieldValue(rocksdb_options::bloom_bits_per_key);
+    std::shared_ptr<const ROCKSDB_NAMESPACE::SliceTransform> prefixExtractor;
+    if (bloomBitsPerKey!=0)
+    {
+        keysTableOptions.filter_policy.reset(ROCKSDB_NAMESPACE::NewBloomFilterPolicy(bloomBitsPerKey));
+        prefixExtractor=std::make_shared<KeyPrefixTransform>();
+    }
+    if (d->opt.config().fieldValue(rocksdb_options::partition_index_filters))
+    {
+        keysTableOptions.index_type=ROCKSDB_NAMESPACE::BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+        keysTableOptions.partition_filters=bloomBitsPerKey!=0;
+        keysTableOptions.cache_index_and_filter_blocks=true;
+        keysTableOptions.pin_top_level_index_and_filter=true;
+    }
+    std::shared_ptr<ROCKSDB_NAMESPACE::TableFactory> keysTableFactory{ROCKSDB_NAMESPACE::NewBlockBasedTableFactory(keysTableOptions)};
+    std::shared_ptr<ROCKSDB_NAMESPACE::TableFactory> ttlTableFactory{ROCKSDB_NAMESPACE::NewBlockBasedTableFactory(ttlTableOptions)};
+
     ROCKSDB_NAMESPACE::ColumnFamilyOptions collCfOptions;
     collCfOptions.compaction_filter=d->ttlCompactionFilter.get();
-    collCfOptions.merge_operator=std::make_shared<MergeModelTopic>();
+    collCfOptions.merge_operator=std::make_shared<MergeObject>();
     collCfOptions.compression=compression;
+    collCfOptions.table_factory=keysTableFactory;
+    collCfOptions.prefix_extractor=prefixExtractor;
 
     ROCKSDB_NAMESPACE::ColumnFamilyOptions indexCfOptions;
     indexCfOptions.merge_operator=std::make_shared<SaveUniqueKey>();
     indexCfOptions.compaction_filter=d->ttlCompactionFilter.get();
     indexCfOptions.compression=compression;
+    indexCfOptions.table_factory=keysTableFactory;
+    indexCfOptions.prefix_extractor=prefixExtractor;
+    if (prefixExtractor)
+    {
+        // index seeks mostly go to keys that are not flushed yet
+        indexCfOptions.memtable_prefix_bloom_size_ratio=0.1;
+    }
 
     ROCKSDB_NAMESPACE::ColumnFamilyOptions ttlCfOptions;
     ttlCfOptions.compression=compression;
+    ttlCfOptions.table_factory=ttlTableFactory;
 
     ROCKSDB_NAMESPACE::ColumnFamilyOptions blobCfOptions;
     blobCfOptions.compaction_filter=d->ttlCompactionFilter.get();
     blobCfOptions.merge_operator=std::make_shared<MergeModelTopic>();
     blobCfOptions.compression=compression;
+    blobCfOptions.table_factory=keysTableFactory;
+    blobCfOptions.prefix_extractor=prefixExtractor;
     blobCfOptions.enable_blob_files=true;
     blobCfOptions.min_blob_size=d->opt.config().field(rocksdb_options::blob_min_size).value();
     if (d->opt.config().field(rocksdb_options::blob_write_buffer_size).isSet())
@@ -514,6 +573,19 @@ void RocksdbClient::invokeOpenDb(const ClientConfig &config, Error &ec, base::co
     // create handler
     d->handler=std::make_unique<RocksdbHandler>(new RocksdbHandler_p(db,transactionDb));
     d->handler->p()->blobEnabled=config.enableBlob;
+    d->handler->p()->multiGetAsyncIo=d->opt.config().fieldValue(rocksdb_options::multiget_async_io);
+    d->handler->p()->mergeUpdate=d->opt.config().fieldValue(rocksdb_options::merge_update);
+    if (prefixExtractor)
+    {
+        // iterators use prefix filters only when bounds are within the same prefix, otherwise keys are iterated in total order
+        d->handler->p()->readOptions.auto_prefix_mode=true;
+    }
+    auto searchThreads=d->opt.config().fieldValue(rocksdb_options::parallel_search_threads);
+    if (searchThreads>1)
+    {
+        d->handler->p()->searchPool=std::make_unique<common::ThreadPoolWithQueues<common::Task>>(searchThreads,"rdbsearch");
+        d->handler->p()->searchPool->start();
+    }
     d->handler->p()->collColumnFamilyOptions=collCfOptions;
     d->handler->p()->indexColumnFamilyOptions=indexCfOptions;
     d->handler->p()->ttlColumnFamilyOptions=ttlCfOptions;
@@ -668,6 +740,9 @@ void RocksdbClient::invokeCloseDb(Error &ec)
     ec.reset();
     if (d->handler)
     {
+        // release snapshots of open cursors, database can not be closed with unreleased snapshots
+        d->handler->p()->closeCursors();
+
         d->handler->resetCf();
 
         rocksdb::Status status;
@@ -828,8 +903,12 @@ Error RocksdbClient::doCheckSchema()
 
 Error RocksdbClient::doMigrateSchema()
 {
+    HATN_CTX_SCOPE("rdb::migrateschema")
+
     //! @todo Save ids of keys and collections from schema
-    return common::CommonError::NOT_IMPLEMENTED;
+
+    // rebuild model-topic relations for databases created before relations were written in transactions
+    return ModelTopics::rebuildRelations(*d->handler);
 }
 
 //---------------------------------------------------------------
@@ -926,6 +1005,24 @@ Error RocksdbClient::doCreate(Topic topic, const ModelInfo& model, const datauni
 
 //---------------------------------------------------------------
 
+Result<size_t> RocksdbClient::doCreateMany(Topic topic,
+                                           const ModelInfo& model,
+                                           const std::vector<const dataunit::Unit*>& objects,
+                                           std::vector<Error>* objectErrors,
+                                           Transaction* tx)
+{
+    HATN_CTX_SCOPE("rdb::createmany")
+
+    ENSURE_MODEL_SCHEMA
+
+    auto rdbModel=model.nativeModel<RocksdbModel>();
+    Assert(rdbModel,"Model not registered");
+
+    return rdbModel->createMany(*d->handler,topic,objects,objectErrors,tx);
+}
+
+//---------------------------------------------------------------
+
 Result<DbObject> RocksdbClient::doRead(Topic topic,
                                                                 const ModelInfo &model,
                                                                 const ObjectId &id,
@@ -1115,6 +1212,14 @@ Error RocksdbClient::doUpdateObject(Topic topic,
     auto rdbModel=model.nativeModel<RocksdbModel>();
     Assert(rdbModel,"Model not registered");
 
+    // try to write update as merge operand without reading object
+    auto merged=rdbModel->mergeUpdateObjectWithDate(*d->handler,topic,id,request,date,tx);
+    HATN_CHECK_RESULT(merged)
+    if (merged.value())
+    {
+        return OK;
+    }
+
     auto r=rdbModel->updateObjectWithDate(*d->handler,topic,id,request,date,db::update::ModifyReturn::None,tx);
     HATN_CHECK_RESULT(r)
     if (r.value().isNull())
@@ -1139,6 +1244,14 @@ Error RocksdbClient::doUpdateObject(Topic topic,
     auto rdbModel=model.nativeModel<RocksdbModel>();
     Assert(rdbModel,"Model not registered");
 
+    // try to write update as merge operand without reading object
+    auto merged=rdbModel->mergeUpdateObject(*d->handler,topic,id,request,tx);
+    HATN_CHECK_RESULT(merged)
+    if (merged.value())
+    {
+        return OK;
+    }
+
     auto r=rdbModel->updateObject(*d->handler,topic,id,request,db::update::ModifyReturn::None,tx);
     HATN_CHECK_RESULT(r)
     if (r.value().isNull())
@@ -1324,6 +1437,42 @@ Error RocksdbClient::doFindCb(
 
 //---------------------------------------------------------------
 
+Result<std::shared_ptr<FindCursor>> RocksdbClient::doOpenFindCursor(
+        const ModelInfo& model,
+        FindCursor::QueryFn query,
+        const std::string& modelIndexId
+    )
+{
+    HATN_CTX_SCOPE("rdb::openfindcursor")
+
+    ENSURE_MODEL_SCHEMA
+
+    auto rdbModel=model.nativeModel<RocksdbModel>();
+    Assert(rdbModel,"Model not registered");
+
+    return rdbModel->openFindCursor(*d->handler,std::move(query),modelIndexId);
+}
+
+//---------------------------------------------------------------
+
+Result<HATN_COMMON_NAMESPACE::pmr::vector<DbObject>> RocksdbClient::doFetchCursor(
+        const ModelInfo& model,
+        FindCursor& cursor,
+        size_t pageSize
+    )
+{
+    HATN_CTX_SCOPE("rdb::fetchcursor")
+
+    ENSURE_MODEL_SCHEMA
+
+    auto rdbModel=model.nativeModel<RocksdbModel>();
+    Assert(rdbModel,"Model not registered");
+
+    return rdbModel->fetchCursor(*d->handler,cursor,pageSize);
+}
+
+//---------------------------------------------------------------
+
 Error RocksdbClient::doDeleteTopic(Topic topic)
 {
     return d->handler->deleteTopic(topic);
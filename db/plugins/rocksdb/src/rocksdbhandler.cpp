@@ -16,6 +16,8 @@
 
 /****************************************************************************/
 
+#include <algorithm>
+
 #include <rocksdb/db.h>
 
 #include <hatn/logcontext/contextlogger.h>
@@ -39,19 +41,59 @@ RocksdbHandler_p::RocksdbHandler_p(
     ) : db(db),
         transactionDb(transactionDb),
         readOnly(transactionDb==nullptr),
-        blobEnabled(false)
+        blobEnabled(false),
+        multiGetAsyncIo(false),
+        mergeUpdate(false)
 {}
 
 //---------------------------------------------------------------
 
 RocksdbHandler_p::~RocksdbHandler_p()
 {
+    if (searchPool)
+    {
+        searchPool->stop();
+        searchPool.reset();
+    }
     if (db!=nullptr)
     {
         delete db;
     }
 }
 
+//---------------------------------------------------------------
+
+void RocksdbHandler_p::addCursor(const std::shared_ptr<FindCursor>& cursor)
+{
+    std::lock_guard<std::mutex> l{m_cursorsMutex};
+
+    // forget destroyed cursors
+    m_cursors.erase(
+        std::remove_if(m_cursors.begin(),m_cursors.end(),[](const std::weak_ptr<FindCursor>& c){return c.expired();}),
+        m_cursors.end()
+    );
+    m_cursors.push_back(cursor);
+}
+
+//---------------------------------------------------------------
+
+void RocksdbHandler_p::closeCursors()
+{
+    std::vector<std::weak_ptr<FindCursor>> cursors;
+    {
+        std::lock_guard<std::mutex> l{m_cursorsMutex};
+        cursors.swap(m_cursors);
+    }
+    for (auto& c: cursors)
+    {
+        auto cursor=c.lock();
+        if (cursor)
+        {
+            cursor->close();
+        }
+    }
+}
+
 /********************** RocksdbHandler **************************/
 
 //---------------------------------------------------------------
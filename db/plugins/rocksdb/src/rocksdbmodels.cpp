@@ -53,7 +53,9 @@ RocksdbModels& RocksdbModels::instance()
 
 void RocksdbModels::free() noexcept
 {
-    instance().m_models.clear();
+    auto& inst=instance();
+    common::lib::unique_lock<common::lib::shared_mutex> l{inst.m_mutex};
+    inst.m_models.clear();
 }
 
 //---------------------------------------------------------------
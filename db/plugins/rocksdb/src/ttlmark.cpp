@@ -52,6 +52,13 @@ uint32_t TtlMark::refreshCurrentTimepoint()
 
 //---------------------------------------------------------------
 
+void TtlMark::setCurrentTimepoint(uint32_t tp) noexcept
+{
+    CurrentTimepoint=tp;
+}
+
+//---------------------------------------------------------------
+
 void TtlMark::fillExpireAt(uint32_t expireAt)
 {
     if (expireAt>0)
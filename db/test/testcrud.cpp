@@ -282,4 +282,67 @@ BOOST_AUTO_TEST_CASE(Simple1)
     HATN_CTX_INFO("Test finish")
 }
 
+BOOST_AUTO_TEST_CASE(CreateMany)
+{
+    auto s=initSimpleSchema();
+
+    auto handler=[&s](std::shared_ptr<DbPlugin> plugin, std::shared_ptr<Client> client)
+    {
+        auto& s1=std::get<1>(s);
+        auto& m1=std::get<0>(s);
+
+        std::ignore=plugin;
+        setSchemaToClient(client,s1);
+
+        Topic topic{"topic1"};
+
+        // create objects in one batch
+        constexpr const size_t count=10;
+        std::vector<simple1::type> objects;
+        for (size_t i=0;i<count;i++)
+        {
+            auto o=makeInitObject<simple1::type>();
+            o.setFieldValue(simple1::f1,static_cast<uint32_t>(i));
+            objects.push_back(std::move(o));
+        }
+        auto r1=client->createMany(topic,m1,objects);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1.value(),count);
+        auto c1=client->count(m1,topic);
+        BOOST_REQUIRE(!c1);
+        BOOST_CHECK_EQUAL(c1.value(),count);
+        auto r2=client->read(topic,m1,objects[5].fieldValue(object::_id));
+        BOOST_REQUIRE(!r2);
+        BOOST_CHECK_EQUAL(r2.value()->fieldValue(simple1::f1),5);
+
+        // skip failed objects and collect errors
+        auto o1=makeInitObject<simple1::type>();
+        auto o2=makeInitObject<simple1::type>();
+        std::vector<const simple1::type*> ptrs{&o1,&objects[0],&o2};
+        std::vector<Error> errors;
+        r1=client->createMany(topic,m1,ptrs,&errors);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1.value(),2);
+        BOOST_REQUIRE_EQUAL(errors.size(),ptrs.size());
+        BOOST_CHECK(!errors[0]);
+        BOOST_CHECK(errors[1]);
+        BOOST_CHECK(!errors[2]);
+        c1=client->count(m1,topic);
+        BOOST_REQUIRE(!c1);
+        BOOST_CHECK_EQUAL(c1.value(),count+2);
+
+        // cancel all objects on the first error
+        auto o3=makeInitObject<simple1::type>();
+        ptrs=std::vector<const simple1::type*>{&o3,&objects[1]};
+        r1=client->createMany(topic,m1,ptrs);
+        BOOST_CHECK(r1);
+        c1=client->count(m1,topic);
+        BOOST_REQUIRE(!c1);
+        BOOST_CHECK_EQUAL(c1.value(),count+2);
+        auto r3=client->read(topic,m1,o3.fieldValue(object::_id));
+        BOOST_CHECK(r3);
+    };
+    PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
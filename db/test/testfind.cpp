@@ -15,10 +15,13 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
+#include <set>
 
 #include <boost/test/unit_test.hpp>
 
 #include <hatn/common/datetime.h>
+#include <hatn/common/elapsedtimer.h>
 
 #include <hatn/logcontext/contextlogger.h>
 #include <hatn/logcontext/streamlogger.h>
@@ -50,6 +53,15 @@ namespace {
 namespace rdb=HATN_ROCKSDB_NAMESPACE;
 #endif
 
+HDU_UNIT_WITH(u1_ttl,(HDU_BASE(object)),
+    HDU_FIELD(f1,TYPE_UINT32,1)
+    HDU_FIELD(expire_at,TYPE_DATETIME,2)
+)
+
+HATN_DB_INDEX(u1_ttl_f1_idx,u1_ttl::f1)
+HATN_DB_TTL_INDEX(u1_ttl_expire_idx,1,u1_ttl::expire_at)
+HATN_DB_MODEL(m1_ttl,u1_ttl,u1_ttl_f1_idx(),u1_ttl_expire_idx())
+
 void init()
 {
     ModelRegistry::free();
@@ -514,6 +526,175 @@ BOOST_AUTO_TEST_CASE(OffsetAndLimit)
     PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
 }
 
+BOOST_AUTO_TEST_CASE(FindWithCursor)
+{
+    init();
+
+    auto s1=initSchema(m1_uint32());
+
+    auto handler=[&s1](std::shared_ptr<DbPlugin> plugin, std::shared_ptr<Client> client)
+    {
+        setSchemaToClient(client,s1);
+
+        Topic topic1{"topic1"};
+        Topic topic2{"topic2"};
+
+        // fill db with objects
+        uint32_t startVal=1000000;
+        size_t count=50;
+        for (size_t i=0;i<count;i++)
+        {
+            uint32_t val=static_cast<uint32_t>(i+startVal);
+            auto o=makeInitObject<u1_uint32::type>();
+            o.setFieldValue(u1_uint32::f1,val);
+            auto ec=client->create(topic1,m1_uint32(),&o);
+            BOOST_REQUIRE(!ec);
+        }
+
+        auto fetchAll=[&](const std::shared_ptr<FindCursor>& cursor, size_t pageSize, std::vector<uint32_t>& vals)
+        {
+            size_t pages=0;
+            while (!cursor->isFinished())
+            {
+                auto r=client->fetchCursor(m1_uint32(),*cursor,pageSize);
+                BOOST_REQUIRE(!r);
+                BOOST_REQUIRE_LE(r.value().size(),pageSize);
+                for (auto&& obj: r.value())
+                {
+                    vals.push_back(obj.unit<u1_uint32::type>()->fieldValue(u1_uint32::f1));
+                }
+                pages++;
+            }
+            return pages;
+        };
+
+        // walk all objects with pages, objects created after opening cursor are not seen
+        auto q1=wrapQuery(AllocatorFactory::getDefault(),u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::gte,startVal),topic1);
+        auto cursor1=client->openFindCursor(m1_uint32(),q1);
+        BOOST_REQUIRE(!cursor1);
+        auto o1=makeInitObject<u1_uint32::type>();
+        o1.setFieldValue(u1_uint32::f1,static_cast<uint32_t>(startVal+count));
+        auto ec=client->create(topic1,m1_uint32(),&o1);
+        BOOST_REQUIRE(!ec);
+        std::vector<uint32_t> vals1;
+        auto pages=fetchAll(cursor1.value(),15,vals1);
+        BOOST_CHECK_EQUAL(pages,4);
+        BOOST_REQUIRE_EQUAL(vals1.size(),count);
+        for (size_t i=0;i<vals1.size();i++)
+        {
+            BOOST_CHECK_EQUAL(vals1[i],startVal+i);
+        }
+        BOOST_CHECK_EQUAL(cursor1.value()->fetchedCount(),count);
+
+        // next fetch after finish returns empty page
+        auto r1=client->fetchCursor(m1_uint32(),*cursor1.value(),15);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK(r1.value().empty());
+
+        // offset is applied to the first page and limit bounds all pages
+        size_t offset=10;
+        size_t limit=25;
+        auto q2=wrapQueryBuilder(
+            [&]()
+            {
+                auto q=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::gte,startVal,query::Desc),topic1);
+                q.setOffset(offset);
+                q.setLimit(limit);
+                return q;
+            },
+            topic1.topic()
+        );
+        auto cursor2=client->openFindCursor(m1_uint32(),q2);
+        BOOST_REQUIRE(!cursor2);
+        std::vector<uint32_t> vals2;
+        fetchAll(cursor2.value(),10,vals2);
+        BOOST_REQUIRE_EQUAL(vals2.size(),limit);
+        for (size_t i=0;i<vals2.size();i++)
+        {
+            BOOST_CHECK_EQUAL(vals2[i],startVal+count-offset-i);
+        }
+
+        // objects of multiple topics are merged in order of the query
+        for (size_t i=0;i<count;i++)
+        {
+            uint32_t val=static_cast<uint32_t>(startVal+i);
+            auto o=makeInitObject<u1_uint32::type>();
+            o.setFieldValue(u1_uint32::f1,val);
+            ec=client->create(topic2,m1_uint32(),&o);
+            BOOST_REQUIRE(!ec);
+        }
+        auto q3=wrapQueryBuilder(
+            [&]()
+            {
+                auto q=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::gte,startVal),topic1,topic2);
+                q.setLimit(0);
+                return q;
+            },
+            topic1.topic()
+        );
+        auto cursor3=client->openFindCursor(m1_uint32(),q3);
+        BOOST_REQUIRE(!cursor3);
+        std::vector<uint32_t> vals3;
+        fetchAll(cursor3.value(),7,vals3);
+        BOOST_REQUIRE_EQUAL(vals3.size(),2*count+1);
+        BOOST_CHECK(std::is_sorted(vals3.begin(),vals3.end()));
+
+        // closed cursor returns empty page
+        auto cursor4=client->openFindCursor(m1_uint32(),q3);
+        BOOST_REQUIRE(!cursor4);
+        cursor4.value()->close();
+        auto r4=client->fetchCursor(m1_uint32(),*cursor4.value(),7);
+        BOOST_REQUIRE(!r4);
+        BOOST_CHECK(r4.value().empty());
+
+        // pages split objects with equal values of indexed field
+        Topic topic3{"topic3"};
+        size_t sameCount=20;
+        for (size_t i=0;i<sameCount;i++)
+        {
+            auto o=makeInitObject<u1_uint32::type>();
+            o.setFieldValue(u1_uint32::f1,startVal);
+            ec=client->create(topic3,m1_uint32(),&o);
+            BOOST_REQUIRE(!ec);
+        }
+        auto q5=wrapQueryBuilder(
+            [&]()
+            {
+                auto q=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::eq,startVal),topic3);
+                q.setLimit(0);
+                return q;
+            },
+            topic3.topic()
+        );
+        auto cursor5=client->openFindCursor(m1_uint32(),q5);
+        BOOST_REQUIRE(!cursor5);
+        std::set<std::string> oids5;
+        while (!cursor5.value()->isFinished())
+        {
+            auto r=client->fetchCursor(m1_uint32(),*cursor5.value(),3);
+            BOOST_REQUIRE(!r);
+            for (auto&& obj: r.value())
+            {
+                oids5.insert(obj.unit<u1_uint32::type>()->fieldValue(object::_id).toString());
+            }
+        }
+        BOOST_CHECK_EQUAL(oids5.size(),sameCount);
+        BOOST_CHECK_EQUAL(cursor5.value()->fetchedCount(),sameCount);
+
+        // cursor left open is closed when database is closed
+        auto cursor6=client->openFindCursor(m1_uint32(),q3);
+        BOOST_REQUIRE(!cursor6);
+        auto r6=client->fetchCursor(m1_uint32(),*cursor6.value(),7);
+        BOOST_REQUIRE(!r6);
+        BOOST_CHECK_EQUAL(r6.value().size(),7);
+        BOOST_CHECK(!cursor6.value()->isFinished());
+        ec=client->closeDb();
+        BOOST_CHECK(!ec);
+        BOOST_CHECK(cursor6.value()->isFinished());
+    };
+    PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
+}
+
 BOOST_AUTO_TEST_CASE(Count)
 {
     init();
@@ -1263,6 +1444,198 @@ BOOST_AUTO_TEST_CASE(StringPrefix)
     PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
 }
 
+BOOST_AUTO_TEST_CASE(PrefixSeek)
+{
+    init();
+
+    auto s1=initSchema(m1_uint32());
+
+    auto run=[&s1](const std::string& configFile)
+    {
+        auto handler=[&s1,&configFile](std::shared_ptr<DbPlugin> plugin, std::shared_ptr<Client> client)
+        {
+            setSchemaToClient(client,s1);
+
+            constexpr const size_t topicCount=20;
+            constexpr const size_t count=100;
+            constexpr const size_t seekCount=2000;
+
+            // create objects in topics
+            for (size_t i=0;i<topicCount;i++)
+            {
+                Topic topic{fmt::format("topic{:03d}",i)};
+                for (size_t j=0;j<count;j++)
+                {
+                    auto o=makeInitObject<u1_uint32::type>();
+                    o.setFieldValue(u1_uint32::f1,static_cast<uint32_t>(j));
+                    auto ec=client->create(topic,m1_uint32(),&o);
+                    BOOST_REQUIRE(!ec);
+                }
+            }
+
+            // seek existing keys and keys in missing topics
+            size_t found=0;
+            common::ElapsedTimer elapsed;
+            for (size_t i=0;i<seekCount;i++)
+            {
+                Topic topic{fmt::format("topic{:03d}",i%(topicCount*2))};
+                auto q=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::eq,static_cast<uint32_t>(i%count)),topic);
+                auto r=client->find(m1_uint32(),q);
+                BOOST_REQUIRE(!r);
+                found+=r->size();
+            }
+            BOOST_TEST_MESSAGE(fmt::format("{}: {} seeks elapsed {}",configFile,seekCount,elapsed.toString(true)));
+            BOOST_CHECK_EQUAL(found,seekCount/2);
+
+            // range over all topics is iterated in total order
+            auto q1=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::lt,static_cast<uint32_t>(4)));
+            auto r1=client->find(m1_uint32(),q1);
+            BOOST_REQUIRE(!r1);
+            BOOST_CHECK_EQUAL(r1->size(),4*topicCount);
+        };
+        PrepareDbAndRun::eachPlugin(handler,configFile);
+    };
+
+    run("simple1.jsonc");
+    run("noprefixbloom.jsonc");
+}
+
+BOOST_AUTO_TEST_CASE(ParallelSearch)
+{
+    init();
+#ifdef HATN_ENABLE_PLUGIN_ROCKSDB
+    rdb::RocksdbModels::instance().registerModel(m1_ttl());
+#endif
+
+    auto s1=initSchema(m1_uint32(),m1_ttl());
+
+    constexpr const uint32_t topicCount=8;
+    constexpr const uint32_t count=50;
+    constexpr const uint32_t total=topicCount*count;
+
+    using Results=std::vector<std::vector<uint32_t>>;
+
+    auto run=[&s1](const std::string& configFile, Results& results)
+    {
+        auto handler=[&s1,&results](std::shared_ptr<DbPlugin> plugin, std::shared_ptr<Client> client)
+        {
+            setSchemaToClient(client,s1);
+
+            // values of topics are interleaved so that results of all topics must be merged
+            for (uint32_t i=0;i<topicCount;i++)
+            {
+                Topic topic{fmt::format("topic{:03d}",i)};
+                for (uint32_t j=0;j<count;j++)
+                {
+                    auto o=makeInitObject<u1_uint32::type>();
+                    o.setFieldValue(u1_uint32::f1,j*topicCount+i);
+                    auto ec=client->create(topic,m1_uint32(),&o);
+                    BOOST_REQUIRE(!ec);
+                }
+            }
+
+            auto find=[&](const auto& q)
+            {
+                auto r=client->find(m1_uint32(),q);
+                BOOST_REQUIRE(!r);
+                std::vector<uint32_t> vals;
+                for (size_t i=0;i<r->size();i++)
+                {
+                    vals.push_back(r->at(i).template unit<u1_uint32::type>()->fieldValue(u1_uint32::f1));
+                }
+                results.push_back(vals);
+                return vals;
+            };
+
+            auto q1=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::gte,static_cast<uint32_t>(0)));
+            q1.setLimit(0);
+            auto vals1=find(q1);
+            BOOST_REQUIRE_EQUAL(vals1.size(),total);
+            for (size_t i=0;i<vals1.size();i++)
+            {
+                BOOST_CHECK_EQUAL(vals1[i],i);
+            }
+
+            auto q2=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::gte,static_cast<uint32_t>(0)));
+            q2.setOffset(37);
+            q2.setLimit(25);
+            auto vals2=find(q2);
+            BOOST_REQUIRE_EQUAL(vals2.size(),25);
+            for (size_t i=0;i<vals2.size();i++)
+            {
+                BOOST_CHECK_EQUAL(vals2[i],37+i);
+            }
+
+            auto q3=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::lt,static_cast<uint32_t>(300),query::Desc));
+            q3.setOffset(10);
+            q3.setLimit(40);
+            auto vals3=find(q3);
+            BOOST_REQUIRE_EQUAL(vals3.size(),40);
+            for (size_t i=0;i<vals3.size();i++)
+            {
+                BOOST_CHECK_EQUAL(vals3[i],289-i);
+            }
+
+            auto q4=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::eq,static_cast<uint32_t>(42)));
+            auto vals4=find(q4);
+            BOOST_REQUIRE_EQUAL(vals4.size(),1);
+            BOOST_CHECK_EQUAL(vals4[0],42);
+
+            auto q5=makeQuery(u1_uint32_f1_idx(),query::where(u1_uint32::f1,query::gte,static_cast<uint32_t>(0)));
+            q5.setOffset(total+1);
+            q5.setLimit(10);
+            auto vals5=find(q5);
+            BOOST_CHECK(vals5.empty());
+
+            // expired keys must be skipped by search threads as well, odd rows are created already expired
+            for (uint32_t i=0;i<topicCount;i++)
+            {
+                Topic topic{fmt::format("topic{:03d}",i)};
+                for (uint32_t j=0;j<count;j++)
+                {
+                    auto o=makeInitObject<u1_ttl::type>();
+                    o.setFieldValue(u1_ttl::f1,j*topicCount+i);
+                    auto dt=common::DateTime::currentUtc();
+                    dt.addSeconds((j%2==0)?3600:-3600);
+                    o.setFieldValue(u1_ttl::expire_at,dt);
+                    auto ec=client->create(topic,m1_ttl(),&o);
+                    BOOST_REQUIRE(!ec);
+                }
+            }
+            auto q6=makeQuery(u1_ttl_f1_idx(),query::where(u1_ttl::f1,query::gte,static_cast<uint32_t>(0)));
+            q6.setOffset(20);
+            q6.setLimit(30);
+            auto r6=client->find(m1_ttl(),q6);
+            BOOST_REQUIRE(!r6);
+            std::vector<uint32_t> vals6;
+            for (size_t i=0;i<r6->size();i++)
+            {
+                vals6.push_back(r6->at(i).template unit<u1_ttl::type>()->fieldValue(u1_ttl::f1));
+            }
+            results.push_back(vals6);
+            BOOST_REQUIRE_EQUAL(vals6.size(),30);
+            for (size_t i=0;i<vals6.size();i++)
+            {
+                // alive values are 0..7, 16..23, 32..39, ...
+                auto k=20+i;
+                BOOST_CHECK_EQUAL(vals6[i],(k/topicCount)*2*topicCount+k%topicCount);
+            }
+        };
+        PrepareDbAndRun::eachPlugin(handler,configFile);
+    };
+
+    // the same queries must give the same results when partitions and topics are scanned sequentially and in parallel
+    Results sequentialResults;
+    run("simple1.jsonc",sequentialResults);
+    Results parallelResults;
+    run("parallelsearch.jsonc",parallelResults);
+    BOOST_REQUIRE_EQUAL(sequentialResults.size(),parallelResults.size());
+    for (size_t i=0;i<sequentialResults.size();i++)
+    {
+        BOOST_CHECK(sequentialResults[i]==parallelResults[i]);
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 /** @todo Test:
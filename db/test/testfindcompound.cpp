@@ -13,6 +13,8 @@
 
 /****************************************************************************/
 
+#include <hatn/common/elapsedtimer.h>
+
 #include "findcompound.h"
 
 #include "finddefs.h"
@@ -24,4 +26,52 @@ BOOST_AUTO_TEST_SUITE(TestFindCompound, *boost::unit_test::fixture<HATN_TEST_NAM
 
 #include "findcases.ipp"
 
+BOOST_AUTO_TEST_CASE(InVectorBench, *boost::unit_test::disabled())
+{
+    init();
+    registerModels();
+    auto s1=initSchema(ModelRef);
+
+    auto handler=[&s1](std::shared_ptr<DbPlugin>, std::shared_ptr<Client> client)
+    {
+        setSchemaToClient(client,s1);
+
+        constexpr const size_t count=20000;
+        for (size_t i=0;i<count;i++)
+        {
+            auto o=makeInitObject<comp::type>();
+            o.setFieldValue(FieldUInt32,static_cast<uint32_t>(i));
+            o.field(comp::ext1).set(fmt::format("comp_{:02d}",i%5));
+            auto ec=client->create(topic(),ModelRef,&o);
+            BOOST_REQUIRE(!ec);
+        }
+
+        common::ElapsedTimer elapsed;
+        for (size_t valsCount: {10,100,500})
+        {
+            std::vector<uint32_t> vals;
+            for (size_t i=0;i<valsCount;i++)
+            {
+                vals.push_back(static_cast<uint32_t>(i*(count/valsCount)));
+            }
+            auto q=makeQuery(IdxUInt32,query::where(FieldUInt32,query::in,vals)
+                                          .and_(comp::ext1,query::eq,queryExtVal),
+                               topic());
+            q.setLimit(0);
+
+            constexpr const size_t runs=100;
+            elapsed.reset();
+            for (size_t i=0;i<runs;i++)
+            {
+                auto r=client->find(ModelRef,q);
+                BOOST_REQUIRE(!r);
+            }
+            auto ms=elapsed.elapsed().totalMilliseconds;
+            BOOST_TEST_MESSAGE(fmt::format("find compound in {} values: {} runs in {} ms, {:.2f} ms per query",
+                                           valsCount,runs,ms,double(ms)/runs));
+        }
+    };
+    PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -39,6 +39,7 @@
 #ifdef HATN_ENABLE_PLUGIN_ROCKSDB
 #include <hatn/db/plugins/rocksdb/ipp/fieldvaluetobuf.ipp>
 #include <hatn/db/plugins/rocksdb/ipp/rocksdbmodels.ipp>
+#include <hatn/db/plugins/rocksdb/modeltopics.h>
 #endif
 
 HATN_USING
@@ -271,6 +272,151 @@ BOOST_AUTO_TEST_CASE(NotPartitioned)
     PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
 }
 
+BOOST_AUTO_TEST_CASE(ListTopics)
+{
+    init();
+
+    auto s1=initSchema(modelNoP1(),modelNoP2(),modelNoP3(),modelNoP4());
+
+    auto handler=[&s1](std::shared_ptr<DbPlugin> plugin, std::shared_ptr<Client> client)
+    {
+        setSchemaToClient(client,s1);
+
+        constexpr const size_t count=10;
+        std::vector<Topic> topics{"topic0","topic1"};
+        std::vector<ObjectId> oids;
+
+        // create objects
+        Error ec;
+        for (size_t i=0;i<count;i++)
+        {
+            auto o=makeInitObject<no_p::type>();
+            o.setFieldValue(base_fields::df2,i);
+            ec=client->create(topics[i%topics.size()],modelNoP1(),&o);
+            BOOST_REQUIRE(!ec);
+            if (i%topics.size()==0)
+            {
+                oids.push_back(o.fieldValue(Oid));
+            }
+        }
+
+        auto r1=client->listModelTopics(modelNoP1());
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1->size(),topics.size());
+        auto r2=client->listModelTopics(modelNoP2());
+        BOOST_REQUIRE(!r2);
+        BOOST_CHECK_EQUAL(r2->size(),0);
+
+        // delete all objects of the first topic
+        for (auto&& oid: oids)
+        {
+            ec=client->deleteObject(topics[0],modelNoP1(),oid);
+            BOOST_REQUIRE(!ec);
+        }
+        r1=client->listModelTopics(modelNoP1());
+        BOOST_REQUIRE(!r1);
+        BOOST_REQUIRE_EQUAL(r1->size(),1);
+        BOOST_CHECK_EQUAL(std::string{r1->begin()->topic()},std::string{topics[1].topic()});
+        auto c1=client->count(modelNoP1());
+        BOOST_REQUIRE(!c1);
+        BOOST_CHECK_EQUAL(c1.value(),count-oids.size());
+
+        // rebuild relations
+        ec=client->migrateSchema();
+        BOOST_REQUIRE(!ec);
+        r1=client->listModelTopics(modelNoP1());
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1->size(),1);
+        c1=client->count(modelNoP1());
+        BOOST_REQUIRE(!c1);
+        BOOST_CHECK_EQUAL(c1.value(),count-oids.size());
+        c1=client->count(modelNoP1(),topics[1]);
+        BOOST_REQUIRE(!c1);
+        BOOST_CHECK_EQUAL(c1.value(),count-oids.size());
+    };
+    PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
+}
+
+BOOST_AUTO_TEST_CASE(CountQuery)
+{
+    init();
+
+    auto s1=initSchema(modelNoP1(),modelNoP2(),modelNoP3(),modelNoP4());
+
+    auto handler=[&s1](std::shared_ptr<DbPlugin>, std::shared_ptr<Client> client)
+    {
+        setSchemaToClient(client,s1);
+
+        constexpr const size_t count=30;
+        std::vector<Topic> topics{"topic0","topic1","topic2"};
+
+        // create objects
+        for (size_t i=0;i<count;i++)
+        {
+            auto o=makeInitObject<no_p::type>();
+            o.setFieldValue(base_fields::df2,i);
+            auto ec=client->create(topics[i%topics.size()],modelNoP1(),&o);
+            BOOST_REQUIRE(!ec);
+        }
+
+        // check that query is answered by counters or by index scan
+        auto checkCounters=[](const auto& q, bool byCounters)
+        {
+#ifdef HATN_ENABLE_PLUGIN_ROCKSDB
+            std::string modelIndexId;
+            BOOST_CHECK_EQUAL(rdb::CountT::allObjectsQuery(modelNoP1()->model,ModelIndexQuery{q,modelIndexId}),byCounters);
+#else
+            std::ignore=q;
+            std::ignore=byCounters;
+#endif
+        };
+
+        // count all objects of all topics using counters
+        auto q1=makeQuery(oidIdx(),query::where(object::_id,query::gte,query::First),topics);
+        q1.setLimit(0);
+        auto r1=client->count(modelNoP1(),q1);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1.value(),count);
+        checkCounters(q1,true);
+
+        // count all objects of one topic using counters
+        auto q2=makeQuery(oidIdx(),query::where(object::_id,query::lte,query::Last),topics[1]);
+        q2.setLimit(0);
+        r1=client->count(modelNoP1(),q2);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1.value(),count/topics.size());
+        checkCounters(q2,true);
+
+        // count with offset and limit using counters
+        q1.setLimit(15);
+        q1.setOffset(20);
+        r1=client->count(modelNoP1(),q1);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1.value(),count-20);
+        checkCounters(q1,true);
+
+        // count by scan of filtered query
+        auto q3=makeQuery(df2Idx(),query::where(base_fields::df2,query::lt,uint32_t(12)),topics);
+        q3.setLimit(0);
+        r1=client->count(modelNoP1(),q3);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1.value(),12);
+        checkCounters(q3,false);
+
+        // counters follow deletes
+        auto rd=client->deleteMany(modelNoP1(),q3);
+        BOOST_REQUIRE(!rd);
+        BOOST_CHECK_EQUAL(rd.value(),12);
+        q1.setLimit(0);
+        q1.setOffset(0);
+        r1=client->count(modelNoP1(),q1);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1.value(),count-12);
+        checkCounters(q1,true);
+    };
+    PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
+}
+
 BOOST_AUTO_TEST_CASE(Partitions)
 {
     init();
@@ -19,6 +19,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <hatn/common/format.h>
+#include <hatn/common/elapsedtimer.h>
 
 #include <hatn/test/multithreadfixture.h>
 
@@ -379,6 +380,73 @@ BOOST_FIXTURE_TEST_CASE(ConcurrentMerge, HATN_TEST_NAMESPACE::DbTestFixture)
     BOOST_CHECK_EQUAL(result,count*jobs);
 }
 
+BOOST_AUTO_TEST_CASE(RocksdbMultiGetBench, *boost::unit_test::disabled())
+{
+    std::string dbPath=hatn::test::MultiThreadFixture::tmpFilePath("rocksdbmultiget");
+
+    // open
+    auto db=openDatabase(dbPath);
+
+    // fill database with objects
+    size_t objectsCount=100000;
+    std::string value(256,'v');
+    std::vector<std::string> keys;
+    keys.reserve(objectsCount);
+    for (size_t i=0;i<objectsCount;i++)
+    {
+        keys.push_back(fmt::format("topic1_{:08d}",(i*7919)%objectsCount));
+        auto status=db->Put(ROCKSDB_NAMESPACE::WriteOptions{},keys.back(),value);
+        BOOST_REQUIRE(status.ok());
+    }
+    auto status=db->Flush(ROCKSDB_NAMESPACE::FlushOptions{});
+    BOOST_REQUIRE(status.ok());
+
+    size_t runs=100;
+    std::vector<size_t> resultSizes{10,100,1000};
+    for (auto resultSize: resultSizes)
+    {
+        std::vector<ROCKSDB_NAMESPACE::Slice> resultKeys;
+        resultKeys.reserve(resultSize);
+        for (size_t i=0;i<resultSize;i++)
+        {
+            const auto& key=keys[(i*objectsCount)/resultSize];
+            resultKeys.emplace_back(key.data(),key.size());
+        }
+
+        // read with Get for each key
+        ElapsedTimer elapsed;
+        for (size_t j=0;j<runs;j++)
+        {
+            for (auto&& key: resultKeys)
+            {
+                ROCKSDB_NAMESPACE::PinnableSlice readValue;
+                status=db->Get(ROCKSDB_NAMESPACE::ReadOptions{},db->DefaultColumnFamily(),key,&readValue);
+                BOOST_REQUIRE(status.ok());
+            }
+        }
+        auto getMs=elapsed.elapsed().totalMilliseconds;
+
+        // read with batched MultiGet
+        elapsed.reset();
+        std::vector<ROCKSDB_NAMESPACE::PinnableSlice> readValues(resultSize);
+        std::vector<ROCKSDB_NAMESPACE::Status> statuses(resultSize);
+        for (size_t j=0;j<runs;j++)
+        {
+            db->MultiGet(ROCKSDB_NAMESPACE::ReadOptions{},db->DefaultColumnFamily(),resultSize,resultKeys.data(),readValues.data(),statuses.data());
+            for (size_t i=0;i<resultSize;i++)
+            {
+                BOOST_REQUIRE(statuses[i].ok());
+                readValues[i].Reset();
+            }
+        }
+        auto multiGetMs=elapsed.elapsed().totalMilliseconds;
+
+        BOOST_TEST_MESSAGE(fmt::format("Result size {}, runs {}: Get {} ms, MultiGet {} ms",resultSize,runs,getMs,multiGetMs));
+    }
+
+    closeDatabase(db);
+}
+
 #else
 
 BOOST_AUTO_TEST_CASE(RocksdDbSkip)
@@ -640,4 +640,113 @@ BOOST_AUTO_TEST_CASE(FindUpdateCreate)
     PrepareDbAndRun::eachPlugin(handler,"simple1.jsonc");
 }
 
+BOOST_AUTO_TEST_CASE(MergeUpdate)
+{
+    HATN_CTX_SCOPE("MergeUpdate")
+
+    init();
+
+    auto s1=initSchema(modelPlain());
+
+    auto handler=[&s1](std::shared_ptr<DbPlugin> plugin, std::shared_ptr<Client> client)
+    {
+        setSchemaToClient(client,s1);
+
+        Topic topic1{"topic1"};
+
+        int16_t val1=100;
+        double val2=1.5;
+        size_t count=10;
+
+        // create objects
+        ObjectId middleOid;
+        for (size_t i=0;i<count;i++)
+        {
+            auto o1=makeInitObject<plain::type>();
+            o1.setFieldValue(FieldInt16,val1+i);
+            o1.setFieldValue(FieldDouble,val2);
+
+            if (i==count/2)
+            {
+                middleOid=o1.fieldValue(object::_id);
+            }
+
+            // create object in db
+            auto ec=client->create(topic1,modelPlain(),&o1);
+            BOOST_REQUIRE(!ec);
+        }
+
+        // update not indexed field several times, updates are merged
+        auto updateReq1=update::request(
+            update::field(FieldDouble,update::inc,1.0)
+        );
+        size_t incCount=5;
+        for (size_t i=0;i<incCount;i++)
+        {
+            auto ec=client->update(topic1,modelPlain(),middleOid,updateReq1);
+            BOOST_REQUIRE(!ec);
+        }
+
+        // read updated object
+        auto r1=client->read(topic1,modelPlain(),middleOid);
+        BOOST_REQUIRE(!r1);
+        BOOST_CHECK_EQUAL(r1.value()->fieldValue(FieldDouble),val2+incCount);
+        BOOST_CHECK_EQUAL(r1.value()->fieldValue(FieldInt16),val1+count/2);
+        BOOST_CHECK(r1.value()->fieldValue(object::updated_at)>=r1.value()->fieldValue(object::created_at));
+
+        // update indexed field with read-modify-write after merged updates
+        auto updateReq2=update::request(
+            update::field(FieldInt16,update::set,1000),
+            update::field(FieldDouble,update::inc,1.0)
+        );
+        auto ec=client->update(topic1,modelPlain(),middleOid,updateReq2);
+        BOOST_REQUIRE(!ec);
+        auto q1=makeQuery(IdxInt16,query::where(FieldInt16,query::eq,1000),topic1);
+        auto r2=client->find(modelPlain(),q1);
+        BOOST_REQUIRE(!r2);
+        BOOST_REQUIRE_EQUAL(r2->size(),1);
+        BOOST_CHECK_EQUAL(r2->at(0).unit<plain::type>()->fieldValue(FieldDouble),val2+incCount+1);
+
+        // find all objects, merged update does not break indexes
+        auto r3=client->findAll(topic1,modelPlain());
+        BOOST_REQUIRE(!r3);
+        BOOST_CHECK_EQUAL(r3->size(),count);
+
+        // merged update does not read the object, so update of not existing object succeeds but the object is not found on read
+        auto updateReq3=update::request(
+            update::field(FieldDouble,update::set,100.0)
+        );
+        ObjectId unknownOid=ObjectId::generateId();
+        ec=client->update(topic1,modelPlain(),unknownOid,updateReq3);
+        BOOST_CHECK(!ec);
+        auto r4=client->read(topic1,modelPlain(),unknownOid);
+        BOOST_CHECK(r4);
+        r3=client->findAll(topic1,modelPlain());
+        BOOST_REQUIRE(!r3);
+        BOOST_CHECK_EQUAL(r3->size(),count);
+        auto r5=client->count(modelPlain(),topic1);
+        BOOST_REQUIRE(!r5);
+        BOOST_CHECK_EQUAL(r5.value(),count);
+
+        // update of indexed field of not existing object is not found
+        ec=client->update(topic1,modelPlain(),unknownOid,updateReq2);
+        BOOST_CHECK(ec);
+
+#ifdef HATN_ENABLE_PLUGIN_ROCKSDB
+        // merge fails if model is not registered, operands are not dropped
+        ec=client->update(topic1,modelPlain(),middleOid,updateReq1);
+        BOOST_REQUIRE(!ec);
+        rdb::RocksdbModels::instance().unregisterModel(modelPlain());
+        auto r6=client->read(topic1,modelPlain(),middleOid);
+        BOOST_CHECK(r6);
+        rdb::RocksdbModels::instance().registerModel(modelPlain());
+        auto r7=client->read(topic1,modelPlain(),middleOid);
+        BOOST_REQUIRE(!r7);
+        BOOST_CHECK_EQUAL(r7.value()->fieldValue(FieldDouble),val2+incCount+2);
+        BOOST_CHECK_EQUAL(r7.value()->fieldValue(FieldInt16),1000);
+#endif
+    };
+    PrepareDbAndRun::eachPlugin(handler,"mergeupdate.jsonc");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,684 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+
+/** @file logcontext/binlogformatter.h
+  *
+  *  Defines formatter of logs to buffer in compact binary form and decoder of binary logs.
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNCTXBINLOGFORMATTER_H
+#define HATNCTXBINLOGFORMATTER_H
+
+#include <cstring>
+#include <limits>
+
+#include <fmt/chrono.h>
+
+#include <hatn/common/apierror.h>
+#include <hatn/common/format.h>
+
+#include <hatn/logcontext/context.h>
+
+HATN_LOGCONTEXT_NAMESPACE_BEGIN
+
+/**
+ * Binary log record consists of the following fields, all numbers are in host byte order:
+ *  - uint32 size of the record including this field;
+ *  - uint8 magic;
+ *  - uint8 version;
+ *  - int8 log level;
+ *  - uint8 flags;
+ *  - int64 timestamp in microseconds since epoch;
+ *  - uint64 microseconds elapsed since the context was started, set only in close records;
+ *  - str context ID;
+ *  - str context name;
+ *  - str API status, if FlagApiStatus is set;
+ *  - uint16 number of scopes followed by pairs of str name and str error of each scope, if FlagStack is set;
+ *  - str error code, if FlagError is set;
+ *  - str error message, if FlagErrorMessage is set;
+ *  - str message;
+ *  - str module;
+ *  - uint16 number of variables followed by str key, uint8 index of value type and value of each variable.
+ *
+ * str is uint32 length followed by characters.
+ * Values of arithmetic and date/time types are kept as is, strings are kept as str.
+ */
+namespace binlog {
+
+constexpr const uint8_t Magic=0xB7;
+constexpr const uint8_t Version=2;
+
+constexpr const size_t HeaderSize=24;
+constexpr const size_t FlagsOffset=7;
+
+//! Max size of record, header with greater size is treated as corrupted.
+constexpr const size_t MaxRecordSize=16*1024*1024;
+using StringLength=uint32_t;
+constexpr const size_t MaxStringLength=(std::numeric_limits<StringLength>::max)();
+
+enum Flag : uint8_t
+{
+    FlagClose=0x01,
+    FlagApiStatus=0x02,
+    FlagError=0x04,
+    FlagErrorMessage=0x08,
+    FlagStack=0x10
+};
+
+enum class ValueType : uint8_t
+{
+    Int8,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Int64,
+    UInt64,
+    Float,
+    Double,
+    DateTime,
+    Date,
+    Time,
+    DateRange,
+    String
+};
+
+template <ValueType Type, typename T>
+constexpr bool isValueType() noexcept
+{
+    return std::is_same<lib::variant_alternative_t<static_cast<size_t>(Type),Value>,T>::value
+            &&
+           std::is_same<lib::variant_alternative_t<static_cast<size_t>(Type),ImmediateValue>,T>::value;
+}
+
+// index of value type is written as index of variant alternative, so types must be in the same order
+static_assert(isValueType<ValueType::Int8,int8_t>(),"ValueType::Int8 mismatches variant of values");
+static_assert(isValueType<ValueType::UInt8,uint8_t>(),"ValueType::UInt8 mismatches variant of values");
+static_assert(isValueType<ValueType::Int16,int16_t>(),"ValueType::Int16 mismatches variant of values");
+static_assert(isValueType<ValueType::UInt16,uint16_t>(),"ValueType::UInt16 mismatches variant of values");
+static_assert(isValueType<ValueType::Int32,int32_t>(),"ValueType::Int32 mismatches variant of values");
+static_assert(isValueType<ValueType::UInt32,uint32_t>(),"ValueType::UInt32 mismatches variant of values");
+static_assert(isValueType<ValueType::Int64,int64_t>(),"ValueType::Int64 mismatches variant of values");
+static_assert(isValueType<ValueType::UInt64,uint64_t>(),"ValueType::UInt64 mismatches variant of values");
+static_assert(isValueType<ValueType::Float,float>(),"ValueType::Float mismatches variant of values");
+static_assert(isValueType<ValueType::Double,double>(),"ValueType::Double mismatches variant of values");
+static_assert(isValueType<ValueType::DateTime,common::DateTime>(),"ValueType::DateTime mismatches variant of values");
+static_assert(isValueType<ValueType::Date,common::Date>(),"ValueType::Date mismatches variant of values");
+static_assert(isValueType<ValueType::Time,common::Time>(),"ValueType::Time mismatches variant of values");
+static_assert(isValueType<ValueType::DateRange,common::DateRange>(),"ValueType::DateRange mismatches variant of values");
+static_assert(std::is_same<lib::variant_alternative_t<static_cast<size_t>(ValueType::String),Value>,StringT<>>::value,
+              "ValueType::String mismatches variant of values");
+static_assert(std::is_same<lib::variant_alternative_t<static_cast<size_t>(ValueType::String),ImmediateValue>,lib::string_view>::value,
+              "ValueType::String mismatches variant of immediate values");
+static_assert(lib::variant_size<Value>::value==static_cast<size_t>(ValueType::String)+1,"Number of value types mismatches variant of values");
+
+template <typename BufT, typename T>
+void appendRaw(BufT& buf, const T& v)
+{
+    static_assert(std::is_trivially_copyable<T>::value,"Only trivially copyable types can be appended as is");
+    auto p=reinterpret_cast<const char*>(&v);
+    buf.append(p,p+sizeof(T));
+}
+
+template <typename BufT, typename T>
+void patchRaw(BufT& buf, size_t offset, const T& v)
+{
+    std::memcpy(buf.data()+offset,&v,sizeof(T));
+}
+
+template <typename BufT>
+void appendString(BufT& buf, const char* data, size_t size)
+{
+    auto len=static_cast<StringLength>((std::min)(size,MaxStringLength));
+    appendRaw(buf,len);
+    buf.append(data,data+len);
+}
+
+template <typename BufT>
+void appendString(BufT& buf, const lib::string_view& str)
+{
+    appendString(buf,str.data(),str.size());
+}
+
+template <typename BufT>
+void appendCString(BufT& buf, const char* str)
+{
+    if (str==nullptr)
+    {
+        appendString(buf,str,0);
+        return;
+    }
+    appendString(buf,str,std::strlen(str));
+}
+
+template <typename BufT, typename ContainerT>
+void appendContainer(BufT& buf, const ContainerT& str)
+{
+    appendString(buf,str.data(),str.size());
+}
+
+template <typename BufT>
+struct ValueEncoder
+{
+    ValueEncoder(BufT &buf):buf(buf)
+    {}
+
+    BufT &buf;
+
+    template <typename T>
+    void operator()(const T& v)
+    {
+        appendRaw(buf,v);
+    }
+
+    template <size_t Length>
+    void operator()(const StringT<Length>& v)
+    {
+        appendContainer(buf,v);
+    }
+
+    void operator()(const lib::string_view& v)
+    {
+        appendString(buf,v);
+    }
+};
+
+template <typename BufT, typename RecordT>
+void appendRecord(BufT& buf, const RecordT& rec)
+{
+    appendContainer(buf,rec.first);
+    appendRaw(buf,static_cast<uint8_t>(lib::variantIndex(rec.second)));
+    ValueEncoder<BufT> encoder(buf);
+    lib::variantVisit(encoder,rec.second);
+}
+
+}
+
+/**
+ * @brief Formatter of log records to compact binary form.
+ *
+ * Values are copied to the buffer without text conversion which can be done later
+ * in logger thread or offline with BinaryLogDecoder.
+ */
+template <typename ContextT=Subcontext>
+class BinaryLogFormatterT
+{
+    public:
+
+        template <typename BufT,
+                  typename ErrorT=hana::false_,
+                  typename CloseT=hana::false_,
+                  typename WithApiStatusT=hana::false_>
+        static void format(
+            BufT& buf,
+            LogLevel level,
+            const ContextT* ctx,
+            const char* msg,
+            const lib::string_view& module,
+            ErrorT ec=ErrorT{},
+            CloseT ct=CloseT{},
+            WithApiStatusT api=WithApiStatusT{}
+        )
+        {
+            doFormat(buf,level,ctx,msg,nullptr,module,ec,ct,api);
+        }
+
+        template <typename BufT,
+                 typename ErrorT=hana::false_,
+                 typename CloseT=hana::false_,
+                 typename WithApiStatusT=hana::false_>
+        static void format(
+            BufT& buf,
+            LogLevel level,
+            const ContextT* ctx,
+            const char* msg,
+            const ImmediateRecords& records,
+            const lib::string_view& module,
+            ErrorT ec=ErrorT{},
+            CloseT ct=CloseT{},
+            WithApiStatusT api=WithApiStatusT{}
+            )
+        {
+            doFormat(buf,level,ctx,msg,&records,module,ec,ct,api);
+        }
+
+    private:
+
+        template <typename BufT,
+                 typename ErrorT,
+                 typename CloseT,
+                 typename WithApiStatusT>
+        static void doFormat(
+            BufT& buf,
+            LogLevel level,
+            const ContextT* ctx,
+            const char* msg,
+            const ImmediateRecords* records,
+            const lib::string_view& module,
+            ErrorT ec,
+            CloseT,
+            WithApiStatusT
+            )
+        {
+            // add header
+            size_t start=buf.size();
+            uint8_t flags=0;
+            binlog::appendRaw(buf,uint32_t(0));
+            binlog::appendRaw(buf,binlog::Magic);
+            binlog::appendRaw(buf,binlog::Version);
+            binlog::appendRaw(buf,static_cast<int8_t>(level));
+            binlog::appendRaw(buf,flags);
+            auto tp=std::chrono::floor<std::chrono::microseconds>(ctx->mainCtx().now());
+            binlog::appendRaw(buf,static_cast<int64_t>(tp.time_since_epoch().count()));
+            uint64_t us=0;
+            if (!std::is_same<CloseT,hana::false_>::value)
+            {
+                flags|=binlog::FlagClose;
+                us=ctx->mainCtx().finishMicroseconds();
+            }
+            binlog::appendRaw(buf,us);
+
+            // add context ID and name
+            binlog::appendContainer(buf,ctx->mainCtx().id());
+            binlog::appendContainer(buf,ctx->mainCtx().name());
+
+            auto addStack=[&](bool full)
+            {
+                if (ctx->scopeStack().empty())
+                {
+                    return;
+                }
+
+                size_t maxIdx=ctx->scopeStack().size();
+                if (!std::is_same<CloseT,hana::false_>::value)
+                {
+                    auto lockIdx=ctx->lockScopeIdx();
+                    if (!full && lockIdx!=0)
+                    {
+                        maxIdx=(std::min)(lockIdx,maxIdx);
+                    }
+                }
+
+                flags|=binlog::FlagStack;
+                binlog::appendRaw(buf,static_cast<uint16_t>(maxIdx));
+                for (size_t i=0;i<maxIdx;i++)
+                {
+                    const auto& scope=ctx->scopeStack().at(i);
+                    binlog::appendCString(buf,scope.first);
+
+                    hana::eval_if(
+                        std::is_same<ErrorT,hana::false_>{},
+                        [&](auto _)
+                        {
+                            binlog::appendCString(_(buf),nullptr);
+                        },
+                        [&](auto _)
+                        {
+                            if (_(ec) && !common::StrEmpty(_(scope).second.error))
+                            {
+                                binlog::appendCString(_(buf),_(scope).second.error);
+                            }
+                            else
+                            {
+                                binlog::appendCString(_(buf),nullptr);
+                            }
+                        }
+                        );
+                }
+            };
+
+            // for CLOSE request add api status if applicable and stack only in case of error
+            bool resetStacks=false;
+            hana::eval_if(
+                std::is_same<CloseT,hana::false_>{},
+                [&](auto _){
+                    _(addStack)(true);
+                },
+                [&](auto _){
+                    hana::eval_if(
+                        std::is_same<WithApiStatusT,hana::true_>{},
+                        [&](auto _)
+                        {
+                            const char* status=common::ApiError::DefaultStatus;
+                            if (_(ec))
+                            {
+                                if (_(ec).apiError()!=nullptr)
+                                {
+                                    status=_(ec).apiError()->status();
+                                }
+                                else
+                                {
+                                    status=_(ec).error();
+                                }
+                            }
+                            _(flags)|=binlog::FlagApiStatus;
+                            binlog::appendCString(_(buf),status);
+                        },
+                        [](auto){}
+                    );
+                    _(resetStacks)=true;
+
+                    if (_(ec))
+                    {
+                        _(addStack)(false);
+                    }
+                }
+            );
+
+            // add error, error is rare so it is converted to string immediately
+            hana::eval_if(
+                std::is_same<ErrorT,hana::false_>{},
+                [](auto){},
+                [&](auto _)
+                {
+                    if (_(ec))
+                    {
+                        _(flags)|=binlog::FlagError;
+                        size_t offset=_(buf).size();
+                        binlog::appendRaw(_(buf),binlog::StringLength(0));
+                        _(ec).codeString(_(buf));
+                        auto len=(std::min)(_(buf).size()-offset-sizeof(binlog::StringLength),binlog::MaxStringLength);
+                        _(buf).resize(offset+sizeof(binlog::StringLength)+len);
+                        binlog::patchRaw(_(buf),offset,static_cast<binlog::StringLength>(len));
+
+                        if (_(ec).isType(common::Error::Type::Native))
+                        {
+                            _(flags)|=binlog::FlagErrorMessage;
+                            binlog::appendString(_(buf),lib::string_view(_(ec).message()));
+                        }
+                        _(resetStacks)=false;
+                    }
+                }
+            );
+
+            // add message and module
+            binlog::appendCString(buf,msg);
+            binlog::appendString(buf,module);
+
+            // reset stacks
+            if (resetStacks)
+            {
+                auto* c=const_cast<ContextT*>(ctx);
+                c->resetStacks();
+            }
+
+            // add variables
+            size_t countOffset=buf.size();
+            uint16_t count=0;
+            binlog::appendRaw(buf,count);
+            auto addRecords=[&](const auto& recs)
+            {
+                for (const auto& rec:recs)
+                {
+                    binlog::appendRecord(buf,rec);
+                    ++count;
+                }
+            };
+            addRecords(ctx->fixedVars());
+            addRecords(ctx->globalVars());
+            addRecords(ctx->stackVars());
+            if (records!=nullptr)
+            {
+                addRecords(*records);
+            }
+
+            // fill size, flags and number of variables
+            binlog::patchRaw(buf,countOffset,count);
+            binlog::patchRaw(buf,start+binlog::FlagsOffset,flags);
+            binlog::patchRaw(buf,start,static_cast<uint32_t>(buf.size()-start));
+
+            // replace too big record with header and notice so that the record can be decoded
+            auto recSize=buf.size()-start;
+            if (recSize>binlog::MaxRecordSize)
+            {
+                buf.resize(start+binlog::HeaderSize);
+                binlog::patchRaw(buf,start+binlog::FlagsOffset,static_cast<uint8_t>(flags&binlog::FlagClose));
+                binlog::appendContainer(buf,ctx->mainCtx().id());
+                binlog::appendContainer(buf,ctx->mainCtx().name());
+                binlog::appendString(buf,lib::string_view(fmt::format("log record of {} bytes is too big",recSize)));
+                binlog::appendString(buf,module);
+                binlog::appendRaw(buf,uint16_t(0));
+                binlog::patchRaw(buf,start,static_cast<uint32_t>(buf.size()-start));
+            }
+        }
+};
+using BinaryLogFormatter=BinaryLogFormatterT<>;
+
+/**
+ * @brief Decoder of binary log records to text.
+ *
+ * Text is the same as TextLogFormatter would produce for original record.
+ */
+class BinaryLogDecoder
+{
+    public:
+
+        /**
+         * @brief Get size of binary record.
+         * @param data Data beginning with binary record.
+         * @param size Size of data.
+         * @return Size of the record or 0 if data does not contain a complete valid record.
+         */
+        static size_t recordSize(const char* data, size_t size) noexcept
+        {
+            if (size<binlog::HeaderSize)
+            {
+                return 0;
+            }
+            uint32_t recSize=0;
+            std::memcpy(&recSize,data,sizeof(recSize));
+            if (recSize<binlog::HeaderSize
+                || recSize>binlog::MaxRecordSize
+                || recSize>size
+                || static_cast<uint8_t>(data[sizeof(recSize)])!=binlog::Magic
+                || static_cast<uint8_t>(data[sizeof(recSize)+1])!=binlog::Version
+               )
+            {
+                return 0;
+            }
+            return recSize;
+        }
+
+        /**
+         * @brief Decode binary record to text.
+         * @param buf Buffer to append text to.
+         * @param data Data beginning with binary record.
+         * @param size Size of data.
+         * @return Size of decoded record or 0 if data does not contain a complete valid record.
+         */
+        template <typename BufT>
+        static size_t toText(BufT& buf, const char* data, size_t size)
+        {
+            auto recSize=recordSize(data,size);
+            if (recSize==0)
+            {
+                return 0;
+            }
+
+            Reader reader{data,recSize,sizeof(uint32_t)+2*sizeof(uint8_t)};
+            auto level=static_cast<LogLevel>(reader.read<int8_t>());
+            auto flags=reader.read<uint8_t>();
+            auto ts=reader.read<int64_t>();
+            auto us=reader.read<uint64_t>();
+            auto id=reader.readString();
+            auto name=reader.readString();
+
+            // add time point and context ID
+            std::chrono::time_point<std::chrono::system_clock,std::chrono::microseconds> tp{std::chrono::microseconds{ts}};
+            fmt::format_to(std::back_inserter(buf),"{:%m%dT%H:%M:%S}"
+                                                    " lvl={}"
+                                                    " ctx=",
+                           tp,
+                           logLevelName(level)
+                        );
+            buf.append(id);
+            if (!name.empty())
+            {
+                buf.append(lib::string_view(" op="));
+                buf.append(name);
+            }
+
+            // add elapsed microseconds and api status of CLOSE request
+            if (flags & binlog::FlagClose)
+            {
+                fmt::format_to(std::back_inserter(buf)," us={}",us);
+            }
+            if (flags & binlog::FlagApiStatus)
+            {
+                buf.append(lib::string_view(" api_s="));
+                buf.append(reader.readString());
+            }
+
+            // add scope stack
+            if (flags & binlog::FlagStack)
+            {
+                auto count=reader.read<uint16_t>();
+                buf.append(lib::string_view(" stack=\""));
+                for (size_t i=0;i<count && reader.ok;i++)
+                {
+                    if (i!=0)
+                    {
+                        buf.append(lib::string_view("."));
+                    }
+                    buf.append(reader.readString());
+                    auto error=reader.readString();
+                    if (!error.empty())
+                    {
+                        buf.append(lib::string_view("("));
+                        buf.append(error);
+                        buf.append(lib::string_view(")"));
+                    }
+                }
+                buf.append(lib::string_view("\""));
+            }
+
+            // add error
+            if (flags & binlog::FlagError)
+            {
+                buf.append(lib::string_view(" err="));
+                buf.append(reader.readString());
+                if (flags & binlog::FlagErrorMessage)
+                {
+                    buf.append(lib::string_view(" err_msg=\""));
+                    buf.append(reader.readString());
+                    buf.append(lib::string_view("\""));
+                }
+            }
+
+            // add message and module
+            auto msg=reader.readString();
+            if (!msg.empty())
+            {
+                buf.append(lib::string_view(" msg=\""));
+                buf.append(msg);
+                buf.append(lib::string_view("\""));
+            }
+            auto module=reader.readString();
+            if (!module.empty())
+            {
+                buf.append(lib::string_view(" mdl="));
+                buf.append(module);
+            }
+
+            // add variables
+            auto count=reader.read<uint16_t>();
+            for (size_t i=0;i<count && reader.ok;i++)
+            {
+                auto key=reader.readString();
+                auto value=readValue(reader);
+                if (!reader.ok)
+                {
+                    break;
+                }
+                buf.append(lib::string_view(" "));
+                buf.append(key);
+                buf.append(lib::string_view("="));
+                serializeValue(buf,value);
+            }
+
+            if (!reader.ok)
+            {
+                return 0;
+            }
+            return recSize;
+        }
+
+    private:
+
+        struct Reader
+        {
+            const char* data;
+            size_t size;
+            size_t pos;
+            bool ok=true;
+
+            template <typename T>
+            T read() noexcept
+            {
+                T v{};
+                if (!ok || (size-pos)<sizeof(T))
+                {
+                    ok=false;
+                    return v;
+                }
+                std::memcpy(&v,data+pos,sizeof(T));
+                pos+=sizeof(T);
+                return v;
+            }
+
+            lib::string_view readString() noexcept
+            {
+                auto len=read<binlog::StringLength>();
+                if (!ok || (size-pos)<len)
+                {
+                    ok=false;
+                    return lib::string_view{};
+                }
+                lib::string_view str{data+pos,len};
+                pos+=len;
+                return str;
+            }
+        };
+
+        static ImmediateValue readValue(Reader& reader)
+        {
+            using binlog::ValueType;
+
+            switch (static_cast<ValueType>(reader.read<uint8_t>()))
+            {
+                case(ValueType::Int8): return reader.read<int8_t>();
+                case(ValueType::UInt8): return reader.read<uint8_t>();
+                case(ValueType::Int16): return reader.read<int16_t>();
+                case(ValueType::UInt16): return reader.read<uint16_t>();
+                case(ValueType::Int32): return reader.read<int32_t>();
+                case(ValueType::UInt32): return reader.read<uint32_t>();
+                case(ValueType::Int64): return reader.read<int64_t>();
+                case(ValueType::UInt64): return reader.read<uint64_t>();
+                case(ValueType::Float): return reader.read<float>();
+                case(ValueType::Double): return reader.read<double>();
+                case(ValueType::DateTime): return reader.read<common::DateTime>();
+                case(ValueType::Date): return reader.read<common::Date>();
+                case(ValueType::Time): return reader.read<common::Time>();
+                case(ValueType::DateRange): return reader.read<common::DateRange>();
+                case(ValueType::String): return reader.readString();
+            }
+
+            reader.ok=false;
+            return ImmediateValue{};
+        }
+};
+
+HATN_LOGCONTEXT_NAMESPACE_END
+
+#endif // HATNCTXBINLOGFORMATTER_H
@@ -27,6 +27,7 @@
 
 #include <hatn/logcontext/context.h>
 #include <hatn/logcontext/logger.h>
+#include <hatn/logcontext/binlogformatter.h>
 
 HATN_LOGCONTEXT_NAMESPACE_BEGIN
 
@@ -288,9 +289,9 @@ class BufLoggerT : public LoggerHandlerT<ContextT>,
             ) override
         {
             auto bufWrapper=this->traits().prepareBuf();
-            TextLogFormatterT<ContextT>::format(bufWrapper.buf(),
-                                                level,ctx,msg,records,module
-                                                );
+            formatBuf(bufWrapper.buf(),
+                      level,ctx,msg,records,module
+                      );
             this->traits().logBuf(bufWrapper);
             this->traits().releaseBuf(bufWrapper);
         }
@@ -303,9 +304,9 @@ class BufLoggerT : public LoggerHandlerT<ContextT>,
             ) override
         {
             auto bufWrapper=this->traits().prepareBuf();
-            TextLogFormatterT<ContextT>::format(bufWrapper.buf(),
-                                                level,ctx,msg,module
-                                                );
+            formatBuf(bufWrapper.buf(),
+                      level,ctx,msg,module
+                      );
             this->traits().logBuf(bufWrapper);
             this->traits().releaseBuf(bufWrapper);
         }
@@ -320,10 +321,10 @@ class BufLoggerT : public LoggerHandlerT<ContextT>,
             ) override
         {
             auto bufWrapper=this->traits().prepareBuf();
-            TextLogFormatterT<ContextT>::format(bufWrapper.buf(),
-                                                level,ctx,msg,records,module,
-                                                ec
-                                                );
+            formatBuf(bufWrapper.buf(),
+                      level,ctx,msg,records,module,
+                      ec
+                      );
             this->traits().logBufError(bufWrapper);
             this->traits().releaseBuf(bufWrapper);
         }
@@ -337,10 +338,10 @@ class BufLoggerT : public LoggerHandlerT<ContextT>,
             ) override
         {
             auto bufWrapper=this->traits().prepareBuf();
-            TextLogFormatterT<ContextT>::format(bufWrapper.buf(),
-                                                level,ctx,msg,module,
-                                                ec
-                                                );
+            formatBuf(bufWrapper.buf(),
+                      level,ctx,msg,module,
+                      ec
+                      );
             this->traits().logBufError(bufWrapper);
             this->traits().releaseBuf(bufWrapper);
         }
@@ -355,11 +356,11 @@ class BufLoggerT : public LoggerHandlerT<ContextT>,
             ) override
         {
             auto bufWrapper=this->traits().prepareBuf();
-            TextLogFormatterT<ContextT>::format(bufWrapper.buf(),
-                                                level,ctx,msg,records,module,
-                                                ec,
-                                                hana::true_{}
-                                                );
+            formatBuf(bufWrapper.buf(),
+                      level,ctx,msg,records,module,
+                      ec,
+                      hana::true_{}
+                      );
             this->traits().logBuf(bufWrapper);
             this->traits().releaseBuf(bufWrapper);
         }
@@ -373,11 +374,11 @@ class BufLoggerT : public LoggerHandlerT<ContextT>,
             ) override
         {
             auto bufWrapper=this->traits().prepareBuf();
-            TextLogFormatterT<ContextT>::format(bufWrapper.buf(),
-                                                level,ctx,msg,module,
-                                                ec,
-                                                hana::true_{}
-                                                );
+            formatBuf(bufWrapper.buf(),
+                      level,ctx,msg,module,
+                      ec,
+                      hana::true_{}
+                      );
             this->traits().logBuf(bufWrapper);
             this->traits().releaseBuf(bufWrapper);
         }
@@ -392,12 +393,12 @@ class BufLoggerT : public LoggerHandlerT<ContextT>,
             ) override
         {
             auto bufWrapper=this->traits().prepareBuf();
-            TextLogFormatterT<ContextT>::format(bufWrapper.buf(),
-                                                level,ctx,msg,records,module,
-                                                ec,
-                                                hana::true_{},
-                                                hana::true_{}
-                                                );
+            formatBuf(bufWrapper.buf(),
+                      level,ctx,msg,records,module,
+                      ec,
+                      hana::true_{},
+                      hana::true_{}
+                      );
             this->traits().logBuf(bufWrapper);
             this->traits().releaseBuf(bufWrapper);
         }
@@ -411,15 +412,51 @@ class BufLoggerT : public LoggerHandlerT<ContextT>,
             ) override
         {
             auto bufWrapper=this->traits().prepareBuf();
-            TextLogFormatterT<ContextT>::format(bufWrapper.buf(),
-                                                level,ctx,msg,module,
-                                                ec,
-                                                hana::true_{},
-                                                hana::true_{}
-                                                );
+            formatBuf(bufWrapper.buf(),
+                      level,ctx,msg,module,
+                      ec,
+                      hana::true_{},
+                      hana::true_{}
+                      );
             this->traits().logBuf(bufWrapper);
             this->traits().releaseBuf(bufWrapper);
         }
+
+    private:
+
+        template <typename T>
+        static auto hasBinaryFormat(T t)
+        {
+            return hana::is_valid([](auto v) -> decltype((void)hana::traits::declval(v).isBinaryFormat()){})(t);
+        }
+
+        /**
+         * @brief Format record either to text or to binary form if traits support it.
+         *
+         * Binary records are converted to text later by traits.
+         */
+        template <typename BufT, typename ...Args>
+        void formatBuf(BufT& buf, Args&&... args)
+        {
+            hana::eval_if(
+                hasBinaryFormat(hana::type_c<Traits>),
+                [&](auto _)
+                {
+                    if (_(this)->traits().isBinaryFormat())
+                    {
+                        BinaryLogFormatterT<ContextT>::format(_(buf),args...);
+                    }
+                    else
+                    {
+                        TextLogFormatterT<ContextT>::format(_(buf),args...);
+                    }
+                },
+                [&](auto _)
+                {
+                    TextLogFormatterT<ContextT>::format(_(buf),args...);
+                }
+            );
+        }
 };
 
 HATN_LOGCONTEXT_NAMESPACE_END
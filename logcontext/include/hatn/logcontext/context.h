@@ -130,7 +130,9 @@ class ContextT : public HATN_COMMON_NAMESPACE::TaskSubcontext
                 m_barrierStackCapWarned(false),
                 m_nextBarrierId(1),
                 m_parentLogCtx(nullptr),
-                m_logger(nullptr)
+                m_logger(nullptr),
+                m_logLevelEpoch(0),
+                m_cachedLogLevel(LogLevel::Default)
         {}
 
         ~ContextT()=default;
@@ -483,11 +485,13 @@ class ContextT : public HATN_COMMON_NAMESPACE::TaskSubcontext
         void setTag(tagT tag)
         {
             m_tags.insert(std::move(tag));
+            resetLogLevelCache();
         }
 
         void unsetTag(const common::lib::string_view& tag)
         {
             m_tags.erase(tag);
+            resetLogLevelCache();
         }
 
         bool containsTag(const common::lib::string_view& tag) const
@@ -504,6 +508,34 @@ class ContextT : public HATN_COMMON_NAMESPACE::TaskSubcontext
         void setLogLevel(LogLevel level) noexcept
         {
             m_logLevel=level;
+            resetLogLevelCache();
+        }
+
+        /**
+         * @brief Get log level cached by logger.
+         * @param epoch Epoch of logger configuration.
+         * @param level Cached level.
+         * @return True if cached level is valid for this epoch of logger configuration.
+         */
+        bool cachedLogLevel(uint64_t epoch, LogLevel& level) const noexcept
+        {
+            if (m_logLevelEpoch!=epoch)
+            {
+                return false;
+            }
+            level=m_cachedLogLevel;
+            return true;
+        }
+
+        void cacheLogLevel(uint64_t epoch, LogLevel level) const noexcept
+        {
+            m_logLevelEpoch=epoch;
+            m_cachedLogLevel=level;
+        }
+
+        void resetLogLevelCache() noexcept
+        {
+            m_logLevelEpoch=0;
         }
 
         uint8_t debugVerbosity() const noexcept
@@ -560,6 +592,7 @@ class ContextT : public HATN_COMMON_NAMESPACE::TaskSubcontext
             m_globalVarMap.clear();
             m_tags.clear();
             m_fixedVars.clear();
+            resetLogLevelCache();
         }
 
         const auto& scopeStack() const noexcept
@@ -725,6 +758,9 @@ class ContextT : public HATN_COMMON_NAMESPACE::TaskSubcontext
         ContextT* m_parentLogCtx;
 
         Logger* m_logger;
+
+        mutable uint64_t m_logLevelEpoch;
+        mutable LogLevel m_cachedLogLevel;
 };
 using Context=ContextT<>;
 using Subcontext=Context;
@@ -78,6 +78,14 @@ class HATN_LOGCONTEXT_EXPORT FileLoggerTraits
 
         void logBufError(const FileLoggerBufWrapper& bufWrapper);
 
+        /**
+         * @brief Check if records must be formatted to binary form.
+         *
+         * Records are formatted to binary form either if log_format is binary
+         * or if deferred_formatting is set and records are rendered to text in logger thread.
+         */
+        bool isBinaryFormat() const noexcept;
+
         Error loadLogConfig(
             const HATN_BASE_NAMESPACE::ConfigTree& configTree,
             const std::string& configPath,
@@ -21,6 +21,7 @@
 #ifndef HATNCONTEXTLOGGER_H
 #define HATNCONTEXTLOGGER_H
 
+#include <atomic>
 #include <functional>
 
 #include <hatn/common/objecttraits.h>
@@ -69,6 +70,9 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
 
         using levelMapT=common::FlatMap<std::string,LogLevel,std::less<>>;
 
+        LoggerBase() : m_epoch(nextEpoch())
+        {}
+
         Error loadLogConfig(
             const HATN_BASE_NAMESPACE::ConfigTree& configTree,
             const std::string& configPath,
@@ -82,51 +86,71 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
                 lib::string_view module=lib::string_view{}
             )
         {
-            logger.lockRd();
+            // level figured out from context and tags is cached in context
+            // until either context or logger configuration is changed
+            LogLevel level=LogLevel::Default;
+            if (!ctx->cachedLogLevel(logger.epoch(),level))
+            {
+                logger.lockRd();
+                auto epoch=logger.epoch();
 
-            // init current level from context
-            auto level=ctx->logLevel();
+                // init current level from context
+                level=ctx->logLevel();
 
-            // figure out current level from tags
-            for (auto&& tag: logger.tags())
-            {
-                if (ctx->containsTag(tag.first))
+                // figure out current level from tags
+                for (auto&& tag: logger.tags())
                 {
-                    if (tag.second>level)
+                    if (ctx->containsTag(tag.first))
                     {
-                        level=tag.second;
+                        if (tag.second>level)
+                        {
+                            level=tag.second;
+                        }
                     }
                 }
+
+                logger.unlockRd();
+                ctx->cacheLogLevel(epoch,level);
             }
 
-            // figure out current level by module
-            if (!module.empty())
+            // module and stack function are looked up only if they can raise current level
+            bool checkModule=!module.empty() && logger.maxModuleLevel()>level;
+            bool checkScope=!ctx->scopeStack().empty() && logger.maxScopeLevel()>level;
+            if (checkModule || checkScope)
             {
-                auto it=logger.modules().find(module);
-                if (it!=logger.modules().end())
+                logger.lockRd();
+
+                // figure out current level by module
+                if (checkModule)
                 {
-                    if (it->second>level)
+                    auto it=logger.modules().find(module);
+                    if (it!=logger.modules().end())
                     {
-                        level=it->second;
+                        if (it->second>level)
+                        {
+                            level=it->second;
+                        }
                     }
                 }
-            }
 
-            // figure out current level by stack function
-            if (!ctx->scopeStack().empty())
-            {
-                const auto* scope=ctx->currentScope();
-                if (scope!=nullptr)
+                // figure out current level by stack function
+                if (checkScope)
                 {
-                    auto it=logger.scopes().find(common::lib::string_view(scope->first));
-                    if (it!=logger.scopes().end())
+                    const auto* scope=ctx->currentScope();
+                    if (scope!=nullptr)
                     {
-                        if (it->second>level)
+                        auto it=logger.scopes().find(common::lib::string_view(scope->first));
+                        if (it!=logger.scopes().end())
                         {
-                            level=it->second;
+                            if (it->second>level)
+                            {
+                                level=it->second;
+                            }
                         }
                     }
                 }
+
+                logger.unlockRd();
             }
 
             // use default level
@@ -136,7 +160,6 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
             }
 
             // done
-            logger.unlockRd();
             return level;
         }
 
@@ -208,12 +231,14 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_tags.emplace(std::move(tag),level);
+            updateLevels();
         }
 
         void unsetTag(const common::lib::string_view& tag)
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_tags.erase(tag);
+            updateLevels();
         }
 
         const levelMapT& tags() const noexcept
@@ -225,18 +250,21 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_tags.clear();
+            updateLevels();
         }
 
         void setModuleLevel(std::string module, LogLevel level)
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_modules.emplace(std::move(module),level);
+            updateLevels();
         }
 
         void unsetModule(const common::lib::string_view& tag)
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_modules.erase(tag);
+            updateLevels();
         }
 
         const levelMapT& modules() const noexcept
@@ -248,24 +276,28 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_modules.clear();
+            updateLevels();
         }
 
         void setScopeLevel(std::string scope, LogLevel level)
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_scopes.emplace(std::move(scope),level);
+            updateLevels();
         }
 
         void unsetScope(const common::lib::string_view& scope)
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_scopes.erase(scope);
+            updateLevels();
         }
 
         void clearScopes()
         {
             common::lib::unique_lock<common::lib::shared_mutex> l(m_mutex);
             m_scopes.clear();
+            updateLevels();
         }
 
         const levelMapT& scopes() const noexcept
@@ -273,6 +305,29 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
             return m_scopes;
         }
 
+        /**
+         * @brief Get epoch of levels configuration.
+         *
+         * Epoch is changed on each change of tags, modules or scopes levels.
+         * Epochs are unique among all loggers so they can be used as keys of level caches in contexts.
+         */
+        uint64_t epoch() const noexcept
+        {
+            return m_epoch.load(std::memory_order_acquire);
+        }
+
+        //! Get maximum level of all modules.
+        LogLevel maxModuleLevel() const noexcept
+        {
+            return m_maxModuleLevel.load(std::memory_order_relaxed);
+        }
+
+        //! Get maximum level of all scopes.
+        LogLevel maxScopeLevel() const noexcept
+        {
+            return m_maxScopeLevel.load(std::memory_order_relaxed);
+        }
+
         void reset()
         {
             m_defaultLevel=DefaultLogLevel;
@@ -301,6 +356,28 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
         void clearModulesUnlocked() { m_modules.clear(); }
         void clearScopesUnlocked()  { m_scopes.clear(); }
 
+        // Must be called on each change of levels while m_mutex is held for writing.
+        void updateLevels() noexcept
+        {
+            auto maxLevel=[](const levelMapT& levels)
+            {
+                auto level=LogLevel::Unknown;
+                for (auto&& it: levels)
+                {
+                    if (it.second>level)
+                    {
+                        level=it.second;
+                    }
+                }
+                return level;
+            };
+            m_maxModuleLevel.store(maxLevel(m_modules),std::memory_order_relaxed);
+            m_maxScopeLevel.store(maxLevel(m_scopes),std::memory_order_relaxed);
+            m_epoch.store(nextEpoch(),std::memory_order_release);
+        }
+
+        static uint64_t nextEpoch() noexcept;
+
         void lockWr() const
         {
             m_mutex.lock();
@@ -328,6 +405,10 @@ class HATN_LOGCONTEXT_EXPORT LoggerBase
         levelMapT m_modules;
         levelMapT m_scopes;
 
+        std::atomic<uint64_t> m_epoch;
+        std::atomic<LogLevel> m_maxModuleLevel{LogLevel::Unknown};
+        std::atomic<LogLevel> m_maxScopeLevel{LogLevel::Unknown};
+
         mutable common::lib::shared_mutex m_mutex;
 };
 
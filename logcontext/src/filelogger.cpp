@@ -16,6 +16,9 @@
   *
   */
 
+#include <chrono>
+#include <string>
+
 #include <boost/asio/signal_set.hpp>
 
 #include <hatn/validator/validator.hpp>
@@ -52,6 +55,10 @@ constexpr const uint8_t DefaultMaxFileCount=4;
 
 constexpr uint32_t DefaultRotationPeriodHours=24*7;
 
+constexpr const uint32_t DefaultFlushBufferSize=256*1024;
+constexpr const uint32_t DefaultFlushIntervalMs=0;
+constexpr const uint32_t DefaultMaxLatencyMs=100;
+
 constexpr const char* ErrorLogModeMain="main_log";
 constexpr const char* ErrorLogModeError="error_log";
 constexpr const char* ErrorLogModeBoth="main_and_error";
@@ -63,6 +70,15 @@ enum class ErrorLogMode : uint8_t
     Both
 };
 
+constexpr const char* LogFormatText="text";
+constexpr const char* LogFormatBinary="binary";
+
+enum class LogFormat : uint8_t
+{
+    Text,
+    Binary
+};
+
 constexpr const char* LogRotateModeNone="none";
 constexpr const char* LogRotateModeInapp="inapp";
 constexpr const char* LogRotateModeSighup="sighup";
@@ -89,6 +105,11 @@ HDU_UNIT(filelogger_config,
     HDU_FIELD(log_console,TYPE_BOOL,4)
     HDU_FIELD(logger_thread,TYPE_BOOL,5,false,true)
     HDU_FIELD(logrotate,logrotate_config::TYPE,6)
+    HDU_FIELD(flush_buffer_size,TYPE_UINT32,7,false,DefaultFlushBufferSize)
+    HDU_FIELD(flush_interval_ms,TYPE_UINT32,8,false,DefaultFlushIntervalMs)
+    HDU_FIELD(max_latency_ms,TYPE_UINT32,9,false,DefaultMaxLatencyMs)
+    HDU_FIELD(log_format,TYPE_STRING,10,false,LogFormatText)
+    HDU_FIELD(deferred_formatting,TYPE_BOOL,11)
 )
 
 namespace {
@@ -100,6 +121,7 @@ auto makeValidator()
     return validator(
             _[filelogger_config::error_log_mode](in,range({ErrorLogModeMain,ErrorLogModeError,ErrorLogModeBoth})),
             _[filelogger_config::log_file](empty(flag,false)),
+            _[filelogger_config::log_format](in,range({LogFormatText,LogFormatBinary})),
             _[filelogger_config::logrotate][logrotate_config::mode](in,range({LogRotateModeNone,LogRotateModeInapp,LogRotateModeSighup})),
             _[filelogger_config::logrotate][logrotate_config::period_hours](gte,1),
             _[filelogger_config::logrotate][logrotate_config::max_file_count](gte,1)
@@ -131,13 +153,166 @@ class FileLoggerTraits_p : public HATN_BASE_NAMESPACE::ConfigObject<filelogger_c
         ErrorLogMode errorLogMode=ErrorLogMode::Both;
         LogRotateMode logRotateMode=LogRotateMode::None;
 
+        // binary records are either written to files as is or rendered to text in logger thread
+        LogFormat logFormat=LogFormat::Text;
+        bool deferredFormatting=false;
+
+        // records are staged and written to files by groups
+        size_t flushBufferSize=DefaultFlushBufferSize;
+        std::chrono::milliseconds flushInterval{DefaultFlushIntervalMs};
+        std::chrono::milliseconds maxLatency{DefaultMaxLatencyMs};
+        std::string logStaging;
+        std::string errorLogStaging;
+        std::chrono::steady_clock::time_point stagingStarted;
+        bool flushTimerInstalled=false;
+
         bool useLogThread() const noexcept
         {
             return thread && thread->isStarted();
         }
 
+        void stageRecord(const common::FmtAllocatedBufferChar& buf, bool error)
+        {
+            if (!useLogThread())
+            {
+                // no logger thread, write record immediately using local buffers
+                // because the logger can be called from a few threads concurrently
+                std::string logRecord;
+                std::string errorLogRecord;
+                routeRecord(buf,error,logRecord,errorLogRecord);
+                writeStaging(errorLogFile,errorLogRecord);
+                writeStaging(logFile,logRecord);
+                return;
+            }
+
+            bool wasEmpty=logStaging.empty() && errorLogStaging.empty();
+            routeRecord(buf,error,logStaging,errorLogStaging);
+
+            auto now=std::chrono::steady_clock::now();
+            if (wasEmpty)
+            {
+                stagingStarted=now;
+            }
+            if (logStaging.size()>=flushBufferSize
+                ||
+                errorLogStaging.size()>=flushBufferSize
+                ||
+                (now-stagingStarted)>=maxLatency
+                )
+            {
+                flushStaging();
+                return;
+            }
+
+            if (flushInterval.count()==0)
+            {
+                // flush when all pending records are drained from the queue
+                if (thread->isQueueEmpty())
+                {
+                    flushStaging();
+                }
+            }
+            else if (!flushTimerInstalled)
+            {
+                flushTimerInstalled=true;
+                thread->installTimer(
+                    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(flushInterval).count()),
+                    [this]()
+                    {
+                        flushTimerInstalled=false;
+                        flushStaging();
+                        return false;
+                    },
+                    true
+                );
+            }
+        }
+
+        bool isBinaryFormat() const noexcept
+        {
+            return logFormat==LogFormat::Binary || deferredFormatting;
+        }
+
+        void routeRecord(const common::FmtAllocatedBufferChar& buf,
+                         bool error,
+                         std::string& logTarget,
+                         std::string& errorLogTarget
+                        ) const
+        {
+            // render binary record to text if needed
+            const common::FmtAllocatedBufferChar* text=&buf;
+            common::FmtAllocatedBufferChar textBuf;
+            if (isBinaryFormat() && (logFormat==LogFormat::Text || logConsole))
+            {
+                BinaryLogDecoder::toText(textBuf,buf.data(),buf.size());
+                text=&textBuf;
+            }
+
+            auto stage=[&buf,text,this](std::string& staging)
+            {
+                if (logFormat==LogFormat::Binary)
+                {
+                    staging.append(buf.data(),buf.size());
+                }
+                else
+                {
+                    staging.append(text->data(),text->size());
+                    staging.push_back('\n');
+                }
+            };
+
+            if (error && errorLogFile)
+            {
+                stage(errorLogTarget);
+            }
+            if ((!error || errorLogMode!=ErrorLogMode::Error) && logFile)
+            {
+                stage(logTarget);
+            }
+
+            if (logConsole)
+            {
+                std::copy(text->begin(),text->end(),std::ostream_iterator<char>(std::cout));
+                std::cout<<std::endl;
+            }
+        }
+
+        static void writeStaging(lib::optional<common::PlainFile>& file, std::string& staging)
+        {
+            if (staging.empty())
+            {
+                return;
+            }
+
+            bool fallbackLogConsole=false;
+            try
+            {
+                if (file)
+                {
+                    file->write(staging.data(),staging.size());
+                }
+            }
+            catch (...)
+            {
+                fallbackLogConsole=true;
+            }
+            if (fallbackLogConsole)
+            {
+                std::cout<<staging<<std::flush;
+            }
+            staging.clear();
+        }
+
+        void flushStaging()
+        {
+            writeStaging(errorLogFile,errorLogStaging);
+            writeStaging(logFile,logStaging);
+        }
+
         void closeFiles()
         {
+            flushStaging();
+
             Error ec;
             if (logFile)
             {
@@ -198,6 +373,7 @@ class FileLoggerTraits_p : public HATN_BASE_NAMESPACE::ConfigObject<filelogger_c
 
         void reopenFiles(bool closeBeforeOpen=true)
         {
+            flushStaging();
             reopenLogFile(closeBeforeOpen);
             reopenErrorLogFile(closeBeforeOpen);
         }
@@ -434,6 +610,13 @@ void FileLoggerTraits::setAllocatorFactory(const common::pmr::AllocatorFactory*
 
 //---------------------------------------------------------------
 
+bool FileLoggerTraits::isBinaryFormat() const noexcept
+{
+    return d->isBinaryFormat();
+}
+
+//---------------------------------------------------------------
+
 Error FileLoggerTraits::start()
 {
 #ifndef WIN32
@@ -469,13 +652,30 @@ Error FileLoggerTraits::close()
     Error ec;
     if (d->thread)
     {
-        // flush pending logs
-        std::ignore=d->thread->execSync([]{},100);
+        // wait without timeout until all queued records are processed,
+        // handlers of execSync() can run before the rest of the queue if task loop was interrupted
+        if (d->thread->isStarted() && common::Thread::currentThread()!=d->thread.get())
+        {
+            bool drained=false;
+            while (!drained)
+            {
+                std::ignore=d->thread->execSync(
+                    [this,&drained]()
+                    {
+                        drained=d->thread->isQueueEmpty();
+                    },
+                    0
+                );
+            }
+        }
 
         d->thread->stop();
         d->thread.reset();
     }
 
+    // write staged records
+    d->flushStaging();
+
     // close open files
     if (d->errorLogFile)
     {
@@ -507,6 +707,12 @@ Error FileLoggerTraits::loadLogConfig(
     auto ec=d->loadLogConfig(configTree,configPath,records,validator);
     HATN_CHECK_EC(ec)
     d->logConsole=d->config().fieldValue(filelogger_config::log_console);
+    d->logFormat=(d->config().fieldValue(filelogger_config::log_format)==LogFormatBinary)?LogFormat::Binary:LogFormat::Text;
+    d->deferredFormatting=d->config().fieldValue(filelogger_config::deferred_formatting);
+    d->flushBufferSize=d->config().fieldValue(filelogger_config::flush_buffer_size);
+    d->flushInterval=std::chrono::milliseconds(d->config().fieldValue(filelogger_config::flush_interval_ms));
+    d->maxLatency=std::chrono::milliseconds(d->config().fieldValue(filelogger_config::max_latency_ms));
+    d->logStaging.reserve(d->flushBufferSize);
 
     // check config
     const auto& logRotate=d->config().field(filelogger_config::logrotate);
@@ -641,41 +847,17 @@ Error FileLoggerTraits::loadLogConfig(
 
 void FileLoggerTraits::logBuf(const FileLoggerBufWrapper& bufWrapper)
 {
-    auto log=[this](const common::FmtAllocatedBufferChar& buf)
-    {
-        bool fallbackLogConsole=false;
-        try
-        {
-            if (d->logFile)
-            {
-                d->logFile->write(buf.data(),buf.size());
-                lib::string_view ret("\n");
-                d->logFile->write(ret.data(),ret.size());
-            }
-        }
-        catch (...)
-        {
-            fallbackLogConsole=true;
-        }
-
-        if (fallbackLogConsole || d->logConsole)
-        {
-            std::copy(buf.begin(),buf.end(),std::ostream_iterator<char>(std::cout));
-            std::cout<<std::endl;
-        }
-    };
-
     if (d->useLogThread())
     {
-        bufWrapper.m_threadTask->handler=[log](const common::FmtAllocatedBufferChar& buf)
+        bufWrapper.m_threadTask->handler=[this](const common::FmtAllocatedBufferChar& buf)
         {
-            log(buf);
+            d->stageRecord(buf,false);
         };
         d->thread->post(bufWrapper.m_threadTask);
     }
     else
     {
-        log(bufWrapper.buf());
+        d->stageRecord(bufWrapper.buf(),false);
     }
 }
 
@@ -683,45 +865,17 @@ void FileLoggerTraits::logBuf(const FileLoggerBufWrapper& bufWrapper)
 
 void FileLoggerTraits::logBufError(const FileLoggerBufWrapper& bufWrapper)
 {
-    auto log=[this](const common::FmtAllocatedBufferChar& buf)
-    {
-        bool fallbackLogConsole=false;
-        try
-        {
-            lib::string_view ret("\n");
-            if (d->errorLogFile)
-            {
-                d->errorLogFile->write(buf.data(),buf.size());
-                d->errorLogFile->write(ret.data(),ret.size());
-            }
-            if (d->errorLogMode!=ErrorLogMode::Error && d->logFile)
-            {
-                d->logFile->write(buf.data(),buf.size());
-                d->logFile->write(ret.data(),ret.size());
-            }
-        }
-        catch (...)
-        {
-            fallbackLogConsole=true;
-        }
-        if (fallbackLogConsole || d->logConsole)
-        {
-            std::copy(buf.begin(),buf.end(),std::ostream_iterator<char>(std::cout));
-            std::cout<<std::endl;
-        }
-    };
-
     if (d->useLogThread())
     {
-        bufWrapper.m_threadTask->handler=[log](const common::FmtAllocatedBufferChar& buf)
+        bufWrapper.m_threadTask->handler=[this](const common::FmtAllocatedBufferChar& buf)
         {
-            log(buf);
+            d->stageRecord(buf,true);
         };
         d->thread->post(bufWrapper.m_threadTask);
     }
     else
     {
-        log(bufWrapper.buf());
+        d->stageRecord(bufWrapper.buf(),true);
     }
 }
 
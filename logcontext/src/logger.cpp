@@ -16,6 +16,8 @@
   *
   */
 
+#include <hatn/common/runonscopeexit.h>
+
 #include <hatn/dataunit/ipp/syntax.ipp>
 
 #include <hatn/logcontext/loggererror.h>
@@ -31,6 +33,14 @@ AppConfig::~AppConfig()
 
 //---------------------------------------------------------------
 
+uint64_t LoggerBase::nextEpoch() noexcept
+{
+    static std::atomic<uint64_t> epoch{0};
+    return ++epoch;
+}
+
+//---------------------------------------------------------------
+
 Error LoggerBase::loadLogConfig(
         const HATN_BASE_NAMESPACE::ConfigTree& configTree,
         const std::string& configPath,
@@ -39,6 +49,14 @@ Error LoggerBase::loadLogConfig(
 {
     lib::unique_lock<lib::shared_mutex> l{m_mutex};
 
+    // levels must be updated even if config is loaded partially
+    HATN_SCOPE_GUARD(
+        [this]()
+        {
+            updateLevels();
+        }
+    )
+
     // Clear previous per-name overrides so that re-applying is idempotent
     // (replace semantics, not accumulate).
     clearTagsUnlocked();
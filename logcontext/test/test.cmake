@@ -1,5 +1,6 @@
 SET (TEST_SOURCES
     ${LOGCONTEXT_TEST_SRC}/testlogcontext.cpp
+    ${LOGCONTEXT_TEST_SRC}/testfilelogger.cpp
 )
 
 SET (TEST_HEADERS
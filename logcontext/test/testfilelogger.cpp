@@ -0,0 +1,189 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+/*
+
+*/
+/** @file logcontext/test/testfilelogger.cpp
+  */
+
+/****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+
+#include <boost/test/unit_test.hpp>
+
+#include "hatn_test_config.h"
+
+#include <hatn/common/filesystem.h>
+#include <hatn/common/plainfile.h>
+
+#include <hatn/base/configtree.h>
+#include <hatn/base/configtreejson.h>
+
+#include <hatn/logcontext/context.h>
+#include <hatn/logcontext/filelogger.h>
+#include <hatn/logcontext/binlogformatter.h>
+
+#include <hatn/test/multithreadfixture.h>
+
+HATN_USING
+HATN_COMMON_USING
+HATN_BASE_USING
+HATN_LOGCONTEXT_USING
+HATN_TEST_USING
+
+BOOST_AUTO_TEST_SUITE(TestFileLogger)
+
+namespace {
+
+size_t countLines(const std::string& fileName)
+{
+    PlainFile file;
+    std::string content;
+    auto ec=file.open(fileName,File::Mode::scan);
+    BOOST_REQUIRE(!ec);
+    ec=file.readAll(content);
+    BOOST_REQUIRE(!ec);
+    return static_cast<size_t>(std::count(content.begin(),content.end(),'\n'));
+}
+
+size_t countBinaryRecords(const std::string& fileName)
+{
+    PlainFile file;
+    std::string content;
+    auto ec=file.open(fileName,File::Mode::scan);
+    BOOST_REQUIRE(!ec);
+    ec=file.readAll(content);
+    BOOST_REQUIRE(!ec);
+
+    size_t count=0;
+    size_t pos=0;
+    FmtAllocatedBufferChar text;
+    while (pos<content.size())
+    {
+        text.clear();
+        auto size=BinaryLogDecoder::toText(text,content.data()+pos,content.size()-pos);
+        BOOST_REQUIRE(size!=0);
+        pos+=size;
+        ++count;
+    }
+    return count;
+}
+
+std::shared_ptr<FileLogger> makeFileLogger(const std::string& configJson)
+{
+    ConfigTree configTree;
+    ConfigTreeJson jsonIo;
+    auto ec=jsonIo.parse(configTree,configJson);
+    BOOST_REQUIRE(!ec);
+
+    auto logger=std::make_shared<FileLogger>();
+    config_object::LogRecords records;
+    ec=logger->loadLogConfig(configTree,"logger.filelogger",records);
+    BOOST_REQUIRE(!ec);
+    ec=logger->start();
+    BOOST_REQUIRE(!ec);
+    return logger;
+}
+
+void logRecords(FileLogger& logger, size_t count, size_t errorCount, const char* title)
+{
+    auto ctx=makeLogCtx();
+    auto& logCtx=ctx->get<Context>();
+
+    auto ec=commonError(CommonError::UNKNOWN);
+    auto start=std::chrono::steady_clock::now();
+    for (size_t i=0;i<count;i++)
+    {
+        if (i<errorCount)
+        {
+            logger.logError(LogLevel::Error,ec,&logCtx,"error record for file logger benchmark");
+        }
+        else
+        {
+            logger.log(LogLevel::Info,&logCtx,"record for file logger benchmark");
+        }
+    }
+    auto ec1=logger.close();
+    BOOST_CHECK(!ec1);
+    auto elapsed=std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()-start).count();
+    if (elapsed==0)
+    {
+        elapsed=1;
+    }
+    BOOST_TEST_MESSAGE(fmt::format("{}: {} records took {} ms, {} records/s",title,count,elapsed,count*1000/elapsed));
+}
+
+}
+
+BOOST_FIXTURE_TEST_CASE(FileLoggerErrorRouting,MultiThreadFixture)
+{
+    auto logFile=tmpFilePath("filelogger/routing.log");
+    auto errorLogFile=tmpFilePath("filelogger/routing.error.log");
+    lib::fs_error_code fsec;
+    lib::filesystem::remove_all(tmpFilePath("filelogger"),fsec);
+
+    auto config=fmt::format(R"({{"logger":{{"filelogger":{{"log_file":"{}","error_log_mode":"main_and_error","logrotate":{{"mode":"none"}}}}}}}})",logFile);
+    auto logger=makeFileLogger(config);
+    logRecords(*logger,100,10,"Error routing");
+
+    BOOST_CHECK(lib::filesystem::exists(errorLogFile));
+    BOOST_CHECK_EQUAL(countLines(logFile),100);
+    BOOST_CHECK_EQUAL(countLines(errorLogFile),10);
+}
+
+BOOST_FIXTURE_TEST_CASE(FileLoggerThroughput,MultiThreadFixture)
+{
+#ifdef BUILD_VALGRIND
+    size_t count=1000;
+#else
+    #if defined(BUILD_DEBUG)
+        size_t count=100000;
+    #else
+        size_t count=1000000;
+    #endif
+#endif
+
+    lib::fs_error_code fsec;
+    lib::filesystem::remove_all(tmpFilePath("filelogger"),fsec);
+
+    auto run=[&](const char* title, const char* name, const std::string& options)
+    {
+        auto logFile=tmpFilePath(fmt::format("filelogger/{}.log",name));
+        auto config=fmt::format(R"({{"logger":{{"filelogger":{{"log_file":"{}","logrotate":{{"mode":"none"}}{}}}}}}})",logFile,options);
+        auto logger=makeFileLogger(config);
+        logRecords(*logger,count,0,title);
+        BOOST_CHECK_EQUAL(countLines(logFile),count);
+    };
+
+    run("Logger thread, flush when queue is drained","drained","");
+    run("Logger thread, flush by interval","interval",R"(,"flush_interval_ms":20)");
+    run("Logger thread, flush each record","each",R"(,"flush_buffer_size":0)");
+    run("No logger thread","nothread",R"(,"logger_thread":false)");
+    run("Logger thread, deferred formatting","deferred",R"(,"deferred_formatting":true)");
+}
+
+BOOST_FIXTURE_TEST_CASE(FileLoggerBinaryFormat,MultiThreadFixture)
+{
+    auto logFile=tmpFilePath("filelogger/binary.log");
+    auto errorLogFile=tmpFilePath("filelogger/binary.error.log");
+    lib::fs_error_code fsec;
+    lib::filesystem::remove_all(tmpFilePath("filelogger"),fsec);
+
+    auto config=fmt::format(R"({{"logger":{{"filelogger":{{"log_file":"{}","error_log_mode":"main_and_error","log_format":"binary","logrotate":{{"mode":"none"}}}}}}}})",logFile);
+    auto logger=makeFileLogger(config);
+    logRecords(*logger,100,10,"Binary format");
+
+    BOOST_CHECK_EQUAL(countBinaryRecords(logFile),100);
+    BOOST_CHECK_EQUAL(countBinaryRecords(errorLogFile),10);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
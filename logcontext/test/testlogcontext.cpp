@@ -28,6 +28,7 @@
 #include <hatn/logcontext/context.h>
 #include <hatn/logcontext/contextlogger.h>
 #include <hatn/logcontext/streamlogger.h>
+#include <hatn/logcontext/binlogformatter.h>
 
 HATN_COMMON_USING
 HATN_LOGCONTEXT_USING
@@ -581,4 +582,210 @@ BOOST_AUTO_TEST_CASE(ScopeMacros)
     BOOST_CHECK(true);
 }
 
+namespace {
+
+// skip time point and elapsed microseconds that differ between formatting calls
+std::string skipTime(std::string str)
+{
+    str.erase(0,str.find(' '));
+    auto pos=str.find(" us=");
+    if (pos!=std::string::npos)
+    {
+        str.erase(pos,str.find(' ',pos+1)-pos);
+    }
+    return str;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(BinaryLogFormat)
+{
+    auto taskCtx=makeTaskContext<Context>();
+    taskCtx->setName("test_task");
+    auto& logCtx=taskCtx->get<Context>();
+
+    taskCtx->beforeThreadProcessing();
+
+    auto fillCtx=[&logCtx]()
+    {
+        logCtx.enterScope("scope1");
+        logCtx.enterScope("scope2");
+        logCtx.describeScopeError("scope2 error");
+        logCtx.pushFixedVar("fixedvar1",DateTime::currentUtc());
+        logCtx.setGlobalVar("mapvar1","mapvar1 value");
+        logCtx.pushStackVar("stackvar1",int32_t(-10));
+    };
+
+    auto check=[&](const char* title, auto&& formatText, auto&& formatBinary)
+    {
+        fillCtx();
+        FmtAllocatedBufferChar textBuf;
+        formatText(textBuf);
+        logCtx.reset();
+
+        fillCtx();
+        FmtAllocatedBufferChar binaryBuf;
+        formatBinary(binaryBuf);
+        logCtx.reset();
+        BOOST_CHECK_EQUAL(BinaryLogDecoder::recordSize(binaryBuf.data(),binaryBuf.size()),binaryBuf.size());
+
+        FmtAllocatedBufferChar decodedBuf;
+        auto size=BinaryLogDecoder::toText(decodedBuf,binaryBuf.data(),binaryBuf.size());
+        BOOST_CHECK_EQUAL(size,binaryBuf.size());
+
+        auto text=fmtBufToString(textBuf);
+        auto decoded=fmtBufToString(decodedBuf);
+        BOOST_TEST_MESSAGE(fmt::format("{}: binary size {}, text size {}\n{}",title,binaryBuf.size(),textBuf.size(),decoded));
+        BOOST_CHECK_EQUAL(skipTime(text),skipTime(decoded));
+
+        // truncated record must not be decoded
+        decodedBuf.clear();
+        BOOST_CHECK_EQUAL(BinaryLogDecoder::toText(decodedBuf,binaryBuf.data(),binaryBuf.size()-1),0);
+    };
+
+    Error ec{CommonError::NOT_IMPLEMENTED};
+    auto sysEc=HATN_NAMESPACE::makeSystemError(std::errc::io_error);
+    ImmediateRecords records{
+        {"r1",lib::string_view("hello")},
+        {"r2",uint64_t(0xffffffff9)},
+        {"r3",1.5},
+        {"r4",Date::currentUtc()}
+    };
+
+    check("Info",
+        [&](auto& buf){TextLogFormatter::format(buf,LogLevel::Info,&logCtx,"info",lib::string_view(sample_module));},
+        [&](auto& buf){BinaryLogFormatter::format(buf,LogLevel::Info,&logCtx,"info",lib::string_view(sample_module));}
+    );
+    check("Error with records",
+        [&](auto& buf){TextLogFormatter::format(buf,LogLevel::Error,&logCtx,"error",records,lib::string_view(),ec);},
+        [&](auto& buf){BinaryLogFormatter::format(buf,LogLevel::Error,&logCtx,"error",records,lib::string_view(),ec);}
+    );
+    check("System error",
+        [&](auto& buf){TextLogFormatter::format(buf,LogLevel::Error,&logCtx,"error",lib::string_view(),sysEc);},
+        [&](auto& buf){BinaryLogFormatter::format(buf,LogLevel::Error,&logCtx,"error",lib::string_view(),sysEc);}
+    );
+    check("Close",
+        [&](auto& buf){TextLogFormatter::format(buf,LogLevel::Info,&logCtx,"close",lib::string_view(),Error{},hana::true_{});},
+        [&](auto& buf){BinaryLogFormatter::format(buf,LogLevel::Info,&logCtx,"close",lib::string_view(),Error{},hana::true_{});}
+    );
+    check("Close API with error",
+        [&](auto& buf){TextLogFormatter::format(buf,LogLevel::Info,&logCtx,"close",records,lib::string_view(),ec,hana::true_{},hana::true_{});},
+        [&](auto& buf){BinaryLogFormatter::format(buf,LogLevel::Info,&logCtx,"close",records,lib::string_view(),ec,hana::true_{},hana::true_{});}
+    );
+
+
+    // strings longer than 64 KiB are kept without truncation
+    std::string longMsg(100000,'m');
+    std::string longValue(70000,'v');
+    ImmediateRecords longRecords{
+        {"r1",lib::string_view(longValue)}
+    };
+    check("Long strings",
+        [&](auto& buf){TextLogFormatter::format(buf,LogLevel::Info,&logCtx,longMsg.c_str(),longRecords,lib::string_view(sample_module));},
+        [&](auto& buf){BinaryLogFormatter::format(buf,LogLevel::Info,&logCtx,longMsg.c_str(),longRecords,lib::string_view(sample_module));}
+    );
+
+    // record greater than max size is replaced with notice
+    std::string tooBigMsg(binlog::MaxRecordSize,'b');
+    FmtAllocatedBufferChar tooBigBuf;
+    BinaryLogFormatter::format(tooBigBuf,LogLevel::Info,&logCtx,tooBigMsg.c_str(),lib::string_view(sample_module));
+    BOOST_CHECK_LT(tooBigBuf.size(),binlog::MaxRecordSize);
+    FmtAllocatedBufferChar tooBigDecoded;
+    BOOST_CHECK_EQUAL(BinaryLogDecoder::toText(tooBigDecoded,tooBigBuf.data(),tooBigBuf.size()),tooBigBuf.size());
+    BOOST_CHECK(fmtBufToString(tooBigDecoded).find("is too big")!=std::string::npos);
+
+    // header with corrupted size greater than max size is invalid
+    uint32_t corruptedSize=binlog::MaxRecordSize+1;
+    std::memcpy(tooBigBuf.data(),&corruptedSize,sizeof(corruptedSize));
+    BOOST_CHECK_EQUAL(BinaryLogDecoder::recordSize(tooBigBuf.data(),tooBigBuf.size()),0);
+
+    taskCtx->afterThreadProcessing();
+}
+
+BOOST_AUTO_TEST_CASE(LogLevelCache)
+{
+    LoggerBase logger;
+    auto taskCtx=makeTaskContext<Context>();
+    auto& logCtx=taskCtx->get<Context>();
+
+    auto level=[&](lib::string_view module=lib::string_view{})
+    {
+        return LoggerBase::contextLogLevel(logger,&logCtx,module);
+    };
+
+    // default level
+    BOOST_CHECK(level()==LogLevel::Info);
+    BOOST_CHECK(!LoggerBase::passLog(logger,LogLevel::Debug,&logCtx));
+    BOOST_CHECK(LoggerBase::passLog(logger,LogLevel::Info,&logCtx));
+
+    // level of context
+    logCtx.setLogLevel(LogLevel::Debug);
+    BOOST_CHECK(level()==LogLevel::Debug);
+    logCtx.setLogLevel(LogLevel::Default);
+    BOOST_CHECK(level()==LogLevel::Info);
+
+    // tags
+    logger.setTagLevel("tag1",LogLevel::Trace);
+    BOOST_CHECK(level()==LogLevel::Info);
+    logCtx.setTag(Context::tagT{lib::string_view("tag1")});
+    BOOST_CHECK(level()==LogLevel::Trace);
+    logCtx.unsetTag("tag1");
+    BOOST_CHECK(level()==LogLevel::Info);
+    logCtx.setTag(Context::tagT{lib::string_view("tag1")});
+    BOOST_CHECK(level()==LogLevel::Trace);
+    logger.unsetTag("tag1");
+    BOOST_CHECK(level()==LogLevel::Info);
+
+    // modules
+    logger.setModuleLevel(sample_module,LogLevel::Debug);
+    BOOST_CHECK(level(sample_module)==LogLevel::Debug);
+    BOOST_CHECK(level("other_module")==LogLevel::Info);
+    BOOST_CHECK(level()==LogLevel::Info);
+    logCtx.setLogLevel(LogLevel::Trace);
+    BOOST_CHECK(level(sample_module)==LogLevel::Trace);
+    logCtx.setLogLevel(LogLevel::Default);
+    logger.clearModules();
+    BOOST_CHECK(level(sample_module)==LogLevel::Info);
+
+    // scopes
+    logger.setScopeLevel("scope1",LogLevel::Details);
+    BOOST_CHECK(level()==LogLevel::Info);
+    logCtx.enterScope("scope1");
+    BOOST_CHECK(level()==LogLevel::Details);
+    logCtx.enterScope("scope2");
+    BOOST_CHECK(level()==LogLevel::Info);
+    logCtx.leaveScope();
+    BOOST_CHECK(level()==LogLevel::Details);
+    logCtx.leaveScope();
+    BOOST_CHECK(level()==LogLevel::Info);
+
+    // epochs are unique among loggers so context cache of one logger is not used by another
+    LoggerBase logger1;
+    BOOST_CHECK(logger1.epoch()!=logger.epoch());
+    logger1.setDefaultLogLevel(LogLevel::Warn);
+    logger1.setTagLevel("tag1",LogLevel::Debug);
+    BOOST_CHECK(LoggerBase::contextLogLevel(logger1,&logCtx)==LogLevel::Debug);
+    BOOST_CHECK(level()==LogLevel::Info);
+    logCtx.reset();
+    BOOST_CHECK(LoggerBase::contextLogLevel(logger1,&logCtx)==LogLevel::Warn);
+
+    // measure checking of disabled debug logs
+    size_t count=1000000;
+    size_t passed=0;
+    logger.setModuleLevel("other_module",LogLevel::Warn);
+    logCtx.enterScope("scope2");
+    auto start=std::chrono::steady_clock::now();
+    for (size_t i=0;i<count;i++)
+    {
+        if (LoggerBase::passDebugLog(logger,&logCtx,0,sample_module))
+        {
+            ++passed;
+        }
+    }
+    auto elapsed=std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-start).count();
+    logCtx.leaveScope();
+    BOOST_CHECK_EQUAL(passed,0);
+    BOOST_TEST_MESSAGE(fmt::format("Checking {} disabled debug logs took {} us",count,elapsed));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
 
 #include <hatn/network/network.h>
 #include <hatn/network/resolver.h>
+#include <hatn/network/resolvercache.h>
 
 #define HATN_CARES_ERRORS(Do) \
     Do(CaresError,ARES_SUCCESS,_TR("OK")) \
@@ -137,6 +138,12 @@ class HATN_NETWORK_EXPORT CaResolverTraits
         //! Check if local hosts file used (default true)
         bool isUseLocalHostsFile() const noexcept;
 
+        //! Set cache of results, the cache can be shared with other resolvers
+        void setCache(std::shared_ptr<ResolverCache> cache) noexcept;
+
+        //! Get cache of results
+        std::shared_ptr<ResolverCache> cache() const noexcept;
+
         void resolveName(
             const common::TaskContextShared& context,
             Callback callback,
@@ -231,6 +238,18 @@ class CaResolver : public Resolver<CaResolverTraits>
         {
             return traits().isUseLocalHostsFile();
         }
+
+        //! Set cache of results, the cache can be shared with other resolvers
+        inline void setCache(std::shared_ptr<ResolverCache> cache) noexcept
+        {
+            traits().setCache(std::move(cache));
+        }
+
+        //! Get cache of results
+        inline std::shared_ptr<ResolverCache> cache() const noexcept
+        {
+            return traits().cache();
+        }
 };
 
 //! Polymotphic version of DNS resolver that uses c-ares resolving library ans ASIO events
@@ -251,6 +270,18 @@ class CaResolverV : public ResolverTmlV<CaResolver>
         {
             return this->impl().isUseLocalHostsFile();
         }
+
+        //! Set cache of results, the cache can be shared with other resolvers
+        inline void setCache(std::shared_ptr<ResolverCache> cache) noexcept
+        {
+            this->impl().setCache(std::move(cache));
+        }
+
+        //! Get cache of results
+        inline std::shared_ptr<ResolverCache> cache() const noexcept
+        {
+            return this->impl().cache();
+        }
 };
 
 } // namespace asio
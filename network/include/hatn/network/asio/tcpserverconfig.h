@@ -28,6 +28,69 @@
 HATN_NETWORK_NAMESPACE_BEGIN
 namespace asio {
 
+#ifdef SO_REUSEPORT
+
+//! Socket option SO_REUSEPORT for boost asio acceptors and sockets
+class ReusePortOption
+{
+    public:
+
+        //! Ctor
+        explicit ReusePortOption(bool enable=true) noexcept : m_value(enable?1:0)
+        {
+        }
+
+        template <typename ProtocolT>
+        int level(const ProtocolT&) const noexcept
+        {
+            return SOL_SOCKET;
+        }
+
+        template <typename ProtocolT>
+        int name(const ProtocolT&) const noexcept
+        {
+            return SO_REUSEPORT;
+        }
+
+        template <typename ProtocolT>
+        int* data(const ProtocolT&) noexcept
+        {
+            return &m_value;
+        }
+
+        template <typename ProtocolT>
+        const int* data(const ProtocolT&) const noexcept
+        {
+            return &m_value;
+        }
+
+        template <typename ProtocolT>
+        size_t size(const ProtocolT&) const noexcept
+        {
+            return sizeof(m_value);
+        }
+
+        template <typename ProtocolT>
+        void resize(const ProtocolT&, size_t size)
+        {
+            if (size!=sizeof(m_value))
+            {
+                throw std::length_error("reuse port socket option resize");
+            }
+        }
+
+        bool value() const noexcept
+        {
+            return m_value!=0;
+        }
+
+    private:
+
+        int m_value;
+};
+
+#endif
+
 //! Interface for ASIO TCP server configuration
 class HATN_NETWORK_EXPORT TcpServerConfig
 {
@@ -60,8 +123,15 @@ class HATN_NETWORK_EXPORT TcpServerConfig
         //! Set acceptor options without throwing exceptions
         virtual void fillAcceptorOptions(boost::asio::ip::tcp::acceptor& acceptor, boost::system::error_code& ec) const
         {
-            std::ignore=acceptor;
-            std::ignore=ec;
+            if (m_reusePort)
+            {
+#ifdef SO_REUSEPORT
+                acceptor.set_option(ReusePortOption{true},ec);
+#else
+                std::ignore=acceptor;
+                ec=boost::asio::error::operation_not_supported;
+#endif
+            }
         }
 
         inline int listenBacklog() const noexcept
@@ -69,9 +139,26 @@ class HATN_NETWORK_EXPORT TcpServerConfig
             return m_listenBacklog;
         }
 
+        /**
+         * @brief Enable SO_REUSEPORT on acceptor.
+         *
+         * With this option a few acceptors can listen on the same endpoint, e.g. one acceptor per thread.
+         * The option is supported only on platforms that define SO_REUSEPORT, otherwise listening fails.
+         */
+        inline void setReusePort(bool enable) noexcept
+        {
+            m_reusePort=enable;
+        }
+
+        inline bool isReusePort() const noexcept
+        {
+            return m_reusePort;
+        }
+
     private:
 
         int m_listenBacklog;
+        bool m_reusePort=false;
 };
 
 } // namespace asio
@@ -0,0 +1,179 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+
+/** @file network/resolvercache.h
+  *
+  *   Cache of DNS resolver results
+  *
+  */
+
+/****************************************************************************/
+
+#ifndef HATNRESOLVERCACHE_H
+#define HATNRESOLVERCACHE_H
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <hatn/common/error.h>
+#include <hatn/common/locker.h>
+
+#include <hatn/network/network.h>
+#include <hatn/network/ipendpoint.h>
+#include <hatn/network/asio/ipendpoint.h>
+
+HATN_NETWORK_NAMESPACE_BEGIN
+
+/**
+ * @brief Thread-safe cache of DNS resolver results.
+ *
+ * Results are kept for TTL of DNS records limited by minTtl and maxTtl.
+ * Failed queries are cached for negativeTtl if the error is cacheable, e.g. domain not found.
+ * When refreshAhead part of TTL is passed the cached result is still returned but the caller is told to refresh it,
+ * only one caller is told to refresh the same entry.
+ *
+ * The same cache can be shared by a few resolvers.
+ */
+class HATN_NETWORK_EXPORT ResolverCache final
+{
+    public:
+
+        using Clock=std::chrono::steady_clock;
+        using TimePoint=Clock::time_point;
+
+        enum class QueryType : uint8_t
+        {
+            Name,
+            Service,
+            Mx
+        };
+
+        enum class Status : uint8_t
+        {
+            Miss,
+            Hit,
+            HitRefresh
+        };
+
+        //! TTL of result when DNS records do not provide it.
+        constexpr static const uint32_t UnknownTtl=0xFFFFFFFF;
+
+        struct Config
+        {
+            std::chrono::seconds minTtl=std::chrono::seconds(1);
+            std::chrono::seconds maxTtl=std::chrono::seconds(3600);
+            std::chrono::seconds defaultTtl=std::chrono::seconds(60);
+            std::chrono::seconds negativeTtl=std::chrono::seconds(30);
+
+            //! Percentage of TTL after which entry must be refreshed, 0 disables refreshing ahead of expiry.
+            uint8_t refreshAhead=80;
+
+            size_t maxEntries=4096;
+        };
+
+        explicit ResolverCache(Config config) : m_config(std::move(config))
+        {}
+
+        ResolverCache() : ResolverCache(Config{})
+        {}
+
+        /**
+         * @brief Find cached result.
+         * @param type Query type.
+         * @param name Queried name.
+         * @param port Port of resolved endpoints.
+         * @param ipVersion IP version of query.
+         * @param ec Cached error of failed query.
+         * @param endpoints Cached endpoints.
+         * @param now Current time.
+         * @return Miss if result is not cached or expired, HitRefresh if cached result must be refreshed by the caller.
+         */
+        Status find(
+            QueryType type,
+            const lib::string_view& name,
+            uint16_t port,
+            IpVersion ipVersion,
+            Error& ec,
+            std::vector<asio::IpEndpoint>& endpoints,
+            TimePoint now=Clock::now()
+        );
+
+        /**
+         * @brief Put result of query to cache.
+         * @param type Query type.
+         * @param name Queried name.
+         * @param port Port of resolved endpoints.
+         * @param ipVersion IP version of query.
+         * @param ec Error of query, must be set only if the error is cacheable.
+         * @param endpoints Resolved endpoints.
+         * @param ttl Minimal TTL of DNS records in seconds or UnknownTtl.
+         * @param now Current time.
+         */
+        void store(
+            QueryType type,
+            const lib::string_view& name,
+            uint16_t port,
+            IpVersion ipVersion,
+            const Error& ec,
+            std::vector<asio::IpEndpoint> endpoints,
+            uint32_t ttl=UnknownTtl,
+            TimePoint now=Clock::now()
+        );
+
+        //! Reset refreshing state of entry when refreshing query failed with not cacheable error.
+        void refreshFailed(
+            QueryType type,
+            const lib::string_view& name,
+            uint16_t port,
+            IpVersion ipVersion
+        );
+
+        //! Remove all entries.
+        void clear();
+
+        //! Get number of entries.
+        size_t size() const;
+
+        const Config& config() const noexcept
+        {
+            return m_config;
+        }
+
+    private:
+
+        struct Entry
+        {
+            Error ec;
+            std::vector<asio::IpEndpoint> endpoints;
+            TimePoint refreshAt;
+            TimePoint expireAt;
+            bool refreshing=false;
+        };
+
+        static std::string makeKey(
+            QueryType type,
+            const lib::string_view& name,
+            uint16_t port,
+            IpVersion ipVersion
+        );
+
+        void evict(TimePoint now);
+
+        Config m_config;
+
+        mutable common::MutexLock m_mutex;
+        std::map<std::string,Entry,std::less<>> m_entries;
+};
+
+HATN_NETWORK_NAMESPACE_END
+
+#endif // HATNRESOLVERCACHE_H
@@ -71,6 +71,7 @@
 #include <hatn/network/networkerrorcodes.h>
 #include <hatn/network/asio/careslib.h>
 #include <hatn/network/asio/caresolver.h>
+#include <hatn/network/resolvercache.h>
 
 HATN_NETWORK_NAMESPACE_BEGIN
 
@@ -266,7 +267,11 @@ struct Query : public common::EnableManaged<Query>
               ipVersion(ipVersion),
               step(QueryStep::LocalFile),
               depth(0),
-              intermediateIndex(0)
+              intermediateIndex(0),
+              ttl(ResolverCache::UnknownTtl),
+              cacheType(ResolverCache::QueryType::Name),
+              cachePort(0),
+              refreshOnly(false)
     {
     }
 
@@ -286,6 +291,24 @@ struct Query : public common::EnableManaged<Query>
     common::EmbeddedSharedPtr<Query> cyclicRefToSelf;
     Error lastError;
 
+    // minimal TTL of resolved records
+    uint32_t ttl;
+
+    // original query is kept for cache because name and port can be replaced with intermediate ones
+    std::shared_ptr<ResolverCache> cache;
+    ResolverCache::QueryType cacheType;
+    StringBuf cacheName;
+    uint16_t cachePort;
+    bool refreshOnly;
+
+    void updateTtl(int recordTtl) noexcept
+    {
+        if (recordTtl>=0 && static_cast<uint32_t>(recordTtl)<ttl)
+        {
+            ttl=static_cast<uint32_t>(recordTtl);
+        }
+    }
+
     template <typename AddressT>
     void addEndpoint(AddressT address, uint16_t port)
     {
@@ -300,6 +323,12 @@ struct Query : public common::EnableManaged<Query>
 
 }
 
+static common::pmr::polymorphic_allocator<Query> queryAllocator()
+{
+    return (CaresLib::allocatorFactory()==nullptr)?
+                common::pmr::polymorphic_allocator<Query>():CaresLib::allocatorFactory()->objectAllocator<Query>();
+}
+
 static void queryCb(void *arg, int status, int timeouts, HATN_CARES_ABUF_CONST unsigned char *abuf, int alen);
 
 static bool setSocketBlockingMode(ares_socket_t fd, bool blocking)
@@ -337,6 +366,7 @@ class CaResolverTraits_p : public std::enable_shared_from_this<CaResolverTraits_
         CaResolverTraits* obj;
         bool cancel;
         bool useLocalHostsFile;
+        std::shared_ptr<ResolverCache> cache;
 
         struct Socket
         {
@@ -469,6 +499,66 @@ class CaResolverTraits_p : public std::enable_shared_from_this<CaResolverTraits_
             return res;
         }
 
+        static bool isCacheableError(const Error& ec) noexcept
+        {
+            return ec.is(CaresError::ARES_ENOTFOUND) || ec.is(CaresError::ARES_ENODATA);
+        }
+
+        void startQuery(common::SharedPtr<Query> query, ResolverCache::QueryType type)
+        {
+            query->cyclicRefToSelf=query;
+
+            if (cache)
+            {
+                query->cache=cache;
+                query->cacheType=type;
+                query->cacheName.load(query->name.data(),query->name.size());
+                query->cachePort=query->port;
+
+                std::vector<asio::IpEndpoint> endpoints;
+                Error ec;
+                auto status=cache->find(type,
+                                        lib::string_view{query->name.data(),query->name.size()},
+                                        query->port,
+                                        query->ipVersion,
+                                        ec,
+                                        endpoints
+                                        );
+                if (status!=ResolverCache::Status::Miss)
+                {
+                    if (status==ResolverCache::Status::HitRefresh)
+                    {
+                        // refresh cached result in background
+                        auto refreshQuery=common::allocateShared<Query>(
+                            queryAllocator(),
+                            query->impl,
+                            [](const Error&,std::vector<asio::IpEndpoint>){},
+                            query->context.lock(),
+                            query->ipVersion,
+                            lib::string_view{query->name.data(),query->name.size()},
+                            query->port
+                        );
+                        refreshQuery->step=query->step;
+                        refreshQuery->cache=cache;
+                        refreshQuery->cacheType=type;
+                        refreshQuery->cacheName.load(query->name.data(),query->name.size());
+                        refreshQuery->cachePort=query->port;
+                        refreshQuery->refreshOnly=true;
+                        refreshQuery->cyclicRefToSelf=refreshQuery;
+                        processQuery(refreshQuery);
+                    }
+
+                    // complete query with cached result
+                    query->cache.reset();
+                    query->endpoints=std::move(endpoints);
+                    query->lastError=std::move(ec);
+                    query->step=QueryStep::Done;
+                }
+            }
+
+            processQuery(std::move(query));
+        }
+
         void processQuery(common::SharedPtr<Query> query)
         {
             auto ctx=query->context.lock();
@@ -650,6 +740,30 @@ class CaResolverTraits_p : public std::enable_shared_from_this<CaResolverTraits_
                     // call query callback
                     Error err=query->endpoints.empty()?query->lastError:Error{};
 
+                    // keep result in cache
+                    if (query->cache)
+                    {
+                        if (!err || isCacheableError(err))
+                        {
+                            query->cache->store(query->cacheType,
+                                                lib::string_view{query->cacheName.data(),query->cacheName.size()},
+                                                query->cachePort,
+                                                query->ipVersion,
+                                                err,
+                                                query->endpoints,
+                                                query->ttl
+                                                );
+                        }
+                        else if (query->refreshOnly)
+                        {
+                            query->cache->refreshFailed(query->cacheType,
+                                                        lib::string_view{query->cacheName.data(),query->cacheName.size()},
+                                                        query->cachePort,
+                                                        query->ipVersion
+                                                        );
+                        }
+                    }
+
                     // DCS_DEBUG(dnsresolver,HATN_FORMAT("Done query {}:{} for {}, status={}, endpoints count={}"
                     //                                 ,query->name.c_str(),query->port,IpVersionStr(query->ipVersion),
                     //                                 err.value(),query->endpoints.size())
@@ -798,6 +912,11 @@ static void queryCb(void *arg, int status, int, HATN_CARES_ABUF_CONST unsigned c
             std::array<ares_addrttl,MAX_ADDRTTL_RECORDS> addrttl;
             if (!err && checkResult(ares_parse_a_reply(abuf,alen,&host,addrttl.data(),&naddrttl),err))
             {
+                for (int i=0;i<naddrttl;i++)
+                {
+                    query->updateTtl(addrttl[i].ttl);
+                }
+
                 // parse hostent
                 if (obj->parseHostEnt(query,host)!=ARES_SUCCESS)
                 {
@@ -840,6 +959,11 @@ static void queryCb(void *arg, int status, int, HATN_CARES_ABUF_CONST unsigned c
             std::array<ares_addr6ttl,MAX_ADDRTTL_RECORDS> addrttl;
             if (!err && checkResult(ares_parse_aaaa_reply(abuf,alen,&host,addrttl.data(),&naddrttl),err))
             {
+                for (int i=0;i<naddrttl;i++)
+                {
+                    query->updateTtl(addrttl[i].ttl);
+                }
+
                 // parse hostent
                 if (obj->parseHostEnt(query,host)!=ARES_SUCCESS)
                 {
@@ -1120,8 +1244,7 @@ void CaResolverTraits::resolveName(
 {
     // DCS_DEBUG(dnsresolver,HATN_FORMAT("Resolving {}:{} for {} ...",hostName,port,IpVersionStr(ipVersion)));
 
-    auto allocator=(CaresLib::allocatorFactory()==nullptr)?
-                common::pmr::polymorphic_allocator<Query>():CaresLib::allocatorFactory()->objectAllocator<Query>();
+    auto allocator=queryAllocator();
     auto query=common::allocateShared<Query>(
             allocator,
             std::weak_ptr<CaResolverTraits_p>(d),
@@ -1132,8 +1255,7 @@ void CaResolverTraits::resolveName(
             port
         );
     static_assert(std::is_base_of<common::ManagedObject,Query>::value,"");
-    query->cyclicRefToSelf=query;
-    d->processQuery(query);
+    d->startQuery(std::move(query),ResolverCache::QueryType::Name);
 }
 
 //---------------------------------------------------------------
@@ -1146,8 +1268,7 @@ void CaResolverTraits::resolveService(
 {
     // DCS_DEBUG(dnsresolver,HATN_FORMAT("Resolving SRV {} for {} ...",name,IpVersionStr(ipVersion)));
 
-    auto allocator=(CaresLib::allocatorFactory()==nullptr)?
-                common::pmr::polymorphic_allocator<Query>():CaresLib::allocatorFactory()->objectAllocator<Query>();
+    auto allocator=queryAllocator();
     auto query=common::allocateShared<Query>(
         allocator,
         std::weak_ptr<CaResolverTraits_p>(d),
@@ -1156,8 +1277,7 @@ void CaResolverTraits::resolveService(
         ipVersion,
         name);
     query->step=QueryStep::RecordSRV;
-    query->cyclicRefToSelf=query;
-    d->processQuery(query);
+    d->startQuery(std::move(query),ResolverCache::QueryType::Service);
 }
 
 //---------------------------------------------------------------
@@ -1170,8 +1290,7 @@ void CaResolverTraits::resolveMx(
 {
     // DCS_DEBUG(dnsresolver,HATN_FORMAT("Resolving MX {} for {} ...",name,IpVersionStr(ipVersion)));
 
-    auto allocator=(CaresLib::allocatorFactory()==nullptr)?
-                common::pmr::polymorphic_allocator<Query>():CaresLib::allocatorFactory()->objectAllocator<Query>();
+    auto allocator=queryAllocator();
     auto query=common::allocateShared<Query>(
         allocator,
         std::weak_ptr<CaResolverTraits_p>(d),
@@ -1180,8 +1299,7 @@ void CaResolverTraits::resolveMx(
         ipVersion,
         name);
     query->step=QueryStep::RecordMX;
-    query->cyclicRefToSelf=query;
-    d->processQuery(query);
+    d->startQuery(std::move(query),ResolverCache::QueryType::Mx);
 }
 
 //---------------------------------------------------------------
@@ -1211,6 +1329,18 @@ bool CaResolverTraits::isUseLocalHostsFile() const noexcept
     return d->useLocalHostsFile;
 }
 
+//---------------------------------------------------------------
+void CaResolverTraits::setCache(std::shared_ptr<ResolverCache> cache) noexcept
+{
+    d->cache=std::move(cache);
+}
+
+//---------------------------------------------------------------
+std::shared_ptr<ResolverCache> CaResolverTraits::cache() const noexcept
+{
+    return d->cache;
+}
+
 //---------------------------------------------------------------
 } // namespace asio
 
@@ -0,0 +1,198 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/****************************************************************************/
+
+/** @file network/resolvercache.cpp
+  *
+  *   Cache of DNS resolver results
+  *
+  */
+
+/****************************************************************************/
+
+#include <algorithm>
+
+#include <hatn/network/resolvercache.h>
+
+HATN_NETWORK_NAMESPACE_BEGIN
+HATN_COMMON_USING
+
+/********************** ResolverCache **************************/
+
+//---------------------------------------------------------------
+std::string ResolverCache::makeKey(
+        QueryType type,
+        const lib::string_view& name,
+        uint16_t port,
+        IpVersion ipVersion
+    )
+{
+    std::string key;
+    key.reserve(name.size()+8);
+    key.push_back(static_cast<char>('0'+static_cast<int>(type)));
+    key.push_back(static_cast<char>('0'+static_cast<int>(ipVersion)));
+    key.append(std::to_string(port));
+    key.push_back(':');
+
+    // domain names are case insensitive
+    for (auto ch: name)
+    {
+        key.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(ch))));
+    }
+    return key;
+}
+
+//---------------------------------------------------------------
+ResolverCache::Status ResolverCache::find(
+        QueryType type,
+        const lib::string_view& name,
+        uint16_t port,
+        IpVersion ipVersion,
+        Error& ec,
+        std::vector<asio::IpEndpoint>& endpoints,
+        TimePoint now
+    )
+{
+    auto key=makeKey(type,name,port,ipVersion);
+
+    MutexScopedLock l{m_mutex};
+    auto it=m_entries.find(key);
+    if (it==m_entries.end())
+    {
+        return Status::Miss;
+    }
+
+    auto& entry=it->second;
+    if (now>=entry.expireAt)
+    {
+        m_entries.erase(it);
+        return Status::Miss;
+    }
+
+    ec=entry.ec;
+    endpoints=entry.endpoints;
+
+    if (!entry.refreshing && now>=entry.refreshAt)
+    {
+        entry.refreshing=true;
+        return Status::HitRefresh;
+    }
+    return Status::Hit;
+}
+
+//---------------------------------------------------------------
+void ResolverCache::store(
+        QueryType type,
+        const lib::string_view& name,
+        uint16_t port,
+        IpVersion ipVersion,
+        const Error& ec,
+        std::vector<asio::IpEndpoint> endpoints,
+        uint32_t ttl,
+        TimePoint now
+    )
+{
+    std::chrono::seconds ttlSecs=m_config.negativeTtl;
+    if (!ec)
+    {
+        ttlSecs=(ttl==UnknownTtl)?m_config.defaultTtl:std::chrono::seconds(ttl);
+        ttlSecs=(std::max)(m_config.minTtl,(std::min)(ttlSecs,m_config.maxTtl));
+    }
+    if (ttlSecs.count()<=0)
+    {
+        return;
+    }
+
+    Entry entry;
+    entry.ec=ec;
+    entry.endpoints=std::move(endpoints);
+    entry.expireAt=now+ttlSecs;
+    entry.refreshAt=entry.expireAt;
+    if (m_config.refreshAhead!=0 && m_config.refreshAhead<100)
+    {
+        entry.refreshAt=now+ttlSecs*m_config.refreshAhead/100;
+    }
+
+    auto key=makeKey(type,name,port,ipVersion);
+
+    MutexScopedLock l{m_mutex};
+    auto it=m_entries.find(key);
+    if (it!=m_entries.end())
+    {
+        it->second=std::move(entry);
+        return;
+    }
+    if (m_entries.size()>=m_config.maxEntries)
+    {
+        evict(now);
+    }
+    m_entries.emplace(std::move(key),std::move(entry));
+}
+
+//---------------------------------------------------------------
+void ResolverCache::refreshFailed(
+        QueryType type,
+        const lib::string_view& name,
+        uint16_t port,
+        IpVersion ipVersion
+    )
+{
+    auto key=makeKey(type,name,port,ipVersion);
+
+    MutexScopedLock l{m_mutex};
+    auto it=m_entries.find(key);
+    if (it!=m_entries.end())
+    {
+        it->second.refreshing=false;
+    }
+}
+
+//---------------------------------------------------------------
+void ResolverCache::evict(TimePoint now)
+{
+    // drop expired entries
+    auto oldest=m_entries.end();
+    for (auto it=m_entries.begin();it!=m_entries.end();)
+    {
+        if (now>=it->second.expireAt)
+        {
+            it=m_entries.erase(it);
+            continue;
+        }
+        if (oldest==m_entries.end() || it->second.expireAt<oldest->second.expireAt)
+        {
+            oldest=it;
+        }
+        ++it;
+    }
+
+    // if still full then drop entry that expires first
+    if (m_entries.size()>=m_config.maxEntries && oldest!=m_entries.end())
+    {
+        m_entries.erase(oldest);
+    }
+}
+
+//---------------------------------------------------------------
+void ResolverCache::clear()
+{
+    MutexScopedLock l{m_mutex};
+    m_entries.clear();
+}
+
+//---------------------------------------------------------------
+size_t ResolverCache::size() const
+{
+    MutexScopedLock l{m_mutex};
+    return m_entries.size();
+}
+
+//---------------------------------------------------------------
+
+HATN_NETWORK_NAMESPACE_END
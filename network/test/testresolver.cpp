@@ -1,4 +1,8 @@
+#include <atomic>
+#include <thread>
+
 #include <boost/test/unit_test.hpp>
+#include <boost/asio/ip/udp.hpp>
 
 #include <hatn/common/locker.h>
 
@@ -10,6 +14,7 @@
 #include <hatn/network/asio/careslib.h>
 #include <hatn/network/asio/caresolver.h>
 #include <hatn/network/resolvershuffle.h>
+#include <hatn/network/resolvercache.h>
 
 #define HATN_TEST_LOG_CONSOLE
 
@@ -32,6 +37,113 @@ struct Env : public HATN_TEST_NAMESPACE::MultiThreadFixture
     Env& operator=(const Env&)=delete;
     Env& operator=(Env&&) noexcept=delete;
 };
+
+/**
+ * Minimal DNS server on localhost that answers A queries for name "cached.test" and replies NXDOMAIN for other names.
+ */
+class StubDnsServer
+{
+    public:
+
+        StubDnsServer()
+            : m_socket(m_asioContext,boost::asio::ip::udp::endpoint(boost::asio::ip::make_address("127.0.0.1"),0)),
+              m_stopped(false),
+              m_queryCount(0)
+        {
+            m_thread=std::thread([this](){run();});
+        }
+
+        ~StubDnsServer()
+        {
+            m_stopped.store(true);
+
+            // wake up receiving thread
+            boost::system::error_code ec;
+            boost::asio::ip::udp::socket wakeup(m_asioContext,boost::asio::ip::udp::v4());
+            char ch=0;
+            wakeup.send_to(boost::asio::buffer(&ch,1),m_socket.local_endpoint(),0,ec);
+            m_thread.join();
+        }
+
+        StubDnsServer(const StubDnsServer&)=delete;
+        StubDnsServer(StubDnsServer&&)=delete;
+        StubDnsServer& operator=(const StubDnsServer&)=delete;
+        StubDnsServer& operator=(StubDnsServer&&)=delete;
+
+        uint16_t port() const
+        {
+            return m_socket.local_endpoint().port();
+        }
+
+        size_t queryCount() const noexcept
+        {
+            return m_queryCount.load();
+        }
+
+    private:
+
+        void run()
+        {
+            std::array<uint8_t,512> buf;
+            while (!m_stopped.load())
+            {
+                boost::asio::ip::udp::endpoint from;
+                boost::system::error_code ec;
+                size_t size=m_socket.receive_from(boost::asio::buffer(buf),from,0,ec);
+                if (ec || m_stopped.load())
+                {
+                    break;
+                }
+                if (size<12)
+                {
+                    continue;
+                }
+                ++m_queryCount;
+
+                // parse question
+                size_t offset=12;
+                std::string name;
+                while (offset<size && buf[offset]!=0)
+                {
+                    size_t len=buf[offset++];
+                    if (!name.empty())
+                    {
+                        name.push_back('.');
+                    }
+                    name.append(reinterpret_cast<const char*>(buf.data()+offset),(std::min)(len,size-offset));
+                    offset+=len;
+                }
+                offset+=5;
+                if (offset>size)
+                {
+                    continue;
+                }
+                uint16_t qtype=static_cast<uint16_t>((buf[offset-4]<<8)|buf[offset-3]);
+
+                // make response
+                bool found=name=="cached.test";
+                bool answer=found && qtype==1;
+                std::vector<uint8_t> resp(buf.data(),buf.data()+offset);
+                resp[2]=0x81;
+                resp[3]=found?0x80:0x83;
+                resp[6]=0;
+                resp[7]=answer?1:0;
+                resp[8]=resp[9]=resp[10]=resp[11]=0;
+                if (answer)
+                {
+                    const uint8_t record[]={0xC0,0x0C, 0x00,0x01, 0x00,0x01, 0x00,0x00,0x01,0x2C, 0x00,0x04, 10,0,0,1};
+                    resp.insert(resp.end(),std::begin(record),std::end(record));
+                }
+                m_socket.send_to(boost::asio::buffer(resp),from,0,ec);
+            }
+        }
+
+        boost::asio::io_context m_asioContext;
+        boost::asio::ip::udp::socket m_socket;
+        std::thread m_thread;
+        std::atomic<bool> m_stopped;
+        std::atomic<size_t> m_queryCount;
+};
 }
 
 BOOST_AUTO_TEST_SUITE(Resolver)
@@ -341,5 +453,156 @@ BOOST_AUTO_TEST_CASE(Shuffle)
     BOOST_CHECK_EQUAL(eps4.size(),eps0.size()*3);
 }
 
+BOOST_AUTO_TEST_CASE(CacheTtl)
+{
+    using Cache=HATN_NETWORK_NAMESPACE::ResolverCache;
+    using HATN_NETWORK_NAMESPACE::IpVersion;
+
+    Cache::Config config;
+    config.minTtl=std::chrono::seconds(5);
+    config.maxTtl=std::chrono::seconds(100);
+    config.negativeTtl=std::chrono::seconds(20);
+    config.refreshAhead=80;
+    Cache cache{config};
+
+    auto t0=Cache::Clock::now();
+    std::vector<HATN_NETWORK_NAMESPACE::asio::IpEndpoint> eps0{
+        HATN_NETWORK_NAMESPACE::asio::IpEndpoint("10.0.0.1",80),
+        HATN_NETWORK_NAMESPACE::asio::IpEndpoint("10.0.0.2",80)
+    };
+
+    HATN_COMMON_NAMESPACE::Error ec;
+    std::vector<HATN_NETWORK_NAMESPACE::asio::IpEndpoint> eps;
+
+    // positive result
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"host.test",80,IpVersion::ALL,ec,eps,t0)==Cache::Status::Miss);
+    cache.store(Cache::QueryType::Name,"host.test",80,IpVersion::ALL,ec,eps0,10,t0);
+    BOOST_CHECK_EQUAL(cache.size(),1);
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"HOST.test",80,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(5))==Cache::Status::Hit);
+    BOOST_CHECK(!ec);
+    BOOST_CHECK_EQUAL(eps.size(),eps0.size());
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"host.test",81,IpVersion::ALL,ec,eps,t0)==Cache::Status::Miss);
+    BOOST_CHECK(cache.find(Cache::QueryType::Service,"host.test",80,IpVersion::ALL,ec,eps,t0)==Cache::Status::Miss);
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"host.test",80,IpVersion::V4,ec,eps,t0)==Cache::Status::Miss);
+
+    // refresh ahead of expiry is requested only once
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"host.test",80,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(9))==Cache::Status::HitRefresh);
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"host.test",80,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(9))==Cache::Status::Hit);
+    cache.refreshFailed(Cache::QueryType::Name,"host.test",80,IpVersion::ALL);
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"host.test",80,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(9))==Cache::Status::HitRefresh);
+
+    // expiry
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"host.test",80,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(10))==Cache::Status::Miss);
+    BOOST_CHECK_EQUAL(cache.size(),0);
+
+    // TTL is limited by min and max values
+    cache.store(Cache::QueryType::Name,"min.test",0,IpVersion::ALL,HATN_COMMON_NAMESPACE::Error{},eps0,0,t0);
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"min.test",0,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(3))==Cache::Status::Hit);
+    cache.store(Cache::QueryType::Name,"max.test",0,IpVersion::ALL,HATN_COMMON_NAMESPACE::Error{},eps0,100000,t0);
+    BOOST_CHECK(cache.find(Cache::QueryType::Name,"max.test",0,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(101))==Cache::Status::Miss);
+
+    // negative result
+    auto notFound=HATN_NETWORK_NAMESPACE::caresError(static_cast<int>(HATN_NETWORK_NAMESPACE::CaresError::ARES_ENOTFOUND));
+    cache.store(Cache::QueryType::Mx,"missing.test",0,IpVersion::ALL,notFound,{},Cache::UnknownTtl,t0);
+    eps.clear();
+    BOOST_CHECK(cache.find(Cache::QueryType::Mx,"missing.test",0,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(10))==Cache::Status::Hit);
+    BOOST_CHECK(ec.is(HATN_NETWORK_NAMESPACE::CaresError::ARES_ENOTFOUND));
+    BOOST_CHECK(eps.empty());
+    BOOST_CHECK(cache.find(Cache::QueryType::Mx,"missing.test",0,IpVersion::ALL,ec,eps,t0+std::chrono::seconds(20))==Cache::Status::Miss);
+
+    // eviction
+    Cache::Config smallConfig;
+    smallConfig.maxEntries=2;
+    Cache smallCache{smallConfig};
+    smallCache.store(Cache::QueryType::Name,"a.test",0,IpVersion::ALL,HATN_COMMON_NAMESPACE::Error{},eps0,10,t0);
+    smallCache.store(Cache::QueryType::Name,"b.test",0,IpVersion::ALL,HATN_COMMON_NAMESPACE::Error{},eps0,20,t0);
+    smallCache.store(Cache::QueryType::Name,"c.test",0,IpVersion::ALL,HATN_COMMON_NAMESPACE::Error{},eps0,30,t0);
+    BOOST_CHECK_EQUAL(smallCache.size(),2);
+    BOOST_CHECK(smallCache.find(Cache::QueryType::Name,"a.test",0,IpVersion::ALL,ec,eps,t0)==Cache::Status::Miss);
+    BOOST_CHECK(smallCache.find(Cache::QueryType::Name,"c.test",0,IpVersion::ALL,ec,eps,t0)==Cache::Status::Hit);
+}
+
+BOOST_FIXTURE_TEST_CASE(CacheStubServer,Env)
+{
+    StubDnsServer dnsServer;
+
+    std::shared_ptr<HATN_NETWORK_NAMESPACE::asio::CaResolver> resolver;
+    auto cache=std::make_shared<HATN_NETWORK_NAMESPACE::ResolverCache>();
+    auto context=HATN_LOGCONTEXT_NAMESPACE::makeLogCtx("resolver");
+
+    createThreads(1);
+    HATN_COMMON_NAMESPACE::Thread* thread0=thread(0).get();
+    HATN_REQUIRE_TS(thread0!=nullptr);
+
+    size_t foundCount=0;
+    size_t notFoundCount=0;
+    std::function<void ()> next;
+
+    auto foundCb=[&foundCount,&next](const HATN_COMMON_NAMESPACE::Error& ec,std::vector<HATN_NETWORK_NAMESPACE::asio::IpEndpoint> endpoints)
+    {
+        HATN_CHECK_TS(!ec);
+        HATN_CHECK_EQUAL_TS(endpoints.size(),1);
+        if (!endpoints.empty())
+        {
+            HATN_CHECK_TS(endpoints[0]==HATN_NETWORK_NAMESPACE::asio::IpEndpoint("10.0.0.1",80));
+        }
+        ++foundCount;
+        next();
+    };
+    auto notFoundCb=[&notFoundCount,&next](const HATN_COMMON_NAMESPACE::Error& ec,std::vector<HATN_NETWORK_NAMESPACE::asio::IpEndpoint>)
+    {
+        HATN_CHECK_TS(ec.is(HATN_NETWORK_NAMESPACE::CaresError::ARES_ENOTFOUND));
+        ++notFoundCount;
+        next();
+    };
+
+    next=[&]()
+    {
+        if (foundCount<2)
+        {
+            resolver->resolveName(context,foundCb,"cached.test",80,HATN_NETWORK_NAMESPACE::IpVersion::V4);
+        }
+        else if (notFoundCount<2)
+        {
+            resolver->resolveName(context,notFoundCb,"missing.test",80,HATN_NETWORK_NAMESPACE::IpVersion::V4);
+        }
+        else
+        {
+            quit();
+        }
+    };
+
+    thread0->start();
+    thread0->execAsync(
+        [&]()
+        {
+            std::vector<HATN_NETWORK_NAMESPACE::NameServer> nameServers={"127.0.0.1"};
+            nameServers[0].udpPort=dnsServer.port();
+            nameServers[0].tcpPort=dnsServer.port();
+            resolver=std::make_shared<HATN_NETWORK_NAMESPACE::asio::CaResolver>(nameServers);
+            resolver->setUseLocalHostsFile(false);
+            resolver->setCache(cache);
+            next();
+        }
+    );
+
+    exec(10);
+
+    HATN_CHECK_EXEC_SYNC(
+    thread0->execSync(
+                    [&resolver]()
+                    {
+                        resolver.reset();
+                    }));
+    thread0->stop();
+
+    BOOST_CHECK_EQUAL(foundCount,2);
+    BOOST_CHECK_EQUAL(notFoundCount,2);
+
+    // second queries were served from cache
+    BOOST_CHECK_EQUAL(dnsServer.queryCount(),2);
+    BOOST_CHECK_EQUAL(cache->size(),2);
+}
+
 #endif
 BOOST_AUTO_TEST_SUITE_END()
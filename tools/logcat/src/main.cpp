@@ -0,0 +1,238 @@
+/*
+    Copyright (c) 2020 - current, Evgeny Sidorov (decfile.com), All rights reserved.
+
+    Distributed under the Boost Software License, Version 1.0. (See accompanying
+    file LICENSE or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+*/
+
+/**
+ * hatn-logcat: CLI tool to render binary logs written by file logger
+ * with log_format "binary" to text.
+ *
+ * Text is the same as file logger writes with log_format "text".
+ *
+ * Usage:
+ *   hatn-logcat [--output <file>] [<file> ...]
+ *
+ * Options:
+ *   [--output]  Output file, if not set then text is written to stdout.
+ *   [<file>]    Binary log files, if not set or "-" then stdin is read.
+ */
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+
+#include <hatn/logcontext/binlogformatter.h>
+
+using namespace hatn::logcontext;
+
+namespace {
+
+constexpr const size_t ChunkSize=1024*1024;
+
+enum class HeaderStatus
+{
+    Complete,
+    Incomplete,
+    Invalid
+};
+
+//---------------------------------------------------------------
+
+HeaderStatus checkHeader(const char* data, size_t size)
+{
+    if (size<binlog::HeaderSize)
+    {
+        return HeaderStatus::Incomplete;
+    }
+
+    uint32_t recSize=0;
+    std::memcpy(&recSize,data,sizeof(recSize));
+    if (recSize<binlog::HeaderSize
+        || recSize>binlog::MaxRecordSize
+        || static_cast<uint8_t>(data[sizeof(recSize)])!=binlog::Magic
+        || static_cast<uint8_t>(data[sizeof(recSize)+1])!=binlog::Version
+        )
+    {
+        return HeaderStatus::Invalid;
+    }
+    if (recSize>size)
+    {
+        return HeaderStatus::Incomplete;
+    }
+    return HeaderStatus::Complete;
+}
+
+//---------------------------------------------------------------
+
+bool catStream(std::istream& in, const std::string& name, std::ostream& out)
+{
+    std::vector<char> chunk(ChunkSize);
+    std::string data;
+    size_t pos=0;
+    size_t offset=0;
+    size_t skipped=0;
+    bool eof=false;
+    hatn::common::FmtAllocatedBufferChar text;
+
+    while (!eof)
+    {
+        in.read(chunk.data(),static_cast<std::streamsize>(chunk.size()));
+        auto count=static_cast<size_t>(in.gcount());
+        eof=count==0 || !in;
+
+        offset+=pos;
+        data.erase(0,pos);
+        data.append(chunk.data(),count);
+        pos=0;
+
+        while (pos<data.size())
+        {
+            auto status=checkHeader(data.data()+pos,data.size()-pos);
+            if (status==HeaderStatus::Incomplete && !eof)
+            {
+                break;
+            }
+
+            size_t recSize=0;
+            if (status==HeaderStatus::Complete)
+            {
+                text.clear();
+                recSize=BinaryLogDecoder::toText(text,data.data()+pos,data.size()-pos);
+            }
+            if (recSize==0)
+            {
+                // skip invalid byte and try to find next record,
+                // record that is incomplete at the end of stream is either truncated or has corrupted size
+                if (skipped==0)
+                {
+                    if (status==HeaderStatus::Incomplete)
+                    {
+                        std::cerr << name << ": truncated record at offset " << offset+pos << "\n";
+                    }
+                    else
+                    {
+                        std::cerr << name << ": invalid record at offset " << offset+pos << "\n";
+                    }
+                }
+                ++skipped;
+                ++pos;
+                continue;
+            }
+
+            if (skipped!=0)
+            {
+                std::cerr << name << ": skipped " << skipped << " bytes\n";
+                skipped=0;
+            }
+            out.write(text.data(),static_cast<std::streamsize>(text.size()));
+            out << '\n';
+            pos+=recSize;
+        }
+    }
+
+    bool ok=true;
+    if (skipped!=0)
+    {
+        std::cerr << name << ": skipped " << skipped << " bytes\n";
+        ok=false;
+    }
+    if (in.bad())
+    {
+        std::cerr << name << ": failed to read (" << std::strerror(errno) << ")\n";
+        ok=false;
+    }
+    return ok;
+}
+
+//---------------------------------------------------------------
+
+void usage(const char* argv0)
+{
+    std::cerr
+        << "Usage: " << argv0 << " [--output <file>] [<file> ...]\n"
+        << "  [--output <file>]   Output file (default: stdout)\n"
+        << "  [<file> ...]        Binary log files (default or \"-\": stdin)\n";
+}
+
+}
+
+//---------------------------------------------------------------
+
+int main(int argc, char* argv[])
+{
+    std::string outputFile;
+    std::vector<std::string> inputFiles;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg{argv[i]};
+            auto next = [&]() -> std::string {
+                if (i + 1 >= argc)
+                {
+                    throw std::runtime_error{"option " + arg + " requires an argument"};
+                }
+                return argv[++i];
+            };
+
+            if      (arg == "--output")                outputFile = next();
+            else if (arg == "--help" || arg == "-h")   { usage(argv[0]); return 0; }
+            else if (arg.size() > 1 && arg[0] == '-')  { std::cerr << "Unknown option: " << arg << "\n"; usage(argv[0]); return 1; }
+            else                                       inputFiles.push_back(arg);
+        }
+        if (inputFiles.empty())
+        {
+            inputFiles.emplace_back("-");
+        }
+
+        std::ofstream outFile;
+        if (!outputFile.empty())
+        {
+            outFile.open(outputFile, std::ios::binary | std::ios::trunc);
+            if (!outFile)
+            {
+                throw std::runtime_error{"cannot open output file: " + outputFile + " (" + std::strerror(errno) + ")"};
+            }
+        }
+        std::ostream& out = outputFile.empty() ? std::cout : outFile;
+
+        bool ok=true;
+        for (auto&& inputFile : inputFiles)
+        {
+            if (inputFile == "-")
+            {
+                ok=catStream(std::cin, "stdin", out) && ok;
+                continue;
+            }
+
+            std::ifstream in{inputFile, std::ios::binary};
+            if (!in)
+            {
+                std::cerr << "cannot open input file: " << inputFile << " (" << std::strerror(errno) << ")\n";
+                ok=false;
+                continue;
+            }
+            ok=catStream(in, inputFile, out) && ok;
+        }
+
+        out.flush();
+        if (!out)
+        {
+            throw std::runtime_error{"failed to write output"};
+        }
+        return ok ? 0 : 1;
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << "Error: " << ex.what() << "\n";
+        return 1;
+    }
+}